@@ -13,6 +13,7 @@
 #include "src/vec_util.hh"
 #include "src/measure.hh"
 
+#include <algorithm>
 #include <experimental/filesystem>
 #include <iostream>
 #include <nlohmann/json.hpp>
@@ -20,10 +21,10 @@
 #include <vector>
 namespace fs = std::experimental::filesystem;
 
-void search(std::string query, size_t topK, IR_MODE mode) {
+void search(std::string query, size_t topK, IR_MODE mode, size_t searchWidth) {
     QueryExecutionEngine& qee = QueryExecutionEngine::getInstance();
 
-    std::vector<std::pair<size_t, float>> result = qee.search(query, topK, mode);
+    std::vector<std::pair<size_t, float>> result = qee.search(query, topK, mode, searchWidth);
    
     using json = nlohmann::json;
     json json_result = json::array();
@@ -61,8 +62,23 @@ void serverMode(const control_block_t& aControlBlock) {
         json j;
         try {
             std::cin >> j;
-            search(j["query"].get<std::string>(), j["topK"].get<size_t>(), stringToMode(j["mode"].get<std::string>()));
-        }catch (std::exception& e) {
+            if (j.count("add")) { // {"add": {"id": "...", "content": "preprocessed terms"}}
+                string_vt content;
+                Util::splitStringBoost(j["add"]["content"].get<std::string>(), ' ', content);
+                imInstance.addDocument(j["add"]["id"].get<std::string>(), content);
+                std::cout << "[Added]" << std::endl;
+            } else if (j.count("delete")) { // {"delete": "id"}
+                imInstance.deleteDocument(j["delete"].get<std::string>());
+                std::cout << "[Deleted]" << std::endl;
+            } else if (j.count("merge")) { // {"merge": true}
+                imInstance.mergeSegment();
+                std::cout << "[Merged]" << std::endl;
+            } else {
+                search(j["query"].get<std::string>(), j["topK"].get<size_t>(), stringToMode(j["mode"].get<std::string>()), j.value("efSearch", j.value("nprobe", j.value("probes", size_t(0)))));
+            }
+        } catch (InvalidArgumentException& e) {
+            std::cout << e.what() << std::endl;
+        } catch (std::exception& e) {
             std::cout << "Malformated JSON" << std::endl;
         }
         
@@ -105,7 +121,20 @@ void evalMode(const control_block_t& aControlBlock) {
 
     str_set queryNamesSet;
 
-    const std::vector<IR_MODE> modes{kVANILLA, kVANILLA_RAND, kVANILLA_W2V, kCLUSTER, kCLUSTER_RAND, kCLUSTER_W2V, kTIERED, kTIERED_RAND, kTIERED_W2V};
+    std::vector<IR_MODE> modes{kVANILLA, kVANILLA_RAND, kVANILLA_W2V, kCLUSTER, kCLUSTER_RAND, kCLUSTER_W2V, kTIERED, kTIERED_RAND, kTIERED_W2V, kVANILLA_TAAT, kVANILLA_WAND, kVANILLA_BMW, kVANILLA_MAXSCORE};
+    // the approximate modes only find documents if their index was built
+    if(aControlBlock.hnswM() != 0)
+    {
+        modes.push_back(kHNSW_W2V);
+    }
+    if(aControlBlock.ivfLists() != 0)
+    {
+        modes.push_back(kIVFPQ_W2V);
+    }
+    if(aControlBlock.lshTables() != 0)
+    {
+        modes.push_back(kLSH_RAND);
+    }
     const std::vector<QUERY_TYPE> types{kNTT};
 
     for(auto type : types){
@@ -205,12 +234,50 @@ int main(const int argc, const char* argv[]) {
         return -1;
     }
  
+    if(stringToCodec(lArgs.postingCodec()) == kNoCodec)
+    {
+        std::cerr << "The posting codec must be one of kUNCOMPRESSED, kVARBYTE or kBITPACK." << std::endl;
+        return -1;
+    }
+
+    if(stringToPrecision(lArgs.embeddingPrecision()) == kNoPrecision)
+    {
+        std::cerr << "The embedding precision must be one of kFP32, kFP16 or kINT8." << std::endl;
+        return -1;
+    }
+
+    if(lArgs.hnswM() == 1)
+    {
+        std::cerr << "The HNSW M must be 0 (no graph) or at least two." << std::endl;
+        return -1;
+    }
+
+    if(lArgs.ivfSubspaces() == 0 || IndexManager::kWordEmbeddingsDimensions % lArgs.ivfSubspaces() != 0)
+    {
+        std::cerr << "The number of IVF-PQ subspaces must divide " << IndexManager::kWordEmbeddingsDimensions << "." << std::endl;
+        return -1;
+    }
+
+    if(lArgs.lshTables() != 0 && (lArgs.lshBandBits() == 0 || lArgs.lshBandBits() > 64 || lArgs.lshTables() * lArgs.lshBandBits() > lArgs.dimensions()))
+    {
+        std::cerr << "The LSH bands must have 1 to 64 bits and fit into the " << lArgs.dimensions() << " random projection dimensions." << std::endl;
+        return -1;
+    }
+
+    if(lArgs.lshProbes() == 0)
+    {
+        std::cerr << "The number of LSH probes must be at least one." << std::endl;
+        return -1;
+    }
+
     if(lArgs.tiers() < 2)
     {
         std::cerr << "The number of tiers must be larger than two." << std::endl;
         return -1;
     }
 
+    const uint lThreads = (lArgs.threads() > 0) ? lArgs.threads() : std::max(1u, std::thread::hardware_concurrency());
+
     const control_block_t lCB = {
         lArgs.trace(),               // trace activated?
         lArgs.measure(),             // measure runtime/IR performance?
@@ -225,7 +292,24 @@ int main(const int argc, const char* argv[]) {
         lArgs.results(),             // topK argument
         lArgs.tiers(),               // number of tiers
         lArgs.dimensions(),          // number of dimensions
-        lArgs.seed()                 // seed for random projections and cluster leader election
+        lArgs.seed(),                // seed for random projections and cluster leader election
+        lThreads,                    // number of threads for the parsing and the index construction
+        stringToCodec(lArgs.postingCodec()), // codec for the posting lists
+        lArgs.indexPath(),           // path of the index snapshot
+        lArgs.spimiBudget(),         // memory budget of the external index build
+        lArgs.spimiPath(),           // directory of the external index build runs
+        lArgs.filterWordEmbeddings(), // keep only the word embeddings of the collection terms
+        lArgs.wordEmbeddingsFallback(), // keep the full word embeddings for the other query terms
+        stringToPrecision(lArgs.embeddingPrecision()), // precision of the stored embeddings
+        lArgs.hnswM(),               // neighbours per layer of the HNSW graph
+        lArgs.hnswEfConstruction(),  // candidate list size of the HNSW build
+        lArgs.hnswEfSearch(),        // default candidate list size of a HNSW search
+        lArgs.ivfLists(),            // lists of the IVF-PQ index
+        lArgs.ivfSubspaces(),        // bytes per document of the IVF-PQ index
+        lArgs.ivfNprobe(),           // default number of probed IVF-PQ lists
+        lArgs.lshTables(),           // hash tables of the LSH index
+        lArgs.lshBandBits(),         // signature bits of a LSH band
+        lArgs.lshProbes()            // default number of probed buckets per LSH table
     };
 
     // Init tracing
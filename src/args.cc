@@ -26,6 +26,23 @@ void construct_arg_desc(argdesc_vt& x) {
     x.push_back(new uarg_t("--tiers", 50, &Args::tiers, "the number of tiers used for the tiered index"));
     x.push_back(new uarg_t("--dimensions", 1000, &Args::dimensions, "the number of dimensions used for the random projection"));
     x.push_back(new uarg_t("--seed", 1, &Args::seed, "seed for random projection and selecting the cluster leaders"));
+    x.push_back(new uarg_t("--threads", 0, &Args::threads, "the number of threads used to parse the files and build the indices, 0 uses all hardware threads"));
+    x.push_back(new sarg_t("--index-path", "", &Args::indexPath, "path to the index snapshot. loaded if it was built with the same parameters from the same collection, stopword and word embeddings files, otherwise the index is built and written there"));
+    x.push_back(new uarg_t("--spimi-budget", 0, &Args::spimiBudget, "memory budget in MB for the postings of the external (SPIMI) index build, 0 builds the posting lists in memory"));
+    x.push_back(new sarg_t("--spimi-path", "", &Args::spimiPath, "directory for the temporary runs of the external index build, the system temporary directory if empty"));
+    x.push_back(new barg_t("--filter-word-embeddings", false, &Args::filterWordEmbeddings, "sets the flag to keep only the word embeddings of the collection terms, a stemmed term gets the embedding of its most frequent surface form"));
+    x.push_back(new barg_t("--word-embeddings-fallback", false, &Args::wordEmbeddingsFallback, "sets the flag to keep the full word embeddings mapped for query terms outside of the collection if they are filtered"));
+    x.push_back(new sarg_t("--embedding-precision", "kFP32", &Args::embeddingPrecision, "the precision of the stored word and document embeddings: kFP32, kFP16 or kINT8 (with one scale per vector)"));
+    x.push_back(new uarg_t("--hnsw-m", 0, &Args::hnswM, "the number of neighbours of a document per layer of the HNSW graph (twice as many on layer 0), 0 does not build the graph, e.g. 16 enables kHNSW_W2V"));
+    x.push_back(new uarg_t("--hnsw-ef-construction", 200, &Args::hnswEfConstruction, "the size of the candidate list while building the HNSW graph"));
+    x.push_back(new uarg_t("--hnsw-ef-search", 64, &Args::hnswEfSearch, "the default size of the candidate list of a kHNSW_W2V search, a query can set its own with 'efSearch'"));
+    x.push_back(new uarg_t("--ivf-lists", 0, &Args::ivfLists, "the number of lists (coarse k-means centroids) of the IVF-PQ index, 0 does not build the index, e.g. 64 enables kIVFPQ_W2V"));
+    x.push_back(new uarg_t("--ivf-subspaces", 30, &Args::ivfSubspaces, "the number of product quantization subspaces (bytes per document) of the IVF-PQ index, must divide the 300 embedding dimensions"));
+    x.push_back(new uarg_t("--ivf-nprobe", 8, &Args::ivfNprobe, "the default number of lists a kIVFPQ_W2V search probes, a query can set its own with 'nprobe'"));
+    x.push_back(new uarg_t("--lsh-tables", 8, &Args::lshTables, "the number of hash tables (signature bands) of the LSH index, 0 does not build the index"));
+    x.push_back(new uarg_t("--lsh-band-bits", 8, &Args::lshBandBits, "the number of random projection bits of a band (the key of a LSH table), at most 64"));
+    x.push_back(new uarg_t("--lsh-probes", 1, &Args::lshProbes, "the default number of buckets a kLSH_RAND search probes per table, a query can set its own with 'probes'"));
+    x.push_back(new sarg_t("--posting-codec", "kUNCOMPRESSED", &Args::postingCodec, "the codec for the posting lists: kUNCOMPRESSED, kVARBYTE or kBITPACK"));
 }
 
 Args::Args() : 
@@ -43,5 +60,22 @@ Args::Args() :
     _results(20),
     _tiers(100),
     _dimensions(5000),
-    _seed(1)
+    _seed(1),
+    _threads(0),
+    _postingCodec("kUNCOMPRESSED"),
+    _indexPath(""),
+    _spimiBudget(0),
+    _spimiPath(""),
+    _filterWordEmbeddings(false),
+    _wordEmbeddingsFallback(false),
+    _embeddingPrecision("kFP32"),
+    _hnswM(0),
+    _hnswEfConstruction(200),
+    _hnswEfSearch(64),
+    _ivfLists(0),
+    _ivfSubspaces(30),
+    _ivfNprobe(8),
+    _lshTables(8),
+    _lshBandBits(8),
+    _lshProbes(1)
 {}
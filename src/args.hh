@@ -89,6 +89,57 @@ class Args {
     inline uint seed() { return _seed; }
     inline void seed(const uint& x) { _seed = x; }
 
+    inline uint threads() { return _threads; }
+    inline void threads(const uint& x) { _threads = x; }
+
+    inline const std::string& postingCodec() { return _postingCodec; }
+    inline void postingCodec(const std::string& x) { _postingCodec = x; }
+
+    inline const std::string& indexPath() { return _indexPath; }
+    inline void indexPath(const std::string& x) { _indexPath = x; }
+
+    inline uint spimiBudget() { return _spimiBudget; }
+    inline void spimiBudget(const uint& x) { _spimiBudget = x; }
+
+    inline const std::string& spimiPath() { return _spimiPath; }
+    inline void spimiPath(const std::string& x) { _spimiPath = x; }
+
+    inline bool filterWordEmbeddings() { return _filterWordEmbeddings; }
+    inline void filterWordEmbeddings(const bool& x) { _filterWordEmbeddings = x; }
+
+    inline bool wordEmbeddingsFallback() { return _wordEmbeddingsFallback; }
+    inline void wordEmbeddingsFallback(const bool& x) { _wordEmbeddingsFallback = x; }
+
+    inline const std::string& embeddingPrecision() { return _embeddingPrecision; }
+    inline void embeddingPrecision(const std::string& x) { _embeddingPrecision = x; }
+
+    inline uint hnswM() { return _hnswM; }
+    inline void hnswM(const uint& x) { _hnswM = x; }
+
+    inline uint hnswEfConstruction() { return _hnswEfConstruction; }
+    inline void hnswEfConstruction(const uint& x) { _hnswEfConstruction = x; }
+
+    inline uint hnswEfSearch() { return _hnswEfSearch; }
+    inline void hnswEfSearch(const uint& x) { _hnswEfSearch = x; }
+
+    inline uint ivfLists() { return _ivfLists; }
+    inline void ivfLists(const uint& x) { _ivfLists = x; }
+
+    inline uint ivfSubspaces() { return _ivfSubspaces; }
+    inline void ivfSubspaces(const uint& x) { _ivfSubspaces = x; }
+
+    inline uint ivfNprobe() { return _ivfNprobe; }
+    inline void ivfNprobe(const uint& x) { _ivfNprobe = x; }
+
+    inline uint lshTables() { return _lshTables; }
+    inline void lshTables(const uint& x) { _lshTables = x; }
+
+    inline uint lshBandBits() { return _lshBandBits; }
+    inline void lshBandBits(const uint& x) { _lshBandBits = x; }
+
+    inline uint lshProbes() { return _lshProbes; }
+    inline void lshProbes(const uint& x) { _lshProbes = x; }
+
   private:
     bool _help;
     bool _trace;
@@ -107,6 +158,24 @@ class Args {
     uint _tiers;
     uint _dimensions;
     uint _seed;
+    uint _threads;
+
+    std::string _postingCodec;
+    std::string _indexPath;
+    uint _spimiBudget;
+    std::string _spimiPath;
+    bool _filterWordEmbeddings;
+    bool _wordEmbeddingsFallback;
+    std::string _embeddingPrecision;
+    uint _hnswM;
+    uint _hnswEfConstruction;
+    uint _hnswEfSearch;
+    uint _ivfLists;
+    uint _ivfSubspaces;
+    uint _ivfNprobe;
+    uint _lshTables;
+    uint _lshBandBits;
+    uint _lshProbes;
 };
 using argdesc_vt = std::vector<argdescbase_t<Args>*>;
 void construct_arg_desc(argdesc_vt& aArgDesc);
@@ -50,6 +50,25 @@ void Cluster::chooseLeaders()
     TRACE("Cluster: Leaders chosen.");
 }
 
+void Cluster::save(std::ostream& aOut) const
+{
+    Util::writeVector(aOut, _leaders);
+    for (const size_t leaderID : _leaders)                    // every cluster belongs to exactly one leader
+    {
+        Util::writeVector(aOut, _cluster.at(leaderID));
+    }
+}
+
+void Cluster::load(Util::BinaryReader& aReader)
+{
+    aReader.readVector(_leaders);
+    _cluster.clear();
+    for (const size_t leaderID : _leaders)
+    {
+        aReader.readVector(_cluster[leaderID]);
+    }
+}
+
 void Cluster::getIDs(const std::vector<std::pair<size_t, float>>& aLeaders, const size_t aTopK, sizet_vt& aOutputVec)
 {
     for(const auto& leader : aLeaders)
@@ -14,6 +14,7 @@
 #include "trace.hh"
 
 #include "document_manager.hh"
+#include "serialization_util.hh"
 
 #include <algorithm>
 #include <cmath>
@@ -60,6 +61,20 @@ class Cluster
      */
     void chooseLeaders();
 
+    /**
+     * @brief Write the leaders and the clusters to a snapshot
+     *
+     * @param aOut the output stream
+     */
+    void save(std::ostream& aOut) const;
+
+    /**
+     * @brief Restore the leaders and the clusters written by @see save
+     *
+     * @param aReader the snapshot reader
+     */
+    void load(Util::BinaryReader& aReader);
+
   public:
     /**
      * @brief Get the document IDs of the leader
@@ -0,0 +1,35 @@
+#include "compression_util.hh"
+
+namespace Util {
+
+    uint8_t bitWidth(const uint32_t* aValues, const size_t aSize) {
+        uint32_t acc = 0;
+        for (size_t i = 0; i < aSize; ++i) {
+            acc |= aValues[i];
+        }
+        uint8_t bits = 0;
+        while (acc) {
+            ++bits;
+            acc >>= 1;
+        }
+        return bits;
+    }
+
+    void bitPack(const uint32_t* aValues, const size_t aSize, const uint8_t aBitWidth, byte_vt& aOut) {
+        const size_t start = aOut.size();
+        aOut.resize(start + (aSize * aBitWidth + 7) / 8, 0);
+        for (size_t i = 0; i < aSize; ++i) {
+            uint64_t value = aValues[i];
+            size_t bitPos = i * aBitWidth;
+            for (uint8_t written = 0; written < aBitWidth;) {
+                const size_t bytePos = start + (bitPos >> 3);
+                const uint8_t offset = bitPos & 7;
+                const uint8_t chunk = std::min<uint8_t>(8 - offset, aBitWidth - written);
+                aOut[bytePos] |= static_cast<uint8_t>((value & ((1u << chunk) - 1)) << offset);
+                value >>= chunk;
+                written += chunk;
+                bitPos += chunk;
+            }
+        }
+    }
+}
@@ -0,0 +1,153 @@
+/*
+ * @file    compression_util.hh
+ * @brief   Codecs for the compressed posting lists. Doc ids are delta-gap encoded in blocks of
+ *          kBlockSize postings, either with variable byte encoding or with a fixed bit width per block
+ *          (binary packing, BP128 style). Term frequencies are quantized to one byte.
+ * 
+ * @section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+#include "exception.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using byte_vt = std::vector<uint8_t>;
+using uint32_vt = std::vector<uint32_t>;
+
+namespace Util {
+
+    constexpr size_t kBlockSize = 128;   // number of postings per compressed block
+    constexpr size_t kBitPackPadding = 8; // trailing bytes so that the bit unpacker may always read 8 bytes
+
+    /**
+     * @brief Number of bits needed to represent the largest value in aValues
+     *
+     * @param aValues the values
+     * @param aSize the number of values
+     * @return uint8_t the bit width (0 if all values are 0)
+     */
+    uint8_t bitWidth(const uint32_t* aValues, const size_t aSize);
+
+    /**
+     * @brief Appends aSize values with aBitWidth bits each to aOut (little endian bit order)
+     *
+     * @param aValues the values, each < 2^aBitWidth
+     * @param aSize the number of values
+     * @param aBitWidth the bit width
+     * @param aOut the output bytes
+     */
+    void bitPack(const uint32_t* aValues, const size_t aSize, const uint8_t aBitWidth, byte_vt& aOut);
+
+    /**
+     * @brief Unpacks a full block of kBlockSize values with aBitWidth bits each. The bit width is a template
+     *        parameter, so the compiler unrolls the loop into loads and shifts by constant offsets
+     *
+     * @param aIn the packed bytes, followed by at least kBitPackPadding readable bytes
+     * @param aOut the output values (at least kBlockSize)
+     */
+    template <uint8_t aBitWidth>
+    inline void bitUnpackBlock(const uint8_t* aIn, uint32_t* aOut) {
+        constexpr uint64_t mask = (aBitWidth == 32) ? 0xFFFFFFFFull : ((1ull << aBitWidth) - 1);
+        for (size_t i = 0; i < kBlockSize; ++i) {
+            const size_t bitPos = i * aBitWidth;
+            uint64_t window;
+            std::memcpy(&window, aIn + (bitPos >> 3), sizeof(window));
+            aOut[i] = static_cast<uint32_t>((window >> (bitPos & 7)) & mask);
+        }
+    }
+
+    using block_unpacker_t = void (*)(const uint8_t*, uint32_t*);
+
+    template <size_t... aBitWidths>
+    constexpr std::array<block_unpacker_t, sizeof...(aBitWidths)> makeBlockUnpackers(std::index_sequence<aBitWidths...>) {
+        return { &bitUnpackBlock<static_cast<uint8_t>(aBitWidths)>... };
+    }
+
+    constexpr std::array<block_unpacker_t, 33> kBlockUnpackers = makeBlockUnpackers(std::make_index_sequence<33>()); // by bit width
+
+    /**
+     * @brief Unpacks aSize values with aBitWidth bits each, written by @see bitPack. A scalar unpacker, each value is
+     *        an unaligned 64 bit load and a shift. A full block is unpacked by @see bitUnpackBlock for its bit width,
+     *        the last block of a list with a runtime trip count and shift
+     *
+     * @param aIn the packed bytes, followed by at least kBitPackPadding readable bytes
+     * @param aSize the number of values
+     * @param aBitWidth the bit width
+     * @param aOut the output values (at least aSize)
+     */
+    inline void bitUnpack(const uint8_t* aIn, const size_t aSize, const uint8_t aBitWidth, uint32_t* aOut) {
+        if (aSize == kBlockSize) {
+            kBlockUnpackers[aBitWidth](aIn, aOut);
+            return;
+        }
+        const uint64_t mask = (aBitWidth == 32) ? 0xFFFFFFFFull : ((1ull << aBitWidth) - 1);
+        for (size_t i = 0; i < aSize; ++i) {
+            const size_t bitPos = i * aBitWidth;
+            uint64_t window;
+            std::memcpy(&window, aIn + (bitPos >> 3), sizeof(window));
+            aOut[i] = static_cast<uint32_t>((window >> (bitPos & 7)) & mask);
+        }
+    }
+
+    /**
+     * @brief Appends aValue with variable byte encoding (7 bits per byte, high bit marks the last byte)
+     *
+     * @param aValue the value
+     * @param aOut the output bytes
+     */
+    inline void varByteEncode(uint32_t aValue, byte_vt& aOut) {
+        while (aValue >= 128) {
+            aOut.push_back(static_cast<uint8_t>(aValue & 127));
+            aValue >>= 7;
+        }
+        aOut.push_back(static_cast<uint8_t>(aValue | 128));
+    }
+
+    /**
+     * @brief Decodes aSize variable byte encoded values
+     *
+     * @param aIn the encoded bytes
+     * @param aSize the number of values
+     * @param aOut the output values (at least aSize)
+     * @return const uint8_t* the position after the last decoded byte
+     */
+    inline const uint8_t* varByteDecode(const uint8_t* aIn, const size_t aSize, uint32_t* aOut) {
+        for (size_t i = 0; i < aSize; ++i) {
+            uint32_t value = 0;
+            uint32_t shift = 0;
+            uint8_t b;
+            while (!((b = *aIn++) & 128)) {
+                value |= static_cast<uint32_t>(b) << shift;
+                shift += 7;
+            }
+            aOut[i] = value | (static_cast<uint32_t>(b & 127) << shift);
+        }
+        return aIn;
+    }
+
+    /**
+     * @brief Quantize a term frequency in [0, 1] to one byte
+     *
+     * @param aTf the term frequency
+     * @return uint8_t the quantized term frequency
+     */
+    inline uint8_t quantizeTf(const float aTf) {
+        return static_cast<uint8_t>(std::lround(std::clamp(aTf, 0.0f, 1.0f) * 255.0f));
+    }
+
+    /**
+     * @brief Reconstruct a term frequency quantized by @see quantizeTf
+     *
+     * @param aQTf the quantized term frequency
+     * @return float the term frequency
+     */
+    inline float dequantizeTf(const uint8_t aQTf) { return aQTf / 255.0f; }
+}
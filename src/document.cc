@@ -1,4 +1,5 @@
 #include "document.hh"
+#include "term_dictionary.hh"
 
 size_t Document::_documentCount = 0;
 
@@ -12,7 +13,23 @@ Document::Document(const std::string& aDocID, const string_vt& aContent) :
     _ID(Document::_documentCount++),
     _docID(aDocID),
     _content(aContent),
-    _term_tf_map(),
+    _term_tf_vec(),
+    _tf_idf_vec(),
+    _rand_proj_vec(),
+    _norm_length(0)
+{}
+
+/**
+ * @brief Construct a new Document:: Document object which takes over the content
+ *
+ * @param aDocID the document ID of the document
+ * @param aContent the content (vector of terms) of the document
+ */
+Document::Document(const std::string& aDocID, string_vt&& aContent) :
+    _ID(Document::_documentCount++),
+    _docID(aDocID),
+    _content(std::move(aContent)),
+    _term_tf_vec(),
     _tf_idf_vec(),
     _rand_proj_vec(),
     _norm_length(0)
@@ -27,20 +44,25 @@ Document::Document(const Document& doc) :
     _ID(doc.getID()),
     _docID(doc.getDocID()),
     _content(doc.getContent()),
-    _term_tf_map(doc.getTermTfMap()),
+    _term_tf_vec(doc.getTermTfVector()),
     _tf_idf_vec(doc.getTfIdfVector()),
     _wordembeddings_vec(doc.getWordEmbeddingsVector()),
     _rand_proj_vec(doc.getRandProjVec()),
     _norm_length(doc.getNormLength())
 {}
 
-float Document::getTf(const std::string& aTerm) const {
-    if (_term_tf_map.find(aTerm) != _term_tf_map.end())
-        return _term_tf_map.at(aTerm);
+float Document::getTf(const term_id_t aTermID) const {
+    auto it = std::lower_bound(_term_tf_vec.begin(), _term_tf_vec.end(), aTermID, [](const sparse_elem_t& elem, const term_id_t id) { return elem.first < id; });
+    if (it != _term_tf_vec.end() && it->first == aTermID)
+        return it->second;
     else
         return 0;
 }
 
+float Document::getTf(const std::string& aTerm) const {
+    return getTf(TermDictionary::getInstance().getID(aTerm));
+}
+
 float Document::getTf(const std::string& aTerm){
     return static_cast<const Document&>(*this).getTf(aTerm);
 }
@@ -48,9 +70,9 @@ float Document::getTf(const std::string& aTerm){
 std::ostream& operator<<(std::ostream& strm, const Document& doc) {
     strm << "Document: " << doc.getID() << ": ";
     std::string sep = ") ";
-    for (auto it = doc.getTermTfMap().begin(); it != doc.getTermTfMap().end(); ++it) {
-        if (it == std::prev(doc.getTermTfMap().end(), 1)) { sep = ")"; }
-        strm << "(" << it->first << ", " << it->second << sep;
+    for (auto it = doc.getTermTfVector().begin(); it != doc.getTermTfVector().end(); ++it) {
+        if (it == std::prev(doc.getTermTfVector().end(), 1)) { sep = ")"; }
+        strm << "(" << TermDictionary::getInstance().getTerm(it->first) << ", " << it->second << sep;
     }
     return strm;
 }
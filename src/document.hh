@@ -11,6 +11,7 @@
 #include "exception.hh"
 #include "types.hh"
 
+#include <algorithm>
 #include <boost/dynamic_bitset.hpp>
 #include <map>
 #include <string>
@@ -20,6 +21,7 @@
 class Document {
   public:
     explicit Document(const std::string& aDocID, const string_vt& aContent);
+    explicit Document(const std::string& aDocID, string_vt&& aContent);
     explicit Document(const Document&);
     explicit Document() = delete;
     Document(Document&&) = default;
@@ -57,19 +59,19 @@ class Document {
     inline const string_vt& getContent() const { return _content; }
     inline const string_vt& getContent() { return static_cast<const Document&>(*this).getContent(); }
     /**
-     * @brief Get the term to term frequency map of the document
+     * @brief Get the (termID, term frequency) vector of the document
      *
-     * @return const str_float_mt& the term tf map
+     * @return const sparse_vt& the term tf vector, sorted by termID
      */
-    inline const str_float_mt& getTermTfMap() const { return _term_tf_map; }
-    inline str_float_mt& getTermTfMap() { return const_cast<str_float_mt&>(static_cast<const Document&>(*this).getTermTfMap()); }
+    inline const sparse_vt& getTermTfVector() const { return _term_tf_vec; }
+    inline sparse_vt& getTermTfVector() { return const_cast<sparse_vt&>(static_cast<const Document&>(*this).getTermTfVector()); }
     /**
-     * @brief Get the tf idf vector of the document
+     * @brief Get the sparse tf idf vector of the document
      *
-     * @return const float_vt& the tf idf vector
+     * @return const sparse_vt& the (termID, tf-idf) pairs, sorted by termID
      */
-    inline const float_vt& getTfIdfVector() const { return _tf_idf_vec; }
-    inline float_vt& getTfIdfVector() { return const_cast<float_vt&>(static_cast<const Document&>(*this).getTfIdfVector()); }
+    inline const sparse_vt& getTfIdfVector() const { return _tf_idf_vec; }
+    inline sparse_vt& getTfIdfVector() { return const_cast<sparse_vt&>(static_cast<const Document&>(*this).getTfIdfVector()); }
     /**
      * @brief Get the tf idf vector of the document
      *
@@ -93,7 +95,14 @@ class Document {
     inline float getNormLength() { return static_cast<const Document&>(*this).getNormLength(); }
 
     /**
-     * @brief Get the tf of aTerm in this document
+     * @brief Get the tf of the term with id aTermID in this document
+     *
+     * @param aTermID the id of the term for which the tf is returned
+     * @return float the term frequency of the term
+     */
+    float getTf(const term_id_t aTermID) const;
+    /**
+     * @brief Get the tf of aTerm in this document, resolves the term with the TermDictionary
      *
      * @param aTerm the term for which the tf is returned
      * @return float the term frequency of aTerm
@@ -102,11 +111,11 @@ class Document {
     float getTf(const std::string& aTerm);
 
     /**
-     * @brief Set the term tf map
+     * @brief Set the term tf vector
      *
-     * @param termTFMap the map to set
+     * @param termTfVec the (termID, tf) vector to set, sorted by termID
      */
-    inline void setTermTfMap(const str_float_mt& termTFMap) { _term_tf_map = termTFMap; }
+    inline void setTermTfVector(const sparse_vt& termTfVec) { _term_tf_vec = termTfVec; }
     /**
      * @brief Set the normalization factor of this document
      *
@@ -114,11 +123,11 @@ class Document {
      */
     inline void setNormLength(float nl) { _norm_length = nl; }
     /**
-     * @brief Set the tfidf vector of this document
+     * @brief Set the sparse tfidf vector of this document
      *
-     * @param vec the tfidf vector
+     * @param vec the tfidf vector, sorted by termID
      */
-    inline void setTfIdfVector(const float_vt& vec) { _tf_idf_vec = vec; }
+    inline void setTfIdfVector(const sparse_vt& vec) { _tf_idf_vec = vec; }
     /**
      * @brief Set the tfidf vector of this document
      *
@@ -147,8 +156,8 @@ class Document {
     const size_t _ID;                                // e.g. 5
     const std::string _docID;                        // e.g. MED-123
     string_vt _content;                        // e.g. [studi, run, fish, ...]
-    str_float_mt _term_tf_map;                 // stores TF values
-    float_vt _tf_idf_vec;                      // e.g. <0, 2, 1.5, 3, .84, ..>
+    sparse_vt _term_tf_vec;                    // stores TF values: <(termID, tf), ..>
+    sparse_vt _tf_idf_vec;                     // e.g. <(1, 2), (4, 1.5), (7, .84), ..>
     float_vt _wordembeddings_vec;           
     boost::dynamic_bitset<> _rand_proj_vec; // e.g. <0, 1, 1, 1, 0, 1, ..>
     float _norm_length;                        // normalization factor of _tf_idf_vec
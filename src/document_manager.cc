@@ -15,16 +15,66 @@ DocumentManager::DocumentManager() :
 void DocumentManager::init(const control_block_t& aControlBlock) {
     if (!_cb) {
         _cb = &aControlBlock;
-        const std::string& lCollectionPath = _cb->collectionPath();
-        string_vvt lCollectionFiles;
-        Util::readIn(lCollectionPath, _delimiter, lCollectionFiles);
-        for (auto& line : lCollectionFiles) {
-            std::string lDocID = line.at(0);
-            string_vt lContent;
-            Util::splitStringBoost(line.at(1), ' ', lContent); // Split string by whitespaces
-            Document doc(lDocID, lContent);
-            addDoc(doc);
+        if (Util::isSnapshotUsable(*_cb)) { // the documents are restored with the index, @see IndexManager::init
+            TRACE("DocumentManager: Initialized from the index snapshot");
+            return;
         }
+        const std::string& lCollectionPath = _cb->collectionPath();
+        struct ParsedChunk {
+            std::vector<std::pair<std::string, string_vt>> _docs; // (docID, content) in file order
+            strview_vt _newTerms;                                  // terms in the order of their first occurrence in the chunk
+            std::unordered_set<std::string_view> _seenTerms;
+            strview_vt _terms;
+        };
+        TermDictionary& dict = TermDictionary::getInstance();
+        Util::readInParallel<ParsedChunk>(lCollectionPath, _delimiter, _cb->threads(), [](const strview_vt& line, ParsedChunk& chunk) { // tokenized in place on the mapped file
+            Util::splitStringView(line.at(1), ' ', chunk._terms); // Split string by whitespaces
+            for (const std::string_view term : chunk._terms) {
+                if (chunk._seenTerms.insert(term).second) { chunk._newTerms.push_back(term); }
+            }
+            chunk._docs.emplace_back(std::string(line.at(0)), string_vt(chunk._terms.begin(), chunk._terms.end()));
+        }, [this, &dict](ParsedChunk& chunk) { // in file order, so doc ids and term ids are the same as for a sequential read
+            for (const std::string_view term : chunk._newTerms) {
+                dict.insert(std::string(term));
+            }
+            for (auto& [docID, content] : chunk._docs) {
+                addDoc(Document(docID, std::move(content)));
+            }
+        });
         TRACE("DocumentManager: Initialized");
     }
 }
+
+void DocumentManager::save(std::ostream& aOut) const {
+    Util::writeValue<uint64_t>(aOut, _docs.size());
+    for (const auto& [id, doc] : _docs) {
+        Util::writeValue<uint64_t>(aOut, id);
+        Util::writeString(aOut, doc.getDocID());
+        Util::writeStrings(aOut, doc.getContent());
+        Util::writeSparse(aOut, doc.getTermTfVector());
+        Util::writeSparse(aOut, doc.getTfIdfVector());
+        Util::writeVector(aOut, doc.getWordEmbeddingsVector());
+        Util::writeBitset(aOut, doc.getRandProjVec());
+        Util::writeValue(aOut, doc.getNormLength());
+    }
+}
+
+void DocumentManager::load(Util::BinaryReader& aReader) {
+    const uint64_t lNoDocs = aReader.readValue<uint64_t>();
+    for (uint64_t i = 0; i < lNoDocs; ++i) {
+        const size_t lID = aReader.readValue<uint64_t>();
+        const std::string lDocID = aReader.readString();
+        string_vt lContent;
+        aReader.readStrings(lContent);
+        Document doc(lDocID, std::move(lContent));
+        if (doc.getID() != lID) {
+            throw InvalidArgumentException(FLF, "The document " + lDocID + " can not get its original id " + std::to_string(lID) + ".");
+        }
+        aReader.readSparse(doc.getTermTfVector());
+        aReader.readSparse(doc.getTfIdfVector());
+        aReader.readVector(doc.getWordEmbeddingsVector());
+        aReader.readBitset(doc.getRandProjVec());
+        doc.setNormLength(aReader.readValue<float>());
+        addDoc(std::move(doc));
+    }
+}
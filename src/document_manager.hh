@@ -13,17 +13,23 @@
 #include "exception.hh"
 #include "file_util.hh"
 #include "ir_util.hh"
+#include "serialization_util.hh"
 #include "string_util.hh"
+#include "term_dictionary.hh"
 #include "trace.hh"
 #include "types.hh"
 
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 class DocumentManager {
+    friend class IndexManager; // adds the documents which are ingested online
+
   private:
     DocumentManager();
     DocumentManager(const DocumentManager&) = delete;
@@ -106,6 +112,14 @@ class DocumentManager {
         return const_cast<Document&>(static_cast<const DocumentManager&>(*this).getDocument(aDocID));
     }
 
+    /**
+     * @brief Check if a document with the (string) id aDocID exists
+     *
+     * @param aDocID the id of the document
+     * @return true if the document exists
+     */
+    inline bool hasDocument(const std::string& aDocID) const { return _str_docid.find(aDocID) != _str_docid.end(); }
+
     /**
      * @brief Get the Instance object
      *
@@ -121,12 +135,26 @@ class DocumentManager {
      * @param aControlBlock the control block
      */
     void init(const CB& aControlBlock);
+    /**
+     * @brief Write the document table (including the vectors of every document) to a snapshot
+     *
+     * @param aOut the output stream
+     */
+    void save(std::ostream& aOut) const;
+    /**
+     * @brief Restore the document table written by @see save. The documents have to be the first ones created,
+     *        so they get their original ids
+     *
+     * @param aReader the snapshot reader
+     */
+    void load(Util::BinaryReader& aReader);
 
   private:
-    inline void addDoc(const Document& aDoc) {
-        _docs.try_emplace(aDoc.getID(), aDoc);
-        _docids.push_back(aDoc.getID());
-        _str_docid.insert(std::make_pair(aDoc.getDocID(), aDoc.getID()));
+    inline void addDoc(Document&& aDoc) {
+        const size_t lID = aDoc.getID();
+        _docids.push_back(lID);
+        _str_docid.insert(std::make_pair(aDoc.getDocID(), lID));
+        _docs.try_emplace(lID, std::move(aDoc));
     }
 
   private:
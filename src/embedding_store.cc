@@ -0,0 +1,131 @@
+#include "embedding_store.hh"
+
+/**
+ * @brief Construct a new Embedding Store:: Embedding Store object
+ *
+ */
+EmbeddingStore::EmbeddingStore() :
+    _file(),
+    _noWords(0),
+    _dimensions(0),
+    _offsets(nullptr),
+    _ranks(nullptr),
+    _words(nullptr),
+    _vectors(nullptr)
+{}
+
+void EmbeddingStore::convert(const std::string& aTextPath, const std::string& aStorePath, const size_t aNoThreads) {
+    using embedding_vt = std::vector<std::pair<std::string, float_vt>>;
+    embedding_vt lEmbeddings;
+    Util::readInParallel<embedding_vt>(aTextPath, ' ', aNoThreads, [](const strview_vt& line, embedding_vt& chunk) {
+        if (line.size() == 1 && line[0].empty()) { return; } // empty line
+        float_vt lVector;
+        lVector.reserve(line.size() - 1);
+        for (size_t j = 1; j < line.size(); ++j) {
+            lVector.push_back(std::stof(std::string(line[j])));
+        }
+        chunk.emplace_back(std::string(line[0]), std::move(lVector));
+    }, [&lEmbeddings](embedding_vt& chunk) { std::move(chunk.begin(), chunk.end(), std::back_inserter(lEmbeddings)); });
+    std::vector<uint32_t> lOrder(lEmbeddings.size()); // the words sorted ascending, a word's first line first
+    std::iota(lOrder.begin(), lOrder.end(), 0);
+    std::stable_sort(lOrder.begin(), lOrder.end(), [&lEmbeddings](const uint32_t aLHS, const uint32_t aRHS) { return lEmbeddings[aLHS].first < lEmbeddings[aRHS].first; });
+    lOrder.erase(std::unique(lOrder.begin(), lOrder.end(), [&lEmbeddings](const uint32_t aLHS, const uint32_t aRHS) { return lEmbeddings[aLHS].first == lEmbeddings[aRHS].first; }), lOrder.end());
+    const uint64_t lDimensions = lEmbeddings.empty() ? 0 : lEmbeddings.front().second.size();
+    for (const auto& [word, vec] : lEmbeddings) {
+        if (vec.size() != lDimensions) {
+            throw FileException(FLF, aTextPath.c_str(), "The vector of '" + word + "' does not have " + std::to_string(lDimensions) + " dimensions.");
+        }
+    }
+
+    const std::string lTmpPath = aStorePath + ".tmp" + std::to_string(::getpid()); // processes converting the same model do not share it
+    std::ofstream out(lTmpPath, std::ios::binary | std::ios::trunc);
+    if (!out) { throw FileException(FLF, lTmpPath.c_str(), "The word embedding store can not be written."); }
+    Util::writeValue(out, kMagic);
+    Util::writeValue(out, kVersion);
+    Util::writeValue<uint64_t>(out, lOrder.size());
+    Util::writeValue<uint64_t>(out, lDimensions);
+    uint64_t lOffset = 0;
+    Util::writeValue(out, lOffset);
+    for (const uint32_t i : lOrder) {
+        lOffset += lEmbeddings[i].first.size();
+        Util::writeValue(out, lOffset);
+    }
+    out.write(reinterpret_cast<const char*>(lOrder.data()), lOrder.size() * sizeof(uint32_t)); // the ranks
+    for (const uint32_t i : lOrder) {
+        out.write(lEmbeddings[i].first.data(), lEmbeddings[i].first.size());
+    }
+    const size_t lWritten = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t) + (lOrder.size() + 1) * sizeof(uint64_t) + lOrder.size() * sizeof(uint32_t) + lOffset;
+    const std::string lPadding((kVectorAlignment - lWritten % kVectorAlignment) % kVectorAlignment, '\0');
+    out.write(lPadding.data(), lPadding.size());
+    for (const uint32_t i : lOrder) {
+        out.write(reinterpret_cast<const char*>(lEmbeddings[i].second.data()), lDimensions * sizeof(float));
+    }
+    out.close();
+    if (!out || std::rename(lTmpPath.c_str(), aStorePath.c_str()) != 0) {
+        std::remove(lTmpPath.c_str());
+        throw FileException(FLF, aStorePath.c_str(), "The word embedding store can not be written.");
+    }
+}
+
+bool EmbeddingStore::isStore(const std::string& aPath) {
+    std::ifstream file(aPath, std::ios::binary);
+    uint32_t lMagic = 0;
+    uint32_t lVersion = 0;
+    file.read(reinterpret_cast<char*>(&lMagic), sizeof(lMagic));
+    file.read(reinterpret_cast<char*>(&lVersion), sizeof(lVersion));
+    return file && lMagic == kMagic && lVersion == kVersion;
+}
+
+void EmbeddingStore::open(const std::string& aPath) {
+    _file = std::make_unique<Util::MappedFile>(aPath);
+    const std::string_view lData = _file->view();
+    const std::string lErrMsg = "The file is not a valid word embedding store of version " + std::to_string(kVersion) + ".";
+    const size_t lHeaderSize = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+    if (lData.size() < lHeaderSize) { throw FileException(FLF, aPath.c_str(), lErrMsg); }
+    uint32_t lMagic, lVersion;
+    uint64_t lNoWords, lDimensions;
+    std::memcpy(&lMagic, lData.data(), sizeof(uint32_t));
+    std::memcpy(&lVersion, lData.data() + sizeof(uint32_t), sizeof(uint32_t));
+    std::memcpy(&lNoWords, lData.data() + 2 * sizeof(uint32_t), sizeof(uint64_t));
+    std::memcpy(&lDimensions, lData.data() + 2 * sizeof(uint32_t) + sizeof(uint64_t), sizeof(uint64_t));
+    if (lMagic != kMagic || lVersion != kVersion || lNoWords >= lData.size() / sizeof(uint64_t)) { throw FileException(FLF, aPath.c_str(), lErrMsg); }
+    const size_t lRanksBegin = lHeaderSize + (lNoWords + 1) * sizeof(uint64_t);
+    const size_t lWordsBegin = lRanksBegin + lNoWords * sizeof(uint32_t);
+    if (lWordsBegin > lData.size()) { throw FileException(FLF, aPath.c_str(), lErrMsg); }
+    const uint64_t* lOffsets = reinterpret_cast<const uint64_t*>(lData.data() + lHeaderSize); // the mapping is page aligned
+    if (lOffsets[lNoWords] > lData.size() - lWordsBegin) { throw FileException(FLF, aPath.c_str(), lErrMsg); }
+    const size_t lWordsEnd = lWordsBegin + lOffsets[lNoWords];
+    const size_t lVectorsBegin = (lWordsEnd + kVectorAlignment - 1) / kVectorAlignment * kVectorAlignment;
+    if (lDimensions != 0 && lNoWords > (lData.size() / sizeof(float)) / lDimensions) { throw FileException(FLF, aPath.c_str(), lErrMsg); }
+    if (lVectorsBegin + lNoWords * lDimensions * sizeof(float) != lData.size()) { throw FileException(FLF, aPath.c_str(), lErrMsg); }
+    _noWords = lNoWords;
+    _dimensions = lDimensions;
+    _offsets = lOffsets;
+    _ranks = reinterpret_cast<const uint32_t*>(lData.data() + lRanksBegin);
+    _words = lData.data() + lWordsBegin;
+    _vectors = reinterpret_cast<const float*>(lData.data() + lVectorsBegin);
+}
+
+void EmbeddingStore::close() {
+    _file.reset();
+    _noWords = 0;
+    _dimensions = 0;
+    _offsets = nullptr;
+    _ranks = nullptr;
+    _words = nullptr;
+    _vectors = nullptr;
+}
+
+const float* EmbeddingStore::find(const std::string_view aWord) const {
+    size_t lo = 0;
+    size_t hi = _noWords;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (getWord(mid) < aWord) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo < _noWords && getWord(lo) == aWord) ? getVector(lo) : nullptr;
+}
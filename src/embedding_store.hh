@@ -0,0 +1,128 @@
+/**
+ *	@file 	embedding_store.hh
+ *	@brief  Implements the binary word embedding store. The store is written once from a text model (one word and its
+ *          components per line, e.g. GloVe) and memory-mapped read-only afterwards, so loading it costs no parsing
+ *          and the vectors live in the shared page cache. Layout (native byte order):
+ *          magic, version, noWords, dimensions, offsets[noWords + 1] into the word block, ranks[noWords] (the
+ *          line of every word in the text model, which is ordered by frequency for GloVe), the words sorted
+ *          ascending and concatenated, padding to kVectorAlignment, float vectors[noWords][dimensions]
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "exception.hh"
+#include "file_util.hh"
+#include "serialization_util.hh"
+#include "types.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+class EmbeddingStore {
+  public:
+    static constexpr uint32_t kMagic = 0x45575645;     // "EVWE"
+    static constexpr uint32_t kVersion = 2;            // increment on every change of the layout
+    static constexpr size_t kVectorAlignment = 64;     // byte alignment of the vector block (a cache line)
+
+  public:
+    EmbeddingStore();
+    EmbeddingStore(const EmbeddingStore&) = delete;
+    EmbeddingStore(EmbeddingStore&&) = delete;
+    EmbeddingStore& operator=(const EmbeddingStore&) = delete;
+    EmbeddingStore& operator=(EmbeddingStore&&) = delete;
+    ~EmbeddingStore() = default;
+
+  public:
+    /**
+     * @brief Convert a text model into a binary store. If a word appears more than once, its first vector is kept
+     *
+     * @param aTextPath the path of the text model
+     * @param aStorePath the path of the store, it is replaced atomically by renaming a temporary file of this process
+     * @param aNoThreads the number of threads parsing the text model
+     */
+    static void convert(const std::string& aTextPath, const std::string& aStorePath, const size_t aNoThreads);
+    /**
+     * @brief Whether the file at aPath starts like a binary store of the current version
+     *
+     * @param aPath the path of the file
+     * @return bool true if it is a store
+     */
+    static bool isStore(const std::string& aPath);
+
+    /**
+     * @brief Memory map the store at aPath
+     *
+     * @param aPath the path of the store
+     */
+    void open(const std::string& aPath);
+    /**
+     * @brief Unmap the store, afterwards it is empty
+     *
+     */
+    void close();
+
+    /**
+     * @brief Find the vector of a word by binary search over the sorted words
+     *
+     * @param aWord the word
+     * @return const float* the dimensions() components of the vector, nullptr if the word has no vector
+     */
+    const float* find(const std::string_view aWord) const;
+
+    /**
+     * @brief Get the i-th word in ascending order
+     *
+     * @param i the index of the word
+     * @return std::string_view the word
+     */
+    inline std::string_view getWord(const size_t i) const { return std::string_view(_words + _offsets[i], _offsets[i + 1] - _offsets[i]); }
+    /**
+     * @brief Get the vector of the i-th word
+     *
+     * @param i the index of the word
+     * @return const float* the dimensions() components of the vector
+     */
+    inline const float* getVector(const size_t i) const { return _vectors + i * _dimensions; }
+    /**
+     * @brief Get the line of the i-th word in the text model
+     *
+     * @param i the index of the word
+     * @return uint32_t the rank, a lower rank means a more frequent word for GloVe
+     */
+    inline uint32_t getRank(const size_t i) const { return _ranks[i]; }
+
+    /**
+     * @brief Get the number of words
+     *
+     * @return size_t the number of words
+     */
+    inline size_t size() const { return _noWords; }
+    /**
+     * @brief Get the number of components of every vector
+     *
+     * @return size_t the dimensions
+     */
+    inline size_t dimensions() const { return _dimensions; }
+
+  private:
+    std::unique_ptr<Util::MappedFile> _file;
+    size_t _noWords;
+    size_t _dimensions;
+    const uint64_t* _offsets;
+    const uint32_t* _ranks;
+    const char* _words;
+    const float* _vectors;
+};
@@ -10,23 +10,23 @@ void IRPM::init(const CB& aControlBlock)
     {
         _cb = &aControlBlock;
         const std::string& lRelScorePath = _cb->relevanceScoresPath();
-        string_vvt lRelScoreFile;
-        Util::readIn(lRelScorePath, '~', lRelScoreFile);
-        for(const auto& line : lRelScoreFile)
+        using score_chunk_t = std::vector<RelScore>; // in file order
+        try
         {
-            try
-            {
-                const std::string qID = line.at(0);
-                const std::string dID = line.at(1);
-                const uint score = std::stoul(line.at(2));
-                _queryScores[qID].emplace_back(qID, dID, score);
-            }
-            catch (const std::out_of_range& ex) 
-            {
-                const std::string lErrMsg = std::string("Evaluation::IR_PerformanceManager: Init failed, most probably the file at '" + lRelScorePath + std::string("' is in the wrong format!"));
-                TRACE(lErrMsg);
-                throw;
-            }
+            Util::readInParallel<score_chunk_t>(lRelScorePath, '~', _cb->threads(), [](const strview_vt& line, score_chunk_t& chunk) {
+                chunk.emplace_back(std::string(line.at(0)), std::string(line.at(1)), std::stoul(std::string(line.at(2))));
+            }, [this](score_chunk_t& chunk) {
+                for(RelScore& relScore : chunk)
+                {
+                    _queryScores[relScore.getQueryID()].push_back(std::move(relScore));
+                }
+            });
+        }
+        catch (const std::out_of_range& ex) 
+        {
+            const std::string lErrMsg = std::string("Evaluation::IR_PerformanceManager: Init failed, most probably the file at '" + lRelScorePath + std::string("' is in the wrong format!"));
+            TRACE(lErrMsg);
+            throw;
         }
         for(auto& elem : _queryScores)
         {
@@ -354,6 +354,7 @@ void Evaluation::constructJSON(const str_set& aQueryNames)
         for(const auto& [mode, results] : modes){
             json lMode = json::object();
             lMode["name"] = modeToString(mode);
+            lMode["embedding_precision"] = precisionToString(_cb->embeddingPrecision()); // to compare the recall of the precisions
             json lQueryResults = json::array();
             for(const auto& query : aQueryNames)
             {
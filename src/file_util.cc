@@ -3,17 +3,60 @@
 namespace Util
 {
     void readIn(const std::string& aPath, const char aDelimiter, string_vvt& aOutput)
+    {
+        readIn(aPath, aDelimiter, [&aOutput](const string_vt& aLine) { aOutput.push_back(aLine); });
+    }
+
+    void readIn(const std::string& aPath, const char aDelimiter, const std::function<void(const string_vt&)>& aLineFunc)
     {
         TRACE(std::string("Start reading the file content at '") + aPath + std::string("'"));
         std::ifstream file(aPath, std::ifstream::in);
         std::string line;
-        size_t i = 0;
+        string_vt fields;
         while (std::getline(file, line)) {
-            aOutput.push_back(string_vt());
-            Util::splitStringBoost(line, aDelimiter, aOutput[i]);
-            ++i;
+            fields.clear();
+            Util::splitStringBoost(line, aDelimiter, fields);
+            aLineFunc(fields);
         }
         file.close();
         TRACE("Finished reading the file content");
     }
+
+    sizet_vt lineChunkBoundaries(const std::string_view aContent, const size_t aNoChunks)
+    {
+        sizet_vt bounds = {0};
+        const size_t chunkSize = aContent.size() / std::max<size_t>(1, aNoChunks) + 1;
+        while (bounds.back() < aContent.size()) {
+            const size_t eol = aContent.find('\n', std::min(bounds.back() + chunkSize, aContent.size()) - 1);
+            bounds.push_back((eol == std::string_view::npos) ? aContent.size() : eol + 1);
+        }
+        return bounds;
+    }
+
+    MappedFile::MappedFile(const std::string& aPath) :
+        _map(nullptr),
+        _size(0)
+    {
+        const int fd = open(aPath.c_str(), O_RDONLY);
+        if (fd < 0) { throw FileException(FLF, aPath.c_str(), "The file can not be opened."); }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw FileException(FLF, aPath.c_str(), "The file size can not be determined.");
+        }
+        _size = st.st_size;
+        if (_size > 0) {
+            _map = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd); // the mapping stays valid
+        if (_map == MAP_FAILED) {
+            _map = nullptr;
+            throw FileException(FLF, aPath.c_str(), "The file can not be memory-mapped.");
+        }
+        if (_map) { madvise(_map, _size, MADV_SEQUENTIAL); }
+    }
+
+    MappedFile::~MappedFile() {
+        if (_map) { munmap(_map, _size); }
+    }
 }
@@ -11,8 +11,16 @@
 #include "exception.hh"
 #include "trace.hh"
 #include "string_util.hh"
+#include "thread_util.hh"
 
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 
 namespace Util {
@@ -22,4 +30,92 @@ namespace Util {
      *
      */
     void readIn(const std::string& aPath, const char aDelimiter, string_vvt& aOutput);
+    /**
+     * @brief Streams the file content line by line, splits each line at the specified delimiter and passes it to aLineFunc,
+     *        so only one line is held in memory at a time
+     *
+     */
+    void readIn(const std::string& aPath, const char aDelimiter, const std::function<void(const string_vt&)>& aLineFunc);
+
+    class MappedFile {
+      public:
+        /**
+         * @brief Map the file at aPath read-only
+         *
+         * @param aPath the path of the file
+         */
+        explicit MappedFile(const std::string& aPath);
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&&) = delete;
+        ~MappedFile();
+
+      public:
+        /**
+         * @brief Get the content of the file
+         *
+         * @return std::string_view the mapped bytes, valid as long as this object lives
+         */
+        inline std::string_view view() const { return std::string_view(static_cast<const char*>(_map), _size); }
+
+      private:
+        void* _map;
+        size_t _size;
+    };
+
+    /**
+     * @brief Cut aContent into about aNoChunks byte ranges of similar size which end after a newline (or at the end),
+     *        so every line lies in exactly one chunk
+     *
+     * @param aContent the file content
+     * @param aNoChunks the number of chunks aimed at, at least one
+     * @return sizet_vt the chunk boundaries, chunk c is [result[c], result[c + 1])
+     */
+    sizet_vt lineChunkBoundaries(const std::string_view aContent, const size_t aNoChunks);
+
+    /**
+     * @brief Passes every line of aContent, split at the specified delimiter, to aLineFunc. Lines end at a newline
+     *
+     */
+    template <typename Func>
+    inline void forEachLine(std::string_view aContent, const char aDelimiter, Func&& aLineFunc) {
+        strview_vt fields;
+        while (!aContent.empty()) {
+            const size_t eol = aContent.find('\n');
+            Util::splitStringView(aContent.substr(0, eol), aDelimiter, fields);
+            aLineFunc(fields);
+            aContent.remove_prefix((eol == std::string_view::npos) ? aContent.size() : eol + 1);
+        }
+    }
+
+    /**
+     * @brief Memory maps the file, cuts it into chunks at line boundaries and parses the chunks on up to aNoThreads
+     *        threads: aParseFunc(fields, result) is called for every line of a chunk with the chunk's own result. The
+     *        results are then handed to aChunkFunc on the calling thread in file order, so anything which has to be
+     *        assigned sequentially (e.g. ids) stays deterministic. The fields are views into the mapping which stays
+     *        valid until aChunkFunc returned for the last chunk
+     *
+     * @param aPath the path of the file
+     * @param aDelimiter the field delimiter
+     * @param aNoThreads the maximal number of threads
+     * @param aParseFunc called for every line, possibly concurrently for different chunks
+     * @param aChunkFunc called for every chunk result in file order
+     */
+    template <typename T>
+    void readInParallel(const std::string& aPath, const char aDelimiter, const size_t aNoThreads,
+                        const std::function<void(const strview_vt&, T&)>& aParseFunc, const std::function<void(T&)>& aChunkFunc) {
+        const MappedFile file(aPath);
+        const std::string_view content = file.view();
+        const sizet_vt bounds = lineChunkBoundaries(content, (aNoThreads > 1) ? 4 * aNoThreads : 1); // several chunks per thread even out the line lengths
+        std::vector<T> results(bounds.size() - 1);
+        Util::parallelFor(results.size(), aNoThreads, [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) {
+                forEachLine(content.substr(bounds[c], bounds[c + 1] - bounds[c]), aDelimiter, [&](const strview_vt& fields) { aParseFunc(fields, results[c]); });
+            }
+        }, 1);
+        for (T& result : results) {
+            aChunkFunc(result);
+        }
+    }
 }
\ No newline at end of file
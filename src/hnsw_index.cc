@@ -0,0 +1,295 @@
+#include "hnsw_index.hh"
+
+/**
+ * @brief Construct a new Hnsw Index:: Hnsw Index object
+ *
+ */
+HnswIndex::HnswIndex() :
+    _cb(nullptr),
+    _M(0),
+    _efConstruction(0),
+    _dimensions(0),
+    _noNodes(0),
+    _vectors(),
+    _levels(),
+    _links(),
+    _entryPoint(0),
+    _maxLevel(-1),
+    _rng(),
+    _entryMutex(),
+    _nodeLocks()
+{}
+
+void HnswIndex::init(const CB& aControlBlock) {
+    if (!_cb) {
+        _cb = &aControlBlock;
+        _M = _cb->hnswM();
+        _efConstruction = std::max<size_t>(_cb->hnswEfConstruction(), _M);
+        _rng.seed(_cb->seed());
+        TRACE("HnswIndex: Initialized");
+    }
+}
+
+int HnswIndex::randomLevel() {
+    std::uniform_real_distribution<double> lUniform(0.0, 1.0);
+    return static_cast<int>(-std::log(1.0 - lUniform(_rng)) / std::log(static_cast<double>(_M)));
+}
+
+bool HnswIndex::setVector(const node_t aNode, const float_vt& aVec) {
+    if (aNode >= _levels.size()) {
+        _vectors.resize((static_cast<size_t>(aNode) + 1) * _dimensions, 0);
+        _levels.resize(aNode + 1, -1);
+        _links.resize(aNode + 1);
+    }
+    if (aVec.size() < _dimensions) { return false; }
+    double lLength = Util::squaredNorm(aVec.data(), _dimensions);
+    if (lLength == 0) { return false; }
+    lLength = std::sqrt(lLength);
+    float* lOut = &_vectors[static_cast<size_t>(aNode) * _dimensions];
+    for (size_t i = 0; i < _dimensions; ++i) {
+        lOut[i] = static_cast<float>(aVec[i] / lLength);
+    }
+    return true;
+}
+
+float HnswIndex::similarity(const float* aQuery, const node_t aNode) const {
+    return static_cast<float>(Util::dot(aQuery, this->vector(aNode), _dimensions));
+}
+
+HnswIndex::link_vt HnswIndex::linksOf(const node_t aNode, const int aLevel) const {
+    std::lock_guard<std::mutex> lock(this->lockOf(aNode));
+    return _links[aNode][aLevel];
+}
+
+void HnswIndex::build(const doc_mt& aDocs) {
+    _dimensions = aDocs.empty() ? 0 : aDocs.begin()->second.getWordEmbeddingsVector().size();
+    std::vector<node_t> lNodes;
+    for (const auto& [id, doc] : aDocs) {
+        if (this->setVector(static_cast<node_t>(id), doc.getWordEmbeddingsVector())) {
+            lNodes.push_back(static_cast<node_t>(id));
+        }
+    }
+    for (const node_t node : lNodes) { // drawn in the order of the ids, so the levels do not depend on the threads
+        _levels[node] = this->randomLevel();
+        _links[node].resize(_levels[node] + 1);
+    }
+    if (lNodes.empty()) { return; }
+    this->insert(lNodes.front());
+    Util::parallelFor(lNodes.size() - 1, _cb->threads(), [this, &lNodes](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            this->insert(lNodes[i + 1]);
+        }
+    });
+    _noNodes = lNodes.size();
+    TRACE("HnswIndex: Built the graph over " + std::to_string(_noNodes) + " documents with " + std::to_string(_maxLevel + 1) + " layers");
+}
+
+void HnswIndex::add(const size_t aDocID, const float_vt& aVec) {
+    if (_dimensions == 0) { _dimensions = aVec.size(); }
+    const node_t lNode = static_cast<node_t>(aDocID);
+    if (!this->setVector(lNode, aVec)) { return; }
+    _levels[lNode] = this->randomLevel();
+    _links[lNode].assign(_levels[lNode] + 1, link_vt());
+    this->insert(lNode);
+    ++_noNodes;
+}
+
+void HnswIndex::insert(const node_t aNode) {
+    const int lLevel = _levels[aNode];
+    const float* lQuery = this->vector(aNode);
+    std::unique_lock<std::mutex> entryLock(_entryMutex);
+    const std::pair<node_t, int> lEntryPoint(_entryPoint, _maxLevel);
+    if (lEntryPoint.second < 0) { // the first node
+        _entryPoint = aNode;
+        _maxLevel = lLevel;
+        return;
+    }
+    if (lLevel <= lEntryPoint.second) { // only a node which becomes the entry point keeps the lock
+        entryLock.unlock();
+    }
+    std::vector<scored_node_t> lEntries{this->descend(lQuery, lLevel, lEntryPoint)};
+    for (int level = std::min(lLevel, lEntryPoint.second); level >= 0; --level) {
+        farther_queue_t lFound = this->searchLayer(lQuery, lEntries, _efConstruction, level);
+        lEntries.clear();
+        while (!lFound.empty()) {
+            lEntries.push_back(lFound.top());
+            lFound.pop();
+        }
+        const link_vt lNeighbours = this->selectNeighbours(lEntries, _M);
+        {
+            std::lock_guard<std::mutex> lock(this->lockOf(aNode));
+            _links[aNode][level] = lNeighbours;
+        }
+        for (const node_t neighbour : lNeighbours) {
+            std::lock_guard<std::mutex> lock(this->lockOf(neighbour));
+            link_vt& lLinks = _links[neighbour][level];
+            if (lLinks.size() < this->maxLinks(level)) {
+                lLinks.push_back(aNode);
+            } else { // shrink the links of the neighbour with the same heuristic
+                const float* lNeighbourVec = this->vector(neighbour);
+                std::vector<scored_node_t> lCandidates;
+                lCandidates.reserve(lLinks.size() + 1);
+                for (const node_t link : lLinks) {
+                    lCandidates.emplace_back(this->similarity(lNeighbourVec, link), link);
+                }
+                lCandidates.emplace_back(this->similarity(lNeighbourVec, aNode), aNode);
+                lLinks = this->selectNeighbours(std::move(lCandidates), this->maxLinks(level));
+            }
+        }
+    }
+    if (lLevel > lEntryPoint.second) {
+        _entryPoint = aNode;
+        _maxLevel = lLevel;
+    }
+}
+
+HnswIndex::scored_node_t HnswIndex::descend(const float* aQuery, const int aLevel, const std::pair<node_t, int>& aEntryPoint) const {
+    scored_node_t lCurrent(this->similarity(aQuery, aEntryPoint.first), aEntryPoint.first);
+    for (int level = aEntryPoint.second; level > aLevel; --level) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (const node_t link : this->linksOf(lCurrent.second, level)) {
+                const float lSim = this->similarity(aQuery, link);
+                if (lSim > lCurrent.first) {
+                    lCurrent = scored_node_t(lSim, link);
+                    changed = true;
+                }
+            }
+        }
+    }
+    return lCurrent;
+}
+
+HnswIndex::farther_queue_t HnswIndex::searchLayer(const float* aQuery, const std::vector<scored_node_t>& aEntryPoints, const size_t aEf, const int aLevel) const {
+    std::unordered_set<node_t> lVisited;
+    lVisited.reserve(aEf * this->maxLinks(aLevel));
+    closer_queue_t lCandidates;
+    farther_queue_t lFound;
+    for (const scored_node_t& entry : aEntryPoints) {
+        if (lVisited.insert(entry.second).second) {
+            lCandidates.push(entry);
+            lFound.push(entry);
+        }
+    }
+    while (lFound.size() > aEf) { lFound.pop(); }
+    while (!lCandidates.empty()) {
+        const scored_node_t lCandidate = lCandidates.top();
+        if (lFound.size() >= aEf && lCandidate.first < lFound.top().first) { break; } // no candidate can improve the result
+        lCandidates.pop();
+        for (const node_t link : this->linksOf(lCandidate.second, aLevel)) {
+            if (!lVisited.insert(link).second) { continue; }
+            const float lSim = this->similarity(aQuery, link);
+            if (lFound.size() < aEf || lSim > lFound.top().first) {
+                lCandidates.emplace(lSim, link);
+                lFound.emplace(lSim, link);
+                if (lFound.size() > aEf) { lFound.pop(); }
+            }
+        }
+    }
+    return lFound;
+}
+
+HnswIndex::link_vt HnswIndex::selectNeighbours(std::vector<scored_node_t> aCandidates, const size_t aMaxLinks) const {
+    std::sort(aCandidates.begin(), aCandidates.end(), [](const scored_node_t& a, const scored_node_t& b) { return a.first > b.first; });
+    link_vt lSelected;
+    lSelected.reserve(aMaxLinks);
+    for (const auto& [sim, candidate] : aCandidates) {
+        if (lSelected.size() >= aMaxLinks) { break; }
+        const float* lCandidateVec = this->vector(candidate);
+        const bool lDiverse = std::none_of(lSelected.begin(), lSelected.end(), [&](const node_t selected) { return this->similarity(lCandidateVec, selected) > sim; });
+        if (lDiverse) {
+            lSelected.push_back(candidate);
+        }
+    }
+    return lSelected;
+}
+
+pair_sizet_float_vt HnswIndex::search(const float_vt& aQuery, const size_t aTopK, const size_t aEfSearch) const {
+    pair_sizet_float_vt lResult;
+    if (_maxLevel < 0 || aQuery.size() < _dimensions) { return lResult; }
+    double lLength = 0;
+    for (size_t i = 0; i < _dimensions; ++i) {
+        lLength += static_cast<double>(aQuery[i]) * aQuery[i];
+    }
+    if (lLength == 0) { return lResult; } // no query term has a vector
+    lLength = std::sqrt(lLength);
+    float_vt lQuery(_dimensions);
+    for (size_t i = 0; i < _dimensions; ++i) {
+        lQuery[i] = static_cast<float>(aQuery[i] / lLength);
+    }
+    const scored_node_t lEntry = this->descend(lQuery.data(), 0, std::make_pair(_entryPoint, _maxLevel));
+    farther_queue_t lFound = this->searchLayer(lQuery.data(), {lEntry}, std::max(aTopK, aEfSearch), 0);
+    lResult.resize(lFound.size());
+    for (auto it = lResult.rbegin(); it != lResult.rend(); ++it) { // the least similar node is on top
+        *it = std::make_pair(static_cast<size_t>(lFound.top().second), lFound.top().first);
+        lFound.pop();
+    }
+    return lResult;
+}
+
+void HnswIndex::save(const std::string& aPath) const {
+    const std::string lTmpPath = aPath + ".tmp";
+    std::ofstream out(lTmpPath, std::ios::binary | std::ios::trunc);
+    if (!out) { throw FileException(FLF, lTmpPath.c_str(), "The HNSW graph can not be written."); }
+    Util::writeValue(out, kMagic);
+    Util::writeValue(out, kVersion);
+    Util::writeString(out, Util::snapshotHeader(*_cb)); // the collection and the embeddings the graph was built for
+    Util::writeValue<uint64_t>(out, _M);
+    Util::writeValue<uint64_t>(out, _efConstruction);
+    Util::writeValue<uint64_t>(out, _dimensions);
+    Util::writeValue<uint64_t>(out, _noNodes);
+    Util::writeValue(out, _entryPoint);
+    Util::writeValue<int32_t>(out, _maxLevel);
+    Util::writeVector(out, _levels);
+    for (size_t node = 0; node < _levels.size(); ++node) {
+        for (int level = 0; level <= _levels[node]; ++level) {
+            Util::writeVector(out, _links[node][level]);
+        }
+    }
+    out.close();
+    if (!out || std::rename(lTmpPath.c_str(), aPath.c_str()) != 0) {
+        throw FileException(FLF, aPath.c_str(), "The HNSW graph can not be written.");
+    }
+    TRACE("HnswIndex: Wrote the graph to " + aPath);
+}
+
+bool HnswIndex::load(const std::string& aPath, const doc_mt& aDocs) {
+    std::ifstream file(aPath, std::ios::binary);
+    uint32_t lMagic = 0;
+    uint32_t lVersion = 0;
+    file.read(reinterpret_cast<char*>(&lMagic), sizeof(lMagic));
+    file.read(reinterpret_cast<char*>(&lVersion), sizeof(lVersion));
+    if (!file || lMagic != kMagic || lVersion != kVersion) { return false; }
+    file.close();
+
+    Util::BinaryReader reader(aPath, false);
+    reader.skip(sizeof(lMagic) + sizeof(lVersion));
+    if (reader.readString() != Util::snapshotHeader(*_cb) || reader.readValue<uint64_t>() != _M || reader.readValue<uint64_t>() != _efConstruction) {
+        return false;
+    }
+    _dimensions = reader.readValue<uint64_t>();
+    _noNodes = reader.readValue<uint64_t>();
+    _entryPoint = reader.readValue<node_t>();
+    _maxLevel = reader.readValue<int32_t>();
+    std::vector<int> lLevels;
+    reader.readVector(lLevels);
+    for (const auto& [id, doc] : aDocs) {
+        if (id < lLevels.size() && lLevels[id] >= 0 && !this->setVector(static_cast<node_t>(id), doc.getWordEmbeddingsVector())) {
+            throw FileException(FLF, aPath.c_str(), "The HNSW graph does not match the documents.");
+        }
+    }
+    _levels = std::move(lLevels);
+    _vectors.resize(_levels.size() * _dimensions, 0);
+    _links.resize(_levels.size());
+    for (size_t node = 0; node < _levels.size(); ++node) {
+        _links[node].resize(_levels[node] + 1);
+        for (int level = 0; level <= _levels[node]; ++level) {
+            reader.readVector(_links[node][level]);
+        }
+    }
+    if (!reader.atEnd()) {
+        throw FileException(FLF, aPath.c_str(), "The HNSW graph is corrupt.");
+    }
+    return true;
+}
@@ -0,0 +1,200 @@
+/**
+ *	@file 	hnsw_index.hh
+ *	@brief  Implements a hierarchical navigable small world (HNSW) graph over the word embeddings vectors of the
+ *          documents for approximate nearest neighbour search with the cosine similarity. Every document is a node on
+ *          the layers 0 to its random level, a node has up to M neighbours per layer (2 * M on layer 0) which are
+ *          chosen with the neighbour selection heuristic of Malkov and Yashunin. The graph is built on all threads and
+ *          written next to the index snapshot
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+#include "trace.hh"
+#include "exception.hh"
+#include "document.hh"
+#include "serialization_util.hh"
+#include "thread_util.hh"
+#include "simd_util.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+class HnswIndex {
+    friend class IndexManager;
+
+  private:
+    explicit HnswIndex();
+    HnswIndex(const HnswIndex&) = delete;
+    HnswIndex(HnswIndex&&) = delete;
+    HnswIndex& operator=(const HnswIndex&) = delete;
+    HnswIndex& operator=(HnswIndex&&) = delete;
+    ~HnswIndex() = default;
+
+  private:
+    /**
+     * @brief Get the HnswIndex Singleton instance
+     *
+     * @return HnswIndex& a reference to the HnswIndex Singleton instance
+     */
+    inline static HnswIndex& getInstance() {
+        static HnswIndex lInstance;
+        return lInstance;
+    }
+    /**
+     * @brief Initialize control block and the graph parameters
+     *
+     * @param aControlBlock the control block
+     */
+    void init(const CB& aControlBlock);
+
+    /**
+     * @brief Build the graph over the word embeddings vectors of the documents on all threads. The levels of the
+     *        nodes are drawn with the seed of the control block before, documents without a vector are left out
+     *
+     * @param aDocs the documents
+     */
+    void build(const doc_mt& aDocs);
+    /**
+     * @brief Insert one more document, e.g. an added one
+     *
+     * @param aDocID the id of the document
+     * @param aVec the word embeddings vector of the document
+     */
+    void add(const size_t aDocID, const float_vt& aVec);
+
+    /**
+     * @brief Write the links of the graph to aPath. The vectors are not written, @see load
+     *
+     * @param aPath the path of the graph file
+     */
+    void save(const std::string& aPath) const;
+    /**
+     * @brief Restore the links written by @see save and take the vectors from the documents. A graph file which was
+     *        written for another collection or with other M and efConstruction is not loaded
+     *
+     * @param aPath the path of the graph file
+     * @param aDocs the documents
+     * @return true if the graph was loaded, false if it has to be built
+     */
+    bool load(const std::string& aPath, const doc_mt& aDocs);
+
+  public:
+    /**
+     * @brief Search the approximate nearest neighbours of a vector
+     *
+     * @param aQuery the query vector, it does not need to have unit length
+     * @param aTopK the number of results
+     * @param aEfSearch the size of the dynamic candidate list on layer 0, at least aTopK are kept
+     * @return pair_sizet_float_vt the up to max(aTopK, aEfSearch) (docID, cosine similarity) pairs ordered descending
+     */
+    pair_sizet_float_vt search(const float_vt& aQuery, const size_t aTopK, const size_t aEfSearch) const;
+
+    /**
+     * @brief Get the number of documents in the graph
+     *
+     * @return size_t the number of nodes
+     */
+    inline size_t size() const { return _noNodes; }
+
+  private:
+    using node_t = uint32_t;
+    using scored_node_t = std::pair<float, node_t>;
+    using link_vt = std::vector<node_t>;
+
+    struct CloserFirst { // orders a priority queue with the most similar node on top
+        bool operator()(const scored_node_t& a, const scored_node_t& b) const { return a.first < b.first; }
+    };
+    struct FartherFirst { // orders a priority queue with the least similar node on top
+        bool operator()(const scored_node_t& a, const scored_node_t& b) const { return a.first > b.first; }
+    };
+    using closer_queue_t = std::priority_queue<scored_node_t, std::vector<scored_node_t>, CloserFirst>;
+    using farther_queue_t = std::priority_queue<scored_node_t, std::vector<scored_node_t>, FartherFirst>;
+
+    /**
+     * @brief Store the unit length vector of a node, grow the node tables if needed
+     *
+     * @return bool false if the vector is zero, the node is then left out
+     */
+    bool setVector(const node_t aNode, const float_vt& aVec);
+    inline const float* vector(const node_t aNode) const { return &_vectors[static_cast<size_t>(aNode) * _dimensions]; }
+    float similarity(const float* aQuery, const node_t aNode) const;
+    inline std::mutex& lockOf(const node_t aNode) const { return _nodeLocks[aNode % kNoNodeLocks]; }
+    inline size_t maxLinks(const int aLevel) const { return (aLevel == 0) ? 2 * _M : _M; }
+    /**
+     * @brief Draw the level of a new node, P(level >= l) = M^-l
+     */
+    int randomLevel();
+
+    /**
+     * @brief Insert a node whose vector and level are set, can run concurrently for different nodes
+     *
+     * @param aNode the node
+     */
+    void insert(const node_t aNode);
+    /**
+     * @brief Greedy best-first search on one layer (Algorithm 2 of the paper)
+     *
+     * @param aQuery the unit length query vector
+     * @param aEntryPoints the nodes to start from
+     * @param aEf the number of nodes to keep
+     * @param aLevel the layer
+     * @return farther_queue_t the aEf most similar nodes found, the least similar on top
+     */
+    farther_queue_t searchLayer(const float* aQuery, const std::vector<scored_node_t>& aEntryPoints, const size_t aEf, const int aLevel) const;
+    /**
+     * @brief Choose up to aMaxLinks diverse neighbours from the candidates (Algorithm 4 of the paper): a candidate is
+     *        kept if it is more similar to the base node than to every kept neighbour
+     *
+     * @param aCandidates the candidates, with their similarity to the base node
+     * @param aMaxLinks the maximal number of neighbours
+     * @return link_vt the neighbours, most similar first
+     */
+    link_vt selectNeighbours(std::vector<scored_node_t> aCandidates, const size_t aMaxLinks) const;
+    /**
+     * @brief Greedy descent from the entry point down to the layer above aLevel
+     *
+     * @param aQuery the unit length query vector
+     * @param aLevel the layer to stop above
+     * @param aEntryPoint the entry point and its level
+     * @return scored_node_t the most similar node found
+     */
+    scored_node_t descend(const float* aQuery, const int aLevel, const std::pair<node_t, int>& aEntryPoint) const;
+    /**
+     * @brief Get the links of a node on a layer, copied under the lock of the node
+     */
+    link_vt linksOf(const node_t aNode, const int aLevel) const;
+
+  private:
+    static constexpr uint32_t kMagic = 0x57534E48; // "HNSW"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kNoNodeLocks = 4096;    // the links of a node are guarded by lock node % kNoNodeLocks
+
+    const CB* _cb;
+    size_t _M;              // the number of neighbours of a node per layer, twice as many on layer 0
+    size_t _efConstruction; // the size of the dynamic candidate list while inserting
+    size_t _dimensions;
+    size_t _noNodes;
+
+    float_vt _vectors;                      // unit length vectors, _dimensions components per docID
+    std::vector<int> _levels;               // the top layer of every docID, -1 if it is not in the graph
+    std::vector<std::vector<link_vt>> _links; // the links of every docID per layer
+
+    node_t _entryPoint;
+    int _maxLevel; // the level of the entry point, -1 if the graph is empty
+    std::mt19937 _rng;
+    mutable std::mutex _entryMutex;
+    mutable std::array<std::mutex, kNoNodeLocks> _nodeLocks;
+};
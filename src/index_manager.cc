@@ -8,14 +8,35 @@
 IndexManager::IndexManager() :
     _cb(nullptr),
     _docs(nullptr),
-    _idf_map(),
-    _collection_terms(),
+    _idf_vec(),
+    _norm_vec(),
+    _w2vNorm_vec(),
+    _df_vec(),
+    _noLiveDocs(0),
+    _deleted(),
+    _noSegmentDocs(0),
+    _noPendingDeletes(0),
+    _mutex(),
+    _mergeMutex(),
+    _merging(false),
+    _mergeThread(),
+    _docVectors(),
+    _signatures(),
     _invertedIndex(InvertedIndex::getInstance()),
     _tieredIndex(TieredIndex::getInstance()),
     _clusteredIndex(Cluster::getInstance()),
-    _wordEmbeddingsIndex(WordEmbeddings::getInstance())
+    _wordEmbeddingsIndex(WordEmbeddings::getInstance()),
+    _hnswIndex(HnswIndex::getInstance()),
+    _ivfPqIndex(IvfPqIndex::getInstance()),
+    _lshIndex(LshIndex::getInstance())
 {}
 
+IndexManager::~IndexManager() {
+    if (_mergeThread.joinable()) {
+        _mergeThread.join();
+    }
+}
+
 void IndexManager::init(const CB& aControlBlock, doc_mt& aDocMap) {
     if (!_cb) {
         _cb = &aControlBlock;
@@ -23,91 +44,600 @@ void IndexManager::init(const CB& aControlBlock, doc_mt& aDocMap) {
         _invertedIndex.init(aControlBlock);
         _tieredIndex.init(aControlBlock);
         _wordEmbeddingsIndex.init(aControlBlock);
+        _hnswIndex.init(aControlBlock);
+        _ivfPqIndex.init(aControlBlock);
+        _lshIndex.init(aControlBlock);
         _docs = &aDocMap;
 
-        _collection_terms.reserve(_docs->size());
+        if (Util::isSnapshotUsable(aControlBlock)) {
+            this->loadIndex();
+            if (aControlBlock.filterWordEmbeddings()) { _wordEmbeddingsIndex.filter(TermDictionary::getInstance()); } // for the queries
+            this->initHnswIndex();
+            this->initIvfPqIndex();
+            this->quantizeDocumentVectors();
+            this->buildW2VNormVector();
+            this->buildSignatureTable();
+            TRACE("IndexManager: Initialized from the index snapshot");
+            return;
+        }
+
+        if (aControlBlock.filterWordEmbeddings()) { _wordEmbeddingsIndex.filter(TermDictionary::getInstance()); } // the terms got their ids at ingest
         _clusteredIndex.chooseLeaders();
         const sizet_vt& leaders = _clusteredIndex.getLeaders();
         cluster_mt* cluster_out = &_clusteredIndex.getCluster();
-        str_postinglist_mt* postinglist_out = _invertedIndex.getTermPostingMap();
-        str_tierplmap_mt* tieredpostinglist_out = _tieredIndex.getTermTierPostingMap();
+        postinglist_vt* postinglist_out = _invertedIndex.getTermPostingMap();
+        tierplmap_vt* tieredpostinglist_out = _tieredIndex.getTermTierPostingMap();
 
         this->buildIndices(postinglist_out, tieredpostinglist_out, cluster_out, leaders);
+        if (!aControlBlock.indexPath().empty()) {
+            this->saveIndex();
+        }
+        this->initHnswIndex();
+        this->initIvfPqIndex();
+        this->quantizeDocumentVectors();
+        this->buildW2VNormVector();
+        this->buildSignatureTable();
         TRACE("IndexManager: Initialized");
     }
 }
 
-void IndexManager::buildIndices(str_postinglist_mt* postinglist_out, str_tierplmap_mt* tieredpostinglist_out, cluster_mt* cluster_out,
+void IndexManager::buildIndices(postinglist_vt* postinglist_out, tierplmap_vt* tieredpostinglist_out, cluster_mt* cluster_out,
                                 const sizet_vt& leaders) {
-    TRACE("IndexManager: Start building Indices");
-    str_int_mt idf_occs;
+    TRACE("IndexManager: Start building Indices on " + std::to_string(_cb->threads()) + " threads");
+    const TermDictionary& dict = TermDictionary::getInstance(); // the terms got their ids at ingest
+    const size_t V = dict.size();
+    const size_t T = _cb->threads();
+    postinglist_out->resize(V);
+    tieredpostinglist_out->resize(V);
+    _idf_vec.resize(V);
+    _df_vec.resize(V);
+    _noLiveDocs = _docs->size();
+    std::vector<Document*> docs; // ascending by id, the order of the serial build
+    docs.reserve(_docs->size());
+    for (auto& elem : *(_docs)) {
+        docs.push_back(&elem.second);
+    }
+    if (_cb->spimiBudget() > 0) {
+        this->buildPostingListsSpimi(docs, postinglist_out, tieredpostinglist_out);
+    } else {
+        this->buildPostingLists(docs, postinglist_out, tieredpostinglist_out);
+    }
+    RandomProjection::getInstance().init(*_cb, V);
+    Util::parallelFor(docs.size(), T, [&](size_t first, size_t last) {
+        for (size_t d = first; d < last; ++d) {
+            this->buildTfIdfVector(*docs[d]);
+            this->buildWordEmbeddingsVector(*docs[d]);
+            this->buildRandProjVector(*docs[d]);
+        }
+    });
+    _norm_vec.assign(_docs->empty() ? 0 : _docs->rbegin()->first + 1, 0);
     for (const auto& [id, doc] : *(_docs)) {
-        str_int_mt tf_counts;
-        str_float_mt tf_out;
-        sizet_float_mt posting;
-        const string_vt& con = doc.getContent();
-        for (const std::string& term : con) {
-            ++tf_counts[term];
-            if (postinglist_out->find(term) == postinglist_out->end()) { // term not in map
-                posting[id] = 0;                                         // tf has to be set below
-                (*postinglist_out)[term] = PostingList(0, posting);      // idf has to be set below
+        _norm_vec[id] = doc.getNormLength();
+    }
+    _deleted.resize(_norm_vec.size());
+    Util::parallelFor(V, T, [&](size_t first, size_t last) {
+        for (term_id_t termID = first; termID < last; ++termID) { // after compression, so the bounds hold for the stored tfs
+            (*postinglist_out)[termID].computeScoreBounds(_norm_vec);
+        }
+    });
+    sizet_vt clusterIndex(docs.size()); // the leaders are searched in parallel, the clusters are filled in id order
+    Util::parallelFor(docs.size(), T, [&](size_t first, size_t last) {
+        for (size_t d = first; d < last; ++d) {
+            clusterIndex[d] = QueryExecutionEngine::getInstance().searchClusterCosFirstIndex(docs[d], leaders);
+        }
+    });
+    for (size_t d = 0; d < docs.size(); ++d) {
+        cluster_out->at(clusterIndex[d]).push_back(docs[d]->getID());
+    }
+    TRACE("IndexManager: Finished building indices");
+}
+
+void IndexManager::buildPostingLists(const std::vector<Document*>& docs, postinglist_vt* postinglist_out, tierplmap_vt* tieredpostinglist_out) {
+    const size_t V = postinglist_out->size();
+    const size_t T = _cb->threads();
+    // The documents are sharded into contiguous id ranges. Every shard counts its postings per term, the counts are
+    // turned into offsets and every shard writes its postings there, so the lists are sorted by id as in the serial build
+    const size_t noShards = std::max<size_t>(1, std::min(T, docs.size()));
+    const sizet_vt shards = Util::shardBoundaries(docs.size(), noShards);
+    std::vector<uint_vt> shardCounts(noShards, uint_vt(V, 0));
+    Util::parallelFor(noShards, T, [&](size_t first, size_t last) {
+        for (size_t s = first; s < last; ++s) {
+            for (size_t d = shards[s]; d < shards[s + 1]; ++d) {
+                this->buildTermTfVector(*docs[d]);
+                for (const auto& [termID, tf] : docs[d]->getTermTfVector()) { // this loops through the distinct terms of this document
+                    ++shardCounts[s][termID];
+                }
+            }
+        }
+    }, 1);
+    uint_vt idf_occs(V, 0);
+    Util::parallelFor(V, T, [&](size_t first, size_t last) {
+        for (term_id_t termID = first; termID < last; ++termID) {
+            for (size_t s = 0; s < noShards; ++s) { // the count of a shard becomes its offset in the merged list
+                const uint count = shardCounts[s][termID];
+                shardCounts[s][termID] = idf_occs[termID];
+                idf_occs[termID] += count;
+            }
+        }
+    });
+    std::vector<sizet_vt> termIDs(V);
+    std::vector<float_vt> termTfs(V);
+    Util::parallelFor(V, T, [&](size_t first, size_t last) {
+        for (term_id_t termID = first; termID < last; ++termID) {
+            termIDs[termID].resize(idf_occs[termID]);
+            termTfs[termID].resize(idf_occs[termID]);
+        }
+    });
+    Util::parallelFor(noShards, T, [&](size_t first, size_t last) {
+        for (size_t s = first; s < last; ++s) {
+            uint_vt& offsets = shardCounts[s];
+            for (size_t d = shards[s]; d < shards[s + 1]; ++d) {
+                for (const auto& [termID, tf] : docs[d]->getTermTfVector()) {
+                    const uint pos = offsets[termID]++;
+                    termIDs[termID][pos] = docs[d]->getID();
+                    termTfs[termID][pos] = tf;
+                }
             }
         }
-        int maxFreq = Util::getMaxWordFrequency(con);
-        for (const auto& [term, count] : tf_counts) { // this loops through the distinct terms of this document
-            tf_out[term] = Util::calcTf(count, maxFreq);
-            (*postinglist_out)[term].setTf(id, tf_out.at(term));
-            ++idf_occs[term];
+    }, 1);
+    shardCounts.clear();
+    std::atomic<size_t> bytesBefore(0);
+    std::atomic<size_t> bytesAfter(0);
+    Util::parallelFor(V, T, [&](size_t first, size_t last) {
+        std::pair<size_t, size_t> bytes(0, 0);
+        for (term_id_t termID = first; termID < last; ++termID) {
+            this->buildTermPostingLists(termID, termIDs[termID], termTfs[termID], postinglist_out, tieredpostinglist_out, bytes);
+            sizet_vt().swap(termIDs[termID]);
+            float_vt().swap(termTfs[termID]);
         }
-        _docs->at(id).setTermTfMap(tf_out);
+        bytesBefore += bytes.first;
+        bytesAfter += bytes.second;
+    });
+    if (_cb->postingCodec() != kUNCOMPRESSED) {
+        TRACE("IndexManager: Compressed posting lists with " + codecToString(_cb->postingCodec()) + " from " + std::to_string(bytesBefore.load()) +
+              " to " + std::to_string(bytesAfter.load()) + " bytes");
     }
-    const int N = _docs->size();
-    for (const auto& [term, occ] : idf_occs) { // sizeof idf_occs == distinct_terms
-        _idf_map[term] = Util::calcIdf(N, occ);
-        (*postinglist_out)[term].setIdf(_idf_map[term]);
-        (*tieredpostinglist_out)[term] = Util::calculateTiers(_cb->tiers(), (*postinglist_out)[term]);
-        _collection_terms.push_back(term);
+}
+
+void IndexManager::buildPostingListsSpimi(const std::vector<Document*>& docs, postinglist_vt* postinglist_out, tierplmap_vt* tieredpostinglist_out) {
+    SpimiIndexer indexer(_cb->spimiPath(), static_cast<size_t>(_cb->spimiBudget()) << 20);
+    for (Document* doc : docs) {
+        this->buildTermTfVector(*doc);
+        indexer.add(doc->getID(), doc->getTermTfVector());
     }
-    RandomProjection::getInstance().init(*_cb, _collection_terms.size());
-    for (auto& elem : *(_docs)) {
-        this->buildTfIdfVector(elem.second);
-        this->buildWordEmbeddingsVector(elem.second);
-        this->buildRandProjVector(elem.second);
+    TRACE("IndexManager: SPIMI wrote " + std::to_string(indexer.getNoRuns()) + " runs");
+    std::pair<size_t, size_t> bytes(0, 0);
+    indexer.merge(postinglist_out->size(), [&](term_id_t termID, sizet_vt& ids, float_vt& tfs) {
+        this->buildTermPostingLists(termID, ids, tfs, postinglist_out, tieredpostinglist_out, bytes);
+    });
+    if (_cb->postingCodec() != kUNCOMPRESSED) {
+        TRACE("IndexManager: Compressed posting lists with " + codecToString(_cb->postingCodec()) + " from " + std::to_string(bytes.first) +
+              " to " + std::to_string(bytes.second) + " bytes");
     }
-    for (auto& elem : *(_docs)) {
-        Document& doc = elem.second;
-        const size_t index = QueryExecutionEngine::getInstance().searchClusterCosFirstIndex(&doc, leaders);
-        cluster_out->at(index).push_back(doc.getID());
+}
+
+void IndexManager::buildTermPostingLists(const term_id_t termID, const sizet_vt& ids, const float_vt& tfs, postinglist_vt* postinglist_out,
+                                         tierplmap_vt* tieredpostinglist_out, std::pair<size_t, size_t>& bytes_out) {
+    _df_vec[termID] = ids.size();
+    _idf_vec[termID] = Util::calcIdf(_docs->size(), ids.size());
+    PostingList& pl = (*postinglist_out)[termID];
+    pl = PostingList(_idf_vec[termID], ids, tfs);
+    tier_postinglist_mt& tiers = (*tieredpostinglist_out)[termID];
+    tiers = Util::calculateTiers(_cb->tiers(), pl);
+    if (_cb->postingCodec() != kUNCOMPRESSED) {
+        bytes_out.first += pl.byteSize();
+        pl.compress(_cb->postingCodec());
+        bytes_out.second += pl.byteSize();
+        for (auto& [tier, tierPl] : tiers) {
+            bytes_out.first += tierPl.byteSize();
+            tierPl.compress(_cb->postingCodec());
+            bytes_out.second += tierPl.byteSize();
+        }
     }
-    TRACE("IndexManager: Finished building indices");
+}
+
+void IndexManager::removeDeleted(sizet_vt& ids) const {
+    if (_deleted.none()) {
+        return;
+    }
+    ids.erase(std::remove_if(ids.begin(), ids.end(), [this](size_t id) { return this->isDeleted(id); }), ids.end());
+}
+
+void IndexManager::initHnswIndex() {
+    if (_cb->hnswM() == 0) { return; }
+    const std::string lPath = _cb->indexPath().empty() ? "" : _cb->indexPath() + ".hnsw";
+    if (!lPath.empty() && _hnswIndex.load(lPath, *_docs)) {
+        TRACE("IndexManager: Loaded the HNSW graph from " + lPath);
+        return;
+    }
+    _hnswIndex.build(*_docs);
+    if (!lPath.empty()) {
+        _hnswIndex.save(lPath);
+    }
+}
+
+void IndexManager::initIvfPqIndex() {
+    if (_cb->ivfLists() == 0) { return; }
+    const std::string lPath = _cb->indexPath().empty() ? "" : _cb->indexPath() + ".ivfpq";
+    if (!lPath.empty() && _ivfPqIndex.load(lPath)) {
+        TRACE("IndexManager: Loaded the IVF-PQ index from " + lPath);
+        return;
+    }
+    _ivfPqIndex.build(*_docs);
+    if (!lPath.empty()) {
+        _ivfPqIndex.save(lPath);
+    }
+}
+
+void IndexManager::quantizeDocumentVectors() {
+    if (_cb->embeddingPrecision() == kFP32) { return; }
+    _docVectors.reset(_cb->embeddingPrecision(), _docs->empty() ? kWordEmbeddingsDimensions : _docs->begin()->second.getWordEmbeddingsVector().size());
+    for (auto& [id, doc] : *_docs) {
+        _docVectors.set(id, doc.getWordEmbeddingsVector().data());
+        float_vt().swap(doc.getWordEmbeddingsVector());
+    }
+    TRACE("IndexManager: Stored the document vectors in " + precisionToString(_cb->embeddingPrecision()) + " (" + std::to_string(_docVectors.memoryBytes()) + " bytes)");
+}
+
+void IndexManager::buildW2VNormVector() {
+    _w2vNorm_vec.assign(_docs->empty() ? 0 : _docs->rbegin()->first + 1, 0);
+    for (const auto& [id, doc] : *_docs) {
+        this->setW2VNormLength(doc);
+    }
+}
+
+void IndexManager::setW2VNormLength(const Document& doc) {
+    const size_t id = doc.getID();
+    if (id >= _w2vNorm_vec.size()) {
+        _w2vNorm_vec.resize(id + 1, 0);
+    }
+    if (_cb->embeddingPrecision() != kFP32) { // the embeddings are in the quantized table
+        _w2vNorm_vec[id] = static_cast<float>(std::sqrt(std::pow(doc.getNormLength(), 2) + _docVectors.squaredLength(id)));
+    } else {
+        _w2vNorm_vec[id] = static_cast<float>(Util::combinedVectorLength(doc.getTfIdfVector(), doc.getWordEmbeddingsVector()));
+    }
+}
+
+void IndexManager::buildSignatureTable() {
+    _signatures.reset(RandomProjection::getInstance().getDimensions());
+    for (const auto& [id, doc] : *_docs) {
+        _signatures.set(id, doc.getRandProjVec());
+    }
+    TRACE("IndexManager: Packed the random projection vectors (" + std::to_string(_signatures.memoryBytes()) + " bytes)");
+    if (_cb->lshTables() != 0) {
+        _lshIndex.build(*_docs, _signatures);
+    }
+}
+
+void IndexManager::growTerms() {
+    const size_t V = TermDictionary::getInstance().size();
+    if (V <= _df_vec.size() && V <= _invertedIndex.getSegmentPostingMap()->size()) { // the build leaves the segment empty
+        return;
+    }
+    _idf_vec.resize(V, 0);
+    _df_vec.resize(V, 0);
+    _invertedIndex.getTermPostingMap()->resize(V);
+    _invertedIndex.getSegmentPostingMap()->resize(V);
+    tierplmap_vt& tierLists = *_tieredIndex.getTermTierPostingMap();
+    const size_t oldV = tierLists.size();
+    tierLists.resize(V);
+    for (size_t termID = oldV; termID < V; ++termID) { // every term has all (empty) tiers
+        tierLists[termID] = Util::calculateTiers(_cb->tiers(), PostingList());
+    }
+}
+
+size_t IndexManager::addDocument(const std::string& aDocID, const string_vt& aContent) {
+    bool segmentFull = false;
+    size_t id = 0;
+    {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        DocumentManager& docManager = DocumentManager::getInstance();
+        if (docManager.hasDocument(aDocID)) {
+            throw InvalidArgumentException(FLF, "The document " + aDocID + " already exists.");
+        }
+        TermDictionary& dict = TermDictionary::getInstance();
+        for (const std::string& term : aContent) {
+            dict.insert(term);
+        }
+        const size_t oldV = _df_vec.size();
+        this->growTerms();
+
+        Document doc(aDocID, aContent);
+        id = doc.getID();
+        this->buildTermTfVector(doc);
+        ++_noLiveDocs;
+        postinglist_vt& mainLists = *_invertedIndex.getTermPostingMap();
+        postinglist_vt& segmentLists = *_invertedIndex.getSegmentPostingMap();
+        for (const auto& [termID, tf] : doc.getTermTfVector()) {
+            ++_df_vec[termID];
+            segmentLists[termID].setTf(id, tf);
+            if (termID >= oldV) { // a new term is weighted with the live idf of its first document
+                _idf_vec[termID] = this->getLiveIdf(termID);
+                mainLists[termID].setIdf(_idf_vec[termID]);
+            }
+        }
+        this->buildTfIdfVector(doc);
+        this->buildWordEmbeddingsVector(doc);
+        if (_cb->hnswM() != 0) {
+            _hnswIndex.add(id, doc.getWordEmbeddingsVector());
+        }
+        if (_cb->ivfLists() != 0) {
+            _ivfPqIndex.add(id, doc.getWordEmbeddingsVector());
+        }
+        if (_cb->embeddingPrecision() != kFP32) {
+            _docVectors.set(id, doc.getWordEmbeddingsVector().data());
+            float_vt().swap(doc.getWordEmbeddingsVector());
+        }
+        this->setW2VNormLength(doc);
+        this->buildRandProjVector(doc);
+        _signatures.set(id, doc.getRandProjVec());
+        if (_cb->lshTables() != 0) {
+            _lshIndex.add(id, _signatures.row(id));
+        }
+        _norm_vec.resize(id + 1, 0);
+        _norm_vec[id] = doc.getNormLength();
+        _deleted.resize(id + 1);
+        const sizet_vt& leaders = _clusteredIndex.getLeaders();
+        if (!leaders.empty()) {
+            _clusteredIndex.getCluster().at(QueryExecutionEngine::getInstance().searchClusterCosFirstIndex(&doc, leaders)).push_back(id);
+        }
+        docManager.addDoc(std::move(doc));
+        segmentFull = (++_noSegmentDocs >= kMaxSegmentDocs);
+    }
+    if (segmentFull) {
+        this->startMerge();
+    }
+    return id;
+}
+
+void IndexManager::deleteDocument(const std::string& aDocID) {
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    const Document& doc = DocumentManager::getInstance().getDocument(aDocID);
+    const size_t id = doc.getID();
+    if (this->isDeleted(id)) {
+        throw InvalidArgumentException(FLF, "The document " + aDocID + " was already deleted.");
+    }
+    if (id >= _deleted.size()) {
+        _deleted.resize(id + 1);
+    }
+    _deleted[id] = true;
+    _ivfPqIndex.remove(id);
+    _lshIndex.remove(id, _signatures.row(id));
+    for (const auto& [termID, tf] : doc.getTermTfVector()) {
+        --_df_vec[termID];
+    }
+    --_noLiveDocs;
+    ++_noPendingDeletes;
+}
+
+void IndexManager::startMerge() {
+    if (_merging.exchange(true)) {
+        return;
+    }
+    if (_mergeThread.joinable()) {
+        _mergeThread.join();
+    }
+    _mergeThread = std::thread([this]() {
+        try {
+            this->mergeSegment();
+        } catch (const std::exception& e) {
+            TRACE(std::string("IndexManager: The background merge failed: ") + e.what());
+        }
+        _merging = false;
+    });
+}
+
+void IndexManager::mergeSegment() {
+    std::lock_guard<std::mutex> mergeLock(_mergeMutex);
+    termid_vt terms;
+    postinglist_vt mergedLists;
+    tierplmap_vt mergedTiers;
+    size_t lastMergedID = 0;
+    size_t noMergedDocs = 0;
+    size_t noMergedDeletes = 0;
+    { // build the merged lists next to the current ones, queries keep running
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        if (_noSegmentDocs == 0 && _noPendingDeletes == 0) {
+            return;
+        }
+        lastMergedID = _norm_vec.size();
+        noMergedDocs = _noSegmentDocs;
+        noMergedDeletes = _noPendingDeletes;
+        const boost::dynamic_bitset<> deleted = _deleted;
+        const postinglist_vt& mainLists = _invertedIndex.getPostingLists();
+        const postinglist_vt& segmentLists = _invertedIndex.getSegmentPostingLists();
+        sizet_vt ids;
+        float_vt tfs;
+        sizet_vt blockIDs;
+        float_vt blockTfs;
+        auto isDeleted = [&deleted](size_t id) { return id < deleted.size() && deleted[id]; };
+        for (term_id_t termID = 0; termID < mainLists.size(); ++termID) {
+            const PostingList& mainList = mainLists[termID];
+            const bool inSegment = termID < segmentLists.size() && !segmentLists[termID].empty();
+            if (!inSegment && noMergedDeletes == 0) {
+                continue;
+            }
+            ids.clear();
+            tfs.clear();
+            bool purged = false;
+            for (size_t block = 0; block < mainList.getNoBlocks(); ++block) {
+                blockIDs.clear();
+                blockTfs.clear();
+                if (mainList.isCompressed()) {
+                    mainList.decodeBlock(block, blockIDs, blockTfs);
+                } else {
+                    const size_t first = block * Util::kBlockSize;
+                    const size_t last = std::min(mainList.size(), first + Util::kBlockSize);
+                    blockIDs.assign(mainList.getIDs().begin() + first, mainList.getIDs().begin() + last);
+                    blockTfs.assign(mainList.getTfs().begin() + first, mainList.getTfs().begin() + last);
+                }
+                for (size_t i = 0; i < blockIDs.size(); ++i) {
+                    if (noMergedDeletes > 0 && isDeleted(blockIDs[i])) {
+                        purged = true;
+                        continue;
+                    }
+                    ids.push_back(blockIDs[i]);
+                    tfs.push_back(blockTfs[i]);
+                }
+            }
+            if (!inSegment && !purged) {
+                continue;
+            }
+            if (inSegment) { // the segment only holds documents added after all documents of the main list
+                const PostingList& segmentList = segmentLists[termID];
+                for (size_t i = 0; i < segmentList.size(); ++i) {
+                    if (!isDeleted(segmentList.getIDs()[i])) {
+                        ids.push_back(segmentList.getIDs()[i]);
+                        tfs.push_back(segmentList.getTfs()[i]);
+                    }
+                }
+            }
+            PostingList merged(mainList.getIdf(), ids, tfs);
+            tier_postinglist_mt tiers = Util::calculateTiers(_cb->tiers(), merged);
+            if (_cb->postingCodec() != kUNCOMPRESSED) {
+                merged.compress(_cb->postingCodec());
+                for (auto& [tier, tierPl] : tiers) {
+                    tierPl.compress(_cb->postingCodec());
+                }
+            }
+            merged.computeScoreBounds(_norm_vec);
+            terms.push_back(termID);
+            mergedLists.push_back(std::move(merged));
+            mergedTiers.push_back(std::move(tiers));
+        }
+    }
+    { // swap in the merged lists and drop what was merged from the segment
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        postinglist_vt& mainLists = *_invertedIndex.getTermPostingMap();
+        tierplmap_vt& tierLists = *_tieredIndex.getTermTierPostingMap();
+        for (size_t i = 0; i < terms.size(); ++i) {
+            mainLists[terms[i]] = std::move(mergedLists[i]);
+            tierLists[terms[i]] = std::move(mergedTiers[i]);
+        }
+        for (PostingList& segmentList : *_invertedIndex.getSegmentPostingMap()) { // keep the documents added during the merge
+            const sizet_vt& ids = segmentList.getIDs();
+            const size_t noMerged = std::lower_bound(ids.begin(), ids.end(), lastMergedID) - ids.begin();
+            if (noMerged > 0) {
+                segmentList = PostingList(segmentList.getIdf(), sizet_vt(ids.begin() + noMerged, ids.end()),
+                                          float_vt(segmentList.getTfs().begin() + noMerged, segmentList.getTfs().end()));
+            }
+        }
+        if (noMergedDeletes > 0) {
+            for (auto& [leader, members] : _clusteredIndex.getCluster()) {
+                members.erase(std::remove_if(members.begin(), members.end(), [this, leader = leader](size_t id) { return id != leader && this->isDeleted(id); }),
+                              members.end());
+            }
+        }
+        _noSegmentDocs -= noMergedDocs;
+        _noPendingDeletes -= noMergedDeletes;
+    }
+    TRACE("IndexManager: Merged " + std::to_string(noMergedDocs) + " added and " + std::to_string(noMergedDeletes) + " deleted documents into " +
+          std::to_string(terms.size()) + " posting lists");
+}
+
+void IndexManager::saveIndex() {
+    const std::string& lPath = _cb->indexPath();
+    const std::string lTmpPath = lPath + ".tmp";
+    std::ofstream out(lTmpPath, std::ios::binary | std::ios::trunc);
+    if (!out) { throw FileException(FLF, lTmpPath.c_str(), "The index snapshot can not be written."); }
+    out << Util::snapshotHeader(*_cb);
+    TermDictionary::getInstance().save(out);
+    DocumentManager::getInstance().save(out);
+    Util::writeVector(out, _idf_vec);
+    Util::writeVector(out, _norm_vec);
+    for (const PostingList& pl : _invertedIndex.getPostingLists()) {
+        pl.save(out);
+    }
+    for (const tier_postinglist_mt& tiers : _tieredIndex.getPostingLists()) {
+        Util::writeValue<uint64_t>(out, tiers.size());
+        for (const auto& [tier, pl] : tiers) {
+            Util::writeValue<uint64_t>(out, tier);
+            pl.save(out);
+        }
+    }
+    _clusteredIndex.save(out);
+    RandomProjection::getInstance().save(out);
+    out.close();
+    if (!out || std::rename(lTmpPath.c_str(), lPath.c_str()) != 0) {
+        throw FileException(FLF, lPath.c_str(), "The index snapshot can not be written.");
+    }
+    TRACE("IndexManager: Wrote the index snapshot to " + lPath);
+}
+
+void IndexManager::loadIndex() {
+    Util::BinaryReader reader(_cb->indexPath(), false); // every part is copied into the index structures
+    reader.skip(Util::snapshotHeader(*_cb).size()); // checked by Util::isSnapshotUsable
+    TermDictionary::getInstance().load(reader);
+    DocumentManager::getInstance().load(reader);
+    reader.readVector(_idf_vec);
+    reader.readVector(_norm_vec);
+    const size_t V = TermDictionary::getInstance().size();
+    postinglist_vt& postingLists = *_invertedIndex.getTermPostingMap();
+    postingLists.resize(V);
+    for (PostingList& pl : postingLists) {
+        pl.load(reader);
+    }
+    tierplmap_vt& tierPostingLists = *_tieredIndex.getTermTierPostingMap();
+    tierPostingLists.resize(V);
+    for (tier_postinglist_mt& tiers : tierPostingLists) {
+        const uint64_t noTiers = reader.readValue<uint64_t>();
+        for (uint64_t i = 0; i < noTiers; ++i) {
+            const size_t tier = reader.readValue<uint64_t>();
+            tiers[tier].load(reader);
+        }
+    }
+    _clusteredIndex.load(reader);
+    RandomProjection::getInstance().load(*_cb, reader);
+    if (!reader.atEnd()) {
+        throw FileException(FLF, _cb->indexPath().c_str(), "The index snapshot is corrupt.");
+    }
+    _df_vec.resize(V);
+    for (term_id_t termID = 0; termID < V; ++termID) {
+        _df_vec[termID] = postingLists[termID].size();
+    }
+    _noLiveDocs = _docs->size();
+    _deleted.resize(_norm_vec.size());
+}
+
+void IndexManager::buildTermTfVector(Document& doc) {
+    const TermDictionary& dict = TermDictionary::getInstance();
+    const string_vt& con = doc.getContent();
+    termid_vt termIDs;
+    termIDs.reserve(con.size());
+    for (const std::string& term : con) {
+        termIDs.push_back(dict.getID(term));
+    }
+    sparse_vt tf_out;
+    Util::calcTfVector(termIDs, Util::getMaxWordFrequency(con), tf_out);
+    doc.setTermTfVector(tf_out);
 }
 
 void IndexManager::buildWordEmbeddingsVector(Document& doc) {
     float_vt& wevec = doc.getWordEmbeddingsVector();
-    wevec.resize(300);
+    wevec.resize(kWordEmbeddingsDimensions);
     const string_vt& content = doc.getContent();
     // OptionalTodo: test make_unique
     this->getWordEmbeddingsIndex().calcWordEmbeddingsVector(content, wevec);
     doc.setWordEmbeddingsVector(wevec);
 }
 
-void IndexManager::buildTfIdfVector(Document& doc) {
-    float_vt& tivec = doc.getTfIdfVector();
-    tivec.reserve(_collection_terms.size());
-    for (std::string& term : _collection_terms) {
-        str_float_mt& termTfMap = doc.getTermTfMap();
-        if (termTfMap.find(term) != termTfMap.end())
-            tivec.push_back(Util::calcTfIdf(termTfMap.at(term), _idf_map.at(term)));
-        else
-            tivec.push_back(0);
+void IndexManager::buildTfIdfVector(Document& doc, const bool aLiveIdf) {
+    sparse_vt tivec;
+    const sparse_vt& termTfVec = doc.getTermTfVector();
+    tivec.reserve(termTfVec.size());
+    for (const auto& [termID, tf] : termTfVec) {
+        tivec.emplace_back(termID, Util::calcTfIdf(tf, aLiveIdf ? this->getLiveIdf(termID) : _idf_vec[termID]));
     }
     doc.setNormLength(Util::vectorLength(tivec));
     doc.setTfIdfVector(tivec);
 }
 
 void IndexManager::buildRandProjVector(Document& doc) {
-    const boost::dynamic_bitset<>& rand_proj =
-        RandomProjection::getInstance().localitySensitiveHashProjection(doc.getTfIdfVector(),
-                                                                        Util::randomProjectionHash);
+    RandomProjection& rp = RandomProjection::getInstance();
+    const sparse_vt& tivec = doc.getTfIdfVector();
+    const auto known = std::lower_bound(tivec.begin(), tivec.end(), rp.getOrigvectorSize(), [](const auto& a, size_t b) { return a.first < b; });
+    const boost::dynamic_bitset<>& rand_proj = // terms added after the build have no random vector dimension and are left out
+        rp.localitySensitiveHashProjection((known == tivec.end()) ? tivec : sparse_vt(tivec.begin(), known),
+                                           static_cast<bool (*)(const sparse_vt&, const float_vt&)>(Util::randomProjectionHash));
     doc.setRandProjVec(rand_proj);
 }
@@ -2,7 +2,9 @@
  *	@file 	index_manager.hh
  *	@author	Nicolas Wipfler (nwipfler@mail.uni-mannheim.de)
  *	@brief  Implements the index manager which handles the initialization of the vector space model components and
- *          the different indices (Inverted, Tiered, Cluster)
+ *          the different indices (Inverted, Tiered, Cluster). After the build, documents can be added and deleted online:
+ *          added documents go into the mutable segment of the inverted index, deleted documents are tombstoned, and a
+ *          background merge folds both into the immutable main posting lists
  *	@bugs 	Currently no bugs known
  *
  *	@section DESCRIPTION docto_
@@ -18,11 +20,32 @@
 #include "similarity_util.hh"
 #include "cluster.hh"
 #include "document.hh"
+#include "document_manager.hh"
+#include "term_dictionary.hh"
 #include "inverted_index.hh"
 #include "tiered_index.hh"
 #include "random_projection.hh"
 #include "word_embeddings.hh"
+#include "hnsw_index.hh"
+#include "ivfpq_index.hh"
+#include "lsh_index.hh"
+#include "quantized_vectors.hh"
+#include "packed_signatures.hh"
 #include "query_execution_engine.hh"
+#include "serialization_util.hh"
+#include "thread_util.hh"
+#include "spimi_indexer.hh"
+
+#include <atomic>
+#include <boost/dynamic_bitset.hpp>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 class IndexManager {
   private:
@@ -31,9 +54,18 @@ class IndexManager {
     IndexManager(IndexManager&&) = delete;
     IndexManager& operator=(const IndexManager&) = delete;
     IndexManager& operator=(IndexManager&&) = delete;
-    ~IndexManager() = default;
+    ~IndexManager();
 
   private:
+    /**
+     * @brief Write the document table and all indices to the snapshot at aControlBlock.indexPath(). The snapshot is
+     *        written to a temporary file first and then renamed, so processes which mapped the old one are not affected
+     */
+    void saveIndex();
+    /**
+     * @brief Restore the document table and all indices from the snapshot at aControlBlock.indexPath() in a single pass
+     */
+    void loadIndex();
     /**
      * @brief Builds all Indices
      *
@@ -42,31 +74,118 @@ class IndexManager {
      * @param cluster_out the cluster map
      * @param leaders the leaders of the clustered index
      */
-    void buildIndices(str_postinglist_mt* postinglist_out,
-                      str_tierplmap_mt* tieredpostinglist_out,
+    void buildIndices(postinglist_vt* postinglist_out,
+                      tierplmap_vt* tieredpostinglist_out,
                       cluster_mt* cluster_out,
                       const sizet_vt& leaders);
+    /**
+     * @brief Builds the tf vectors of the documents and the inverted and tiered posting lists in memory, on all threads
+     *
+     * @param docs the documents, ascending by id
+     * @param postinglist_out the inverted index postinglists
+     * @param tieredpostinglist_out the tiered index postinglists
+     */
+    void buildPostingLists(const std::vector<Document*>& docs, postinglist_vt* postinglist_out, tierplmap_vt* tieredpostinglist_out);
+    /**
+     * @brief Builds the tf vectors of the documents and the inverted and tiered posting lists with the SPIMI indexer. Only
+     *        the postings which fit into the budget are held uncompressed, the final lists are assembled term by term
+     *
+     * @param docs the documents, ascending by id
+     * @param postinglist_out the inverted index postinglists
+     * @param tieredpostinglist_out the tiered index postinglists
+     */
+    void buildPostingListsSpimi(const std::vector<Document*>& docs, postinglist_vt* postinglist_out, tierplmap_vt* tieredpostinglist_out);
+    /**
+     * @brief Sets the idf of a term and builds its inverted and tiered posting lists, compressed with the configured codec
+     *
+     * @param termID the termID
+     * @param ids the docIDs of the postings, ascending
+     * @param tfs the tfs of the postings
+     * @param postinglist_out the inverted index postinglists
+     * @param tieredpostinglist_out the tiered index postinglists
+     * @param bytes_out adds the bytes of the lists before and after the compression
+     */
+    void buildTermPostingLists(const term_id_t termID, const sizet_vt& ids, const float_vt& tfs, postinglist_vt* postinglist_out,
+                               tierplmap_vt* tieredpostinglist_out, std::pair<size_t, size_t>& bytes_out);
+    /**
+     * @brief Load the HNSW graph from next to the index snapshot, or build it (and write it there). Nothing is done if
+     *        the graph is disabled with an M of 0
+     */
+    void initHnswIndex();
+    /**
+     * @brief Load the IVF-PQ index from next to the index snapshot, or build it (and write it there). Nothing is done if
+     *        the index is disabled with 0 lists
+     */
+    void initIvfPqIndex();
+    /**
+     * @brief Move the word embeddings vectors of the documents into the document vector table if the embedding precision
+     *        is not kFP32. The documents then keep no vector of their own, the snapshot is written before
+     */
+    void quantizeDocumentVectors();
+    /**
+     * @brief Compute the combined norm length of every document, @see getW2VNormLengthVector
+     */
+    void buildW2VNormVector();
+    /**
+     * @brief Store the combined norm length of a document whose vectors are built (and quantized)
+     *
+     * @param doc the document
+     */
+    void setW2VNormLength(const Document& doc);
+    /**
+     * @brief Pack the random projection vector of every document into the signature table, @see getSignatures, and
+     *        hash the signatures into the LSH index unless it is disabled
+     */
+    void buildSignatureTable();
+    /**
+     * @brief Grow the term indexed structures to the size of the TermDictionary, after an added document brought new terms
+     */
+    void growTerms();
+    /**
+     * @brief Run @see mergeSegment on a background thread, if no merge is running
+     */
+    void startMerge();
 
   public:
     /**
-     * @brief Get the idf map
+     * @brief Get the idf of every term, indexed by termID
+     *
+     * @return const float_vt& the idf vector
+     */
+    inline const float_vt& getIdfVector() { return _idf_vec; }
+    /**
+     * @brief Get the norm length of every document, indexed by docID
      *
-     * @return const str_float_mt& the idf map
+     * @return const float_vt& the norm lengths
      */
-    inline const str_float_mt& getIdfMap() { return _idf_map; }
+    inline const float_vt& getNormLengthVector() { return _norm_vec; }
     /**
-     * @brief Get the distinct terms in the collection
+     * @brief Get the length of the tf-idf vector with the word embeddings vector appended of every document, indexed by
+     *        docID. It is computed from the document vector table if the embedding precision is not kFP32
+     *
+     * @return const float_vt& the combined norm lengths
+     */
+    inline const float_vt& getW2VNormLengthVector() { return _w2vNorm_vec; }
+    /**
+     * @brief Get the distinct terms in the collection, the position of a term is its id
      *
      * @return const string_vt& the collection terms
      */
-    inline const string_vt& getCollectionTerms() { return _collection_terms; }
+    inline const string_vt& getCollectionTerms() { return TermDictionary::getInstance().getTerms(); }
     /**
      * @brief Get the inverse document frequency for the term
      *
+     * @param aTermID the id of the term
+     * @return const float the inverse document frequency
+     */
+    inline float getIdf(const term_id_t aTermID) { return _idf_vec.at(aTermID); }
+    /**
+     * @brief Get the inverse document frequency for the term, resolves the term with the TermDictionary
+     *
      * @param term the term
      * @return const float the inverse document frequency
      */
-    inline float getIdf(std::string term) { return _idf_map.at(term); }
+    inline float getIdf(const std::string& term) { return _idf_vec.at(TermDictionary::getInstance().getID(term)); }
 
     /**
      * @brief Get the inverted index object
@@ -92,13 +211,100 @@ class IndexManager {
      * @return const WordEmbeddings& the word embeddings index
      */
     inline WordEmbeddings& getWordEmbeddingsIndex() { return _wordEmbeddingsIndex; }
+    /**
+     * @brief Get the HNSW graph over the word embeddings vectors of the documents
+     *
+     * @return const HnswIndex& the HNSW index
+     */
+    inline const HnswIndex& getHnswIndex() const { return _hnswIndex; }
+    /**
+     * @brief Get the IVF-PQ index over the word embeddings vectors of the documents
+     *
+     * @return const IvfPqIndex& the IVF-PQ index
+     */
+    inline const IvfPqIndex& getIvfPqIndex() const { return _ivfPqIndex; }
+    /**
+     * @brief Get the banded LSH index over the random projection vectors of the documents
+     *
+     * @return const LshIndex& the LSH index
+     */
+    inline const LshIndex& getLshIndex() const { return _lshIndex; }
+    /**
+     * @brief Get the word embeddings vectors of the documents in the embedding precision, indexed by docID. Empty for
+     *        kFP32, then every document holds its own vector
+     *
+     * @return const QuantizedVectors& the document vector table
+     */
+    inline const QuantizedVectors& getDocumentVectors() const { return _docVectors; }
+    /**
+     * @brief Get the random projection vectors of the documents packed into 64 bit words, indexed by docID
+     *
+     * @return const PackedSignatures& the signature table
+     */
+    inline const PackedSignatures& getSignatures() const { return _signatures; }
+
+    /**
+     * @brief Get the mutex guarding the indices, queries hold it shared and updates hold it exclusively
+     *
+     * @return std::shared_mutex& the mutex
+     */
+    inline std::shared_mutex& getMutex() const { return _mutex; }
+    /**
+     * @brief Get the idf of a term from the live collection statistics, so deleted documents do not count. A term
+     *        without live documents carries no weight
+     *
+     * @param aTermID the id of the term
+     * @return float the inverse document frequency
+     */
+    inline float getLiveIdf(const term_id_t aTermID) const { return (_df_vec[aTermID] == 0) ? 0 : Util::calcIdf(_noLiveDocs, _df_vec[aTermID]); }
+    /**
+     * @brief Check if a document was deleted
+     *
+     * @param aID the (numeric) id of the document
+     * @return true if the document was deleted
+     */
+    inline bool isDeleted(const size_t aID) const { return aID < _deleted.size() && _deleted[aID]; }
+    /**
+     * @brief Remove the deleted documents from a list of ids
+     *
+     * @param ids the ids
+     */
+    void removeDeleted(sizet_vt& ids) const;
+    /**
+     * @brief Add a document to the mutable segment. It can be found by all search modes right away. A merge is started in
+     *        the background once the segment holds kMaxSegmentDocs documents
+     *
+     * @param aDocID the (string) id of the document
+     * @param aContent the preprocessed terms of the document
+     * @return size_t the (numeric) id of the document
+     */
+    size_t addDocument(const std::string& aDocID, const string_vt& aContent);
+    /**
+     * @brief Delete a document by setting its tombstone. Its postings are removed by the next merge
+     *
+     * @param aDocID the (string) id of the document
+     */
+    void deleteDocument(const std::string& aDocID);
+    /**
+     * @brief Merge the mutable segment into the main posting lists and drop the postings of deleted documents. The new
+     *        lists are built while queries keep running, only swapping them in blocks the queries
+     */
+    void mergeSegment();
 
     /**
-     * @brief Build the tf idf vector for a document
+     * @brief Builds the (termID, tf) vector of a document
+     *
+     * @param doc the document
+     */
+    void buildTermTfVector(Document& doc);
+    /**
+     * @brief Build the sparse tf idf vector for a document
      * 
      * @param doc the document
+     * @param aLiveIdf weight the terms with the live idf (@see getLiveIdf) like a query, instead of the idf of their
+     *        posting lists like an indexed document, so its norm matches the scores of its postings
      */
-    void buildTfIdfVector(Document& doc);
+    void buildTfIdfVector(Document& doc, const bool aLiveIdf = false);
     /**
      * @brief Build the random projection vector for a document
      * 
@@ -128,15 +334,37 @@ class IndexManager {
      */
     void init(const CB& aControlBlock, doc_mt& aDocMap);
 
+  public:
+    static constexpr size_t kMaxSegmentDocs = 1024; // the size of the mutable segment which starts a merge
+    static constexpr size_t kWordEmbeddingsDimensions = 300; // the length of the word embeddings vector of a document
+
   private:
     const CB* _cb;
     doc_mt* _docs;
 
-    str_float_mt _idf_map;
-    string_vt _collection_terms; // does not have to be sorted
+    float_vt _idf_vec; // indexed by termID
+    float_vt _norm_vec; // indexed by docID
+    float_vt _w2vNorm_vec; // indexed by docID, the lengths of the combined tf-idf and word embeddings vectors
+
+    uint_vt _df_vec;                  // indexed by termID, the number of live documents which contain the term
+    size_t _noLiveDocs;               // the number of documents which are not deleted
+    boost::dynamic_bitset<> _deleted; // indexed by docID, the tombstones
+    size_t _noSegmentDocs;            // the number of documents in the mutable segment
+    size_t _noPendingDeletes;         // the number of deleted documents whose postings were not merged away yet
+
+    mutable std::shared_mutex _mutex; // guards the indices against the updates and the swap of a merge
+    std::mutex _mergeMutex;           // only one merge at a time
+    std::atomic<bool> _merging;
+    std::thread _mergeThread;
+
+    QuantizedVectors _docVectors; // @see quantizeDocumentVectors
+    PackedSignatures _signatures; // @see buildSignatureTable
 
     InvertedIndex& _invertedIndex;
     TieredIndex& _tieredIndex;
     Cluster& _clusteredIndex;
     WordEmbeddings& _wordEmbeddingsIndex;
+    HnswIndex& _hnswIndex;
+    IvfPqIndex& _ivfPqIndex;
+    LshIndex& _lshIndex;
 };
@@ -6,7 +6,8 @@
  */
 InvertedIndex::InvertedIndex() : 
     _cb(nullptr),
-    _term_posting_map()
+    _term_posting_map(),
+    _segment_posting_map()
 {}
 
 void InvertedIndex::init(const control_block_t& aControlBlock) {
@@ -16,59 +17,67 @@ void InvertedIndex::init(const control_block_t& aControlBlock) {
     }
 }
 
-bool InvertedIndex::insert(const std::string& aTerm, const PostingList& aPostingList) {
-    return _term_posting_map.insert(std::make_pair(aTerm, aPostingList)).second; // copy constructor required
-}
-
-posting_map_iter_t InvertedIndex::find(const std::string& aKey) {
-    return _term_posting_map.find(aKey);
-}
-
-void InvertedIndex::erase(const std::string& aKey) {
-    _term_posting_map.erase(aKey);
+bool InvertedIndex::insert(const term_id_t aTermID, const PostingList& aPostingList) {
+    if (aTermID >= _term_posting_map.size()) {
+        _term_posting_map.resize(aTermID + 1);
+    } else if (!_term_posting_map[aTermID].empty()) {
+        return false;
+    }
+    _term_posting_map[aTermID] = PostingList(aPostingList);
+    return true;
 }
 
-void InvertedIndex::erase(const posting_map_iter_t aIterator) {
-    _term_posting_map.erase(aIterator);
+const PostingList& InvertedIndex::getPostingList(const term_id_t aTermID) const {
+    if (aTermID < _term_posting_map.size())
+        return _term_posting_map[aTermID];
+    else
+        throw InvalidArgumentException(FLF, "The term id " + std::to_string(aTermID) + " does not appear in the document collection.");
 }
 
 const PostingList& InvertedIndex::getPostingList(const std::string& aTerm) const {
-    if (_term_posting_map.find(aTerm) != _term_posting_map.end())
-        return _term_posting_map.at(aTerm);
+    const term_id_t lTermID = TermDictionary::getInstance().getID(aTerm);
+    if (lTermID < _term_posting_map.size()) // kNoTerm is always out of range
+        return _term_posting_map[lTermID];
     else
         throw InvalidArgumentException(FLF, "The term " + aTerm + " does not appear in the document collection.");
 }
 
 size_t InvertedIndex::getNoDocs(const std::string& aTerm) {
-    if (_term_posting_map.find(aTerm) != _term_posting_map.end())
-        return _term_posting_map.at(aTerm).getPosting().size();
-    else
-        throw InvalidArgumentException(FLF, "The term " + aTerm + " does not appear in the document collection.");
+    return this->getPostingList(aTerm).size();
 }
 
-sizet_vt InvertedIndex::getDocIDList(const string_vt& terms) const {
+sizet_vt InvertedIndex::getDocIDList(const termid_vt& termIDs) const {
     sizet_vt qids;
 
-    std::vector<sizet_vt> vecs;
-    vecs.resize(terms.size());
-    for (size_t i = 0; i < terms.size(); ++i) {
-        try {
-            const sizet_vt& ids = this->getPostingList(terms.at(i)).getIDs();
-            sizet_vt& termIDs = vecs.at(i);
-            termIDs.insert(termIDs.end(), ids.begin(), ids.end());
-            vecs.at(i) = termIDs;
-        } catch (const InvalidArgumentException& e) { continue; /* One of the (query) terms does not appear in the document collection. */ }
+    std::vector<const sizet_vt*> lists; // the posting arrays are merged in place, nothing is copied
+    std::vector<sizet_vt> buffers(termIDs.size()); // decoded ids of compressed posting lists
+    lists.reserve(termIDs.size());
+    for (size_t i = 0; i < termIDs.size(); ++i) {
+        if (termIDs[i] < _term_posting_map.size()) { lists.push_back(&_term_posting_map[termIDs[i]].getIDs(buffers[i])); }
+    }
+    for (const term_id_t termID : termIDs) {
+        if (termID < _segment_posting_map.size() && !_segment_posting_map[termID].empty()) { lists.push_back(&_segment_posting_map[termID].getIDs()); }
+    }
+    Util::orPostingLists(lists, qids);
+    return qids;
+}
+
+sizet_vt InvertedIndex::getSegmentDocIDList(const termid_vt& termIDs) const {
+    sizet_vt qids;
+    std::vector<const sizet_vt*> lists;
+    for (const term_id_t termID : termIDs) {
+        if (termID < _segment_posting_map.size() && !_segment_posting_map[termID].empty()) { lists.push_back(&_segment_posting_map[termID].getIDs()); }
     }
-    Util::orPostingLists(vecs, qids);
+    Util::orPostingLists(lists, qids);
     return qids;
 }
 
 std::ostream& operator<<(std::ostream& strm, const InvertedIndex& ii) {
     std::string sepout = "\n";
     const auto& tpm = ii.getPostingLists();
-    for (auto ito = tpm.begin(); ito != tpm.end(); ++ito) {
-        std::string term = ito->first;
-        const PostingList& pl = ito->second;
+    for (size_t termID = 0; termID < tpm.size(); ++termID) {
+        const std::string& term = TermDictionary::getInstance().getTerm(termID);
+        const PostingList& pl = tpm[termID];
         strm << term << " -> " << pl << sepout;
     }
     return strm;
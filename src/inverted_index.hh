@@ -2,7 +2,8 @@
  *	@file 	inverted_index.hh
  *	@author	Nicolas Wipfler (nwipfler@mail.uni-mannheim.de)
  *	@brief  Implements the inverted index represented by a map of string -> PostingList
- *          The PostingList contains the idf and posting for a term
+ *          The PostingList contains the idf and posting for a term. Documents added after the build go into a
+ *          small mutable segment of uncompressed posting lists, which is merged into the main lists by the IndexManager
  *	@bugs 	Currently no bugs known
  *
  *	@section DESCRIPTION doc_to
@@ -14,6 +15,7 @@
 #include "trace.hh"
 #include "document.hh"
 #include "posting_list.hh"
+#include "term_dictionary.hh"
 #include "ir_util.hh"
 
 #include <map>
@@ -32,33 +34,14 @@ class InvertedIndex {
 
   private:
     /**
-     * @brief Insert an empty posting list for aTerm, if this term is not in the inverted index yet
+     * @brief Insert aPostingList for aTermID, if this term has no posting list yet
      *
-     * @param aTerm the term to insert
+     * @param aTermID the id of the term to insert
      * @param aPostingList the posting list to insert
      * @return true if insertion was successful
      * @return false if insertion failed
      */
-    bool insert(const std::string& aTerm, const PostingList& aPostingList);
-    /**
-     * @brief Find a postingList with aKey and return an iterator
-     *
-     * @param aKey the term to find in the map
-     * @return posting_map_iter_t the postingList for aKey (the term)
-     */
-    posting_map_iter_t find(const std::string& aKey);
-    /**
-     * @brief Erase the postingList of aKey
-     *
-     * @param aKey the term to erase
-     */
-    void erase(const std::string& aKey);
-    /**
-     * @brief Erase the postingList for aIterator
-     *
-     * @param aIterator the iterator to erase with
-     */
-    void erase(const posting_map_iter_t aIterator);
+    bool insert(const term_id_t aTermID, const PostingList& aPostingList);
 
     /**
      * @brief Get the InvertedIndex Singleton instance.
@@ -78,19 +61,31 @@ class InvertedIndex {
     void init(const control_block_t& aControlBlock);
 
     /**
-     * @brief Get the term posting map
+     * @brief Get the term posting lists
      * 
-     * @return str_postinglist_mt* the term posting map
+     * @return postinglist_vt* the posting lists, indexed by termID
+     */
+    inline postinglist_vt* getTermPostingMap() { return &_term_posting_map; }
+    /**
+     * @brief Get the posting lists of the mutable segment
+     *
+     * @return postinglist_vt* the segment posting lists, indexed by termID
      */
-    inline str_postinglist_mt* getTermPostingMap() { return &_term_posting_map; }
+    inline postinglist_vt* getSegmentPostingMap() { return &_segment_posting_map; }
 
   public:
     /**
      * @brief Get the posting lists
      *
-     * @return const str_postinglist_mt& the posting lists
+     * @return const postinglist_vt& the posting lists, indexed by termID
      */
-    inline const str_postinglist_mt& getPostingLists() const { return _term_posting_map; }
+    inline const postinglist_vt& getPostingLists() const { return _term_posting_map; }
+    /**
+     * @brief Get the posting lists of the mutable segment, which hold the documents added since the last merge
+     *
+     * @return const postinglist_vt& the segment posting lists, indexed by termID (may be shorter than the main lists)
+     */
+    inline const postinglist_vt& getSegmentPostingLists() const { return _segment_posting_map; }
     /**
      * @brief Get the size of the dictionary
      *
@@ -101,6 +96,13 @@ class InvertedIndex {
     /**
      * @brief Get the posting list for the given term
      *
+     * @param aTermID the id of the term for getting the posting list
+     * @return const PostingList& the posting list
+     */
+    const PostingList& getPostingList(const term_id_t aTermID) const;
+    /**
+     * @brief Get the posting list for the given term, resolves the term with the TermDictionary
+     *
      * @param term the term for getting the posting list
      * @return const PostingList& the posting list
      */
@@ -113,13 +115,20 @@ class InvertedIndex {
      */
     size_t getNoDocs(const std::string& aTerm);
     /**
-     * @brief Get the doc id list for a given term (so the list of all 
-     *        documents where this term appears)
+     * @brief Get the doc id list for the given terms (so the list of all 
+     *        documents where at least one of these terms appears), including the mutable segment
      * 
-     * @param terms the term to get the ids for
+     * @param termIDs the ids of the terms to get the doc ids for
+     * @return sizet_vt the list of ids
+     */
+    sizet_vt getDocIDList(const termid_vt& termIDs) const;
+    /**
+     * @brief Get the doc id list for the given terms of the mutable segment only
+     *
+     * @param termIDs the ids of the terms to get the doc ids for
      * @return sizet_vt the list of ids
      */
-    sizet_vt getDocIDList(const string_vt& terms) const;
+    sizet_vt getSegmentDocIDList(const termid_vt& termIDs) const;
     
     /**
      * @brief override the <<operator for inverted index
@@ -133,5 +142,6 @@ class InvertedIndex {
   private:
     const CB* _cb;
 
-    str_postinglist_mt _term_posting_map; // term, PostingList: [("Frodo", <PostingListObj>), ...]
+    postinglist_vt _term_posting_map;    // indexed by termID: [<PostingListObj of "Frodo">, ...]
+    postinglist_vt _segment_posting_map; // indexed by termID, the postings of the documents added since the last merge
 };
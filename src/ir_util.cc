@@ -14,6 +14,16 @@ namespace Util {
         return tf * idf;
     }
 
+    void calcTfVector(termid_vt& aTermIDs, const int aMaxFreq, sparse_vt& aOut) {
+        aOut.clear();
+        std::sort(aTermIDs.begin(), aTermIDs.end());
+        for (auto it = aTermIDs.begin(); it != aTermIDs.end();) { // count the runs of equal ids
+            auto runEnd = std::upper_bound(it, aTermIDs.end(), *it);
+            aOut.emplace_back(*it, calcTf(std::distance(it, runEnd), aMaxFreq));
+            it = runEnd;
+        }
+    }
+
     std::string stemPorter(const std::string& sentence) {
         std::istringstream iss(sentence);
         std::ostringstream os;
@@ -31,30 +41,38 @@ namespace Util {
     }
 
     std::map<size_t, PostingList> calculateTiers(const size_t aNumTiers, const PostingList& aPostingList) {
-        const sizet_float_mt& aPosting = aPostingList.getPosting();
+        const sizet_vt& ids = aPostingList.getIDs();
+        const float_vt& tfs = aPostingList.getTfs();
         const float idf = aPostingList.getIdf();
         std::map<size_t, PostingList> outputMap;
 
         std::vector<std::pair<size_t, float>> vec; // vector of <id, tf> pairs, will be sorted descending by tf
-        for (auto it = aPosting.begin(); it != aPosting.end(); ++it) {
-            vec.push_back(*it);
+        vec.reserve(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            vec.emplace_back(ids[i], tfs[i]);
         }
         std::sort(vec.begin(), vec.end(), [](auto& a, auto& b) { return a.second > b.second; }); // desc
 
-        size_t size = aPosting.size();
+        size_t size = ids.size();
         uint boundary = std::floor((double)size / aNumTiers);
+        auto next = vec.begin();
         for (size_t tier = 0; tier < aNumTiers; ++tier) {
-            sizet_float_mt posting;
-            if (size < aNumTiers && !vec.empty()) {
-                posting.insert(Util::pop_front(vec));
+            auto tierEnd = next;
+            if (size < aNumTiers) {
+                tierEnd = (next != vec.end()) ? next + 1 : next;
             } else {
-                boundary = (tier == (aNumTiers - 1)) ? vec.size() : boundary;
-                for (size_t i = 0; i < boundary; ++i) {
-                    posting.insert(Util::pop_front(vec));
-                }
+                tierEnd = (tier == (aNumTiers - 1)) ? vec.end() : next + boundary;
+            }
+            std::sort(next, tierEnd, [](auto& a, auto& b) { return a.first < b.first; }); // the posting of a tier is sorted by id
+            sizet_vt tierIDs;
+            float_vt tierTfs;
+            tierIDs.reserve(std::distance(next, tierEnd));
+            tierTfs.reserve(std::distance(next, tierEnd));
+            for (; next != tierEnd; ++next) {
+                tierIDs.push_back(next->first);
+                tierTfs.push_back(next->second);
             }
-            PostingList postinglist(idf, posting);
-            outputMap.insert(std::make_pair(tier, postinglist));
+            outputMap.emplace(tier, PostingList(idf, tierIDs, tierTfs));
         }
         return outputMap;
     }
@@ -92,6 +110,28 @@ namespace Util {
         }
     }
 
+    void orPostingLists(const std::vector<const sizet_vt*>& aLists, sizet_vt& out) {
+        out.clear();
+        using cursor_t = std::pair<sizet_vt::const_iterator, sizet_vt::const_iterator>; // current position, end
+        auto greater = [](const cursor_t& a, const cursor_t& b) { return *a.first > *b.first; };
+        std::vector<cursor_t> heap; // min heap over the current id of every list
+        heap.reserve(aLists.size());
+        for (const sizet_vt* list : aLists) {
+            if (!list->empty()) { heap.emplace_back(list->begin(), list->end()); }
+        }
+        std::make_heap(heap.begin(), heap.end(), greater);
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            cursor_t& cursor = heap.back();
+            if (out.empty() || out.back() != *cursor.first) { out.push_back(*cursor.first); }
+            if (++cursor.first != cursor.second) {
+                std::push_heap(heap.begin(), heap.end(), greater);
+            } else {
+                heap.pop_back();
+            }
+        }
+    }
+
     void orPostingLists(std::vector<sizet_vt>& vecs, sizet_vt& out) {
         out.clear();
         if (vecs.size() > 1) {
@@ -39,6 +39,15 @@ namespace Util {
      */
     float calcIdf(const float N, const float docs); 
 
+    /**
+     * @brief Calculates the (termID, tf) vector of a document from the ids of its terms
+     *
+     * @param aTermIDs the termIDs of the document content (with duplicates), gets sorted
+     * @param aMaxFreq the frequency of the most frequent term in the document
+     * @param aOut the (termID, tf) vector, sorted by termID
+     */
+    void calcTfVector(termid_vt& aTermIDs, const int aMaxFreq, sparse_vt& aOut);
+
     /**
      * @brief Calculates the tf-idf value
      *
@@ -115,4 +124,12 @@ namespace Util {
      * @param out the result vector
      */
     void orPostingLists(std::vector<sizet_vt>& vecs, sizet_vt& out);
+    /**
+     * @brief Merge sorted lists by taking the union and writing to out. The lists are streamed
+     *        with a k-way merge and are neither copied nor modified
+     * 
+     * @param aLists pointers to the posting lists, each sorted ascending
+     * @param out the result vector, sorted ascending without duplicates
+     */
+    void orPostingLists(const std::vector<const sizet_vt*>& aLists, sizet_vt& out);
 }
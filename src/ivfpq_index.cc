@@ -0,0 +1,281 @@
+#include "ivfpq_index.hh"
+
+/**
+ * @brief Construct a new Ivf Pq Index:: Ivf Pq Index object
+ *
+ */
+IvfPqIndex::IvfPqIndex() :
+    _cb(nullptr),
+    _noLists(0),
+    _noSubspaces(0),
+    _noCodes(0),
+    _dimensions(0),
+    _noEntries(0),
+    _rng(),
+    _centroids(),
+    _codebooks(),
+    _listIDs(),
+    _listCodes(),
+    _listOf()
+{}
+
+void IvfPqIndex::init(const CB& aControlBlock) {
+    if (!_cb) {
+        _cb = &aControlBlock;
+        _noLists = _cb->ivfLists();
+        _noSubspaces = _cb->ivfSubspaces();
+        _rng.seed(_cb->seed());
+        TRACE("IvfPqIndex: Initialized");
+    }
+}
+
+bool IvfPqIndex::normalize(const float_vt& aVec, float_vt& aOut) const {
+    if (aVec.size() < _dimensions) { return false; }
+    double lLength = Util::squaredNorm(aVec.data(), _dimensions);
+    if (lLength == 0) { return false; }
+    lLength = std::sqrt(lLength);
+    aOut.resize(_dimensions);
+    for (size_t i = 0; i < _dimensions; ++i) {
+        aOut[i] = static_cast<float>(aVec[i] / lLength);
+    }
+    return true;
+}
+
+uint32_t IvfPqIndex::nearest(const float* aPoint, const float* aCentroids, const size_t aK, const size_t aDimensions) {
+    uint32_t lBest = 0;
+    double lBestDist = std::numeric_limits<double>::max();
+    for (size_t c = 0; c < aK; ++c) {
+        const double lDist = Util::squaredL2(aPoint, &aCentroids[c * aDimensions], aDimensions);
+        if (lDist < lBestDist) {
+            lBestDist = lDist;
+            lBest = static_cast<uint32_t>(c);
+        }
+    }
+    return lBest;
+}
+
+void IvfPqIndex::kMeans(const float_vt& aData, const size_t aNoPoints, const size_t aDimensions, const size_t aK, float_vt& aCentroids) {
+    sizet_vt lOrder(aNoPoints);
+    std::iota(lOrder.begin(), lOrder.end(), 0);
+    std::shuffle(lOrder.begin(), lOrder.end(), _rng);
+    aCentroids.resize(aK * aDimensions);
+    for (size_t c = 0; c < aK; ++c) {
+        std::copy_n(&aData[lOrder[c] * aDimensions], aDimensions, &aCentroids[c * aDimensions]);
+    }
+    std::vector<uint32_t> lAssignment(aNoPoints);
+    std::uniform_int_distribution<size_t> lRandomPoint(0, aNoPoints - 1);
+    for (size_t iteration = 0; iteration < kIterations; ++iteration) {
+        Util::parallelFor(aNoPoints, _cb->threads(), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                lAssignment[i] = nearest(&aData[i * aDimensions], aCentroids.data(), aK, aDimensions);
+            }
+        });
+        std::vector<double> lSums(aK * aDimensions, 0);
+        sizet_vt lCounts(aK, 0);
+        for (size_t i = 0; i < aNoPoints; ++i) {
+            ++lCounts[lAssignment[i]];
+            for (size_t j = 0; j < aDimensions; ++j) {
+                lSums[lAssignment[i] * aDimensions + j] += aData[i * aDimensions + j];
+            }
+        }
+        for (size_t c = 0; c < aK; ++c) {
+            if (lCounts[c] == 0) { // restart an empty cluster at a random point
+                std::copy_n(&aData[lRandomPoint(_rng) * aDimensions], aDimensions, &aCentroids[c * aDimensions]);
+                continue;
+            }
+            for (size_t j = 0; j < aDimensions; ++j) {
+                aCentroids[c * aDimensions + j] = static_cast<float>(lSums[c * aDimensions + j] / lCounts[c]);
+            }
+        }
+    }
+}
+
+void IvfPqIndex::build(const doc_mt& aDocs) {
+    _dimensions = aDocs.empty() ? 0 : aDocs.begin()->second.getWordEmbeddingsVector().size();
+    sizet_vt lIDs;
+    float_vt lData;
+    float_vt lUnit;
+    for (const auto& [id, doc] : aDocs) {
+        if (this->normalize(doc.getWordEmbeddingsVector(), lUnit)) {
+            lIDs.push_back(id);
+            lData.insert(lData.end(), lUnit.begin(), lUnit.end());
+        }
+    }
+    const size_t N = lIDs.size();
+    if (N == 0) { return; }
+    if (_dimensions % _noSubspaces != 0) {
+        throw InvalidArgumentException(FLF, "The number of subspaces must divide the " + std::to_string(_dimensions) + " dimensions.");
+    }
+    _noLists = std::min(_noLists, N);
+    this->kMeans(lData, N, _dimensions, _noLists, _centroids);
+
+    float_vt lResiduals(lData.size());
+    Util::parallelFor(N, _cb->threads(), [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const float* lCentroid = &_centroids[nearest(&lData[i * _dimensions], _centroids.data(), _noLists, _dimensions) * _dimensions];
+            for (size_t j = 0; j < _dimensions; ++j) {
+                lResiduals[i * _dimensions + j] = lData[i * _dimensions + j] - lCentroid[j];
+            }
+        }
+    });
+    const size_t lSubDimensions = _dimensions / _noSubspaces;
+    _noCodes = std::min(kMaxCodes, N);
+    _codebooks.assign(_noSubspaces * kMaxCodes * lSubDimensions, 0);
+    float_vt lSubData(N * lSubDimensions);
+    float_vt lCodebook;
+    for (size_t s = 0; s < _noSubspaces; ++s) {
+        for (size_t i = 0; i < N; ++i) {
+            std::copy_n(&lResiduals[i * _dimensions + s * lSubDimensions], lSubDimensions, &lSubData[i * lSubDimensions]);
+        }
+        this->kMeans(lSubData, N, lSubDimensions, _noCodes, lCodebook);
+        std::copy(lCodebook.begin(), lCodebook.end(), _codebooks.begin() + s * kMaxCodes * lSubDimensions);
+    }
+
+    _listIDs.assign(_noLists, id_vt());
+    _listCodes.assign(_noLists, code_vt());
+    for (size_t i = 0; i < N; ++i) {
+        this->encode(lIDs[i], &lData[i * _dimensions]);
+    }
+    TRACE("IvfPqIndex: Encoded " + std::to_string(_noEntries) + " documents into " + std::to_string(_noLists) + " lists with " + std::to_string(_noSubspaces) + " bytes each (" + std::to_string(this->memoryBytes()) + " bytes)");
+}
+
+void IvfPqIndex::encode(const size_t aDocID, const float* aVec) {
+    const uint32_t lList = nearest(aVec, _centroids.data(), _noLists, _dimensions);
+    const float* lCentroid = &_centroids[lList * _dimensions];
+    const size_t lSubDimensions = _dimensions / _noSubspaces;
+    float_vt lResidual(lSubDimensions);
+    code_vt& lCodes = _listCodes[lList];
+    for (size_t s = 0; s < _noSubspaces; ++s) {
+        for (size_t j = 0; j < lSubDimensions; ++j) {
+            lResidual[j] = aVec[s * lSubDimensions + j] - lCentroid[s * lSubDimensions + j];
+        }
+        lCodes.push_back(static_cast<uint8_t>(nearest(lResidual.data(), &_codebooks[s * kMaxCodes * lSubDimensions], _noCodes, lSubDimensions)));
+    }
+    _listIDs[lList].push_back(static_cast<uint32_t>(aDocID));
+    if (aDocID >= _listOf.size()) {
+        _listOf.resize(aDocID + 1, kNoList);
+    }
+    _listOf[aDocID] = lList;
+    ++_noEntries;
+}
+
+void IvfPqIndex::add(const size_t aDocID, const float_vt& aVec) {
+    float_vt lUnit;
+    if (_centroids.empty() || !this->normalize(aVec, lUnit)) { return; } // nothing to encode with before the first build
+    this->encode(aDocID, lUnit.data());
+}
+
+void IvfPqIndex::remove(const size_t aDocID) {
+    if (aDocID >= _listOf.size() || _listOf[aDocID] == kNoList) { return; }
+    id_vt& lIDs = _listIDs[_listOf[aDocID]];
+    code_vt& lCodes = _listCodes[_listOf[aDocID]];
+    const size_t lPos = std::find(lIDs.begin(), lIDs.end(), aDocID) - lIDs.begin();
+    lIDs[lPos] = lIDs.back(); // the order inside a list does not matter
+    lIDs.pop_back();
+    std::copy_n(lCodes.end() - _noSubspaces, _noSubspaces, lCodes.begin() + lPos * _noSubspaces);
+    lCodes.resize(lCodes.size() - _noSubspaces);
+    _listOf[aDocID] = kNoList;
+    --_noEntries;
+}
+
+pair_sizet_float_vt IvfPqIndex::search(const float_vt& aQuery, const size_t aTopK, const size_t aNoProbes) const {
+    float_vt lQuery;
+    if (_noEntries == 0 || !this->normalize(aQuery, lQuery)) { return pair_sizet_float_vt(); } // no query term has a vector
+    TopKCollector lProbes(std::min(std::max<size_t>(aNoProbes, 1), _noLists));
+    for (size_t l = 0; l < _noLists; ++l) {
+        lProbes.push(l, static_cast<float>(Util::dot(lQuery.data(), &_centroids[l * _dimensions], _dimensions)));
+    }
+    // <q, c + r> = <q, c> + sum over the subspaces of <q_s, r_s>, the table holds <q_s, code> for every code
+    const size_t lSubDimensions = _dimensions / _noSubspaces;
+    float_vt lTable(_noSubspaces * _noCodes);
+    for (size_t s = 0; s < _noSubspaces; ++s) {
+        for (size_t c = 0; c < _noCodes; ++c) {
+            lTable[s * _noCodes + c] = static_cast<float>(Util::dot(&lQuery[s * lSubDimensions], &_codebooks[(s * kMaxCodes + c) * lSubDimensions], lSubDimensions));
+        }
+    }
+    TopKCollector lTopK(aTopK);
+    for (const auto& [list, centroidSim] : lProbes.finish()) {
+        const id_vt& lIDs = _listIDs[list];
+        const uint8_t* lCodes = _listCodes[list].data();
+        for (size_t i = 0; i < lIDs.size(); ++i, lCodes += _noSubspaces) {
+            float lSim = centroidSim;
+            for (size_t s = 0; s < _noSubspaces; ++s) {
+                lSim += lTable[s * _noCodes + lCodes[s]];
+            }
+            lTopK.push(lIDs[i], lSim);
+        }
+    }
+    return lTopK.finish();
+}
+
+size_t IvfPqIndex::memoryBytes() const {
+    size_t lBytes = (_centroids.size() + _codebooks.size()) * sizeof(float) + _listOf.size() * sizeof(uint32_t);
+    for (size_t l = 0; l < _listIDs.size(); ++l) {
+        lBytes += _listIDs[l].size() * sizeof(uint32_t) + _listCodes[l].size();
+    }
+    return lBytes;
+}
+
+void IvfPqIndex::save(const std::string& aPath) const {
+    const std::string lTmpPath = aPath + ".tmp";
+    std::ofstream out(lTmpPath, std::ios::binary | std::ios::trunc);
+    if (!out) { throw FileException(FLF, lTmpPath.c_str(), "The IVF-PQ index can not be written."); }
+    Util::writeValue(out, kMagic);
+    Util::writeValue(out, kVersion);
+    Util::writeString(out, Util::snapshotHeader(*_cb)); // the collection and the embeddings the index was built for
+    Util::writeValue<uint64_t>(out, _cb->ivfLists());
+    Util::writeValue<uint64_t>(out, _noSubspaces);
+    Util::writeValue<uint64_t>(out, _noLists);
+    Util::writeValue<uint64_t>(out, _noCodes);
+    Util::writeValue<uint64_t>(out, _dimensions);
+    Util::writeVector(out, _centroids);
+    Util::writeVector(out, _codebooks);
+    for (size_t l = 0; l < _listIDs.size(); ++l) {
+        Util::writeVector(out, _listIDs[l]);
+        Util::writeVector(out, _listCodes[l]);
+    }
+    out.close();
+    if (!out || std::rename(lTmpPath.c_str(), aPath.c_str()) != 0) {
+        throw FileException(FLF, aPath.c_str(), "The IVF-PQ index can not be written.");
+    }
+    TRACE("IvfPqIndex: Wrote the index to " + aPath);
+}
+
+bool IvfPqIndex::load(const std::string& aPath) {
+    std::ifstream file(aPath, std::ios::binary);
+    uint32_t lMagic = 0;
+    uint32_t lVersion = 0;
+    file.read(reinterpret_cast<char*>(&lMagic), sizeof(lMagic));
+    file.read(reinterpret_cast<char*>(&lVersion), sizeof(lVersion));
+    if (!file || lMagic != kMagic || lVersion != kVersion) { return false; }
+    file.close();
+
+    Util::BinaryReader reader(aPath, false);
+    reader.skip(sizeof(lMagic) + sizeof(lVersion));
+    if (reader.readString() != Util::snapshotHeader(*_cb) || reader.readValue<uint64_t>() != _cb->ivfLists() || reader.readValue<uint64_t>() != _noSubspaces) {
+        return false;
+    }
+    _noLists = reader.readValue<uint64_t>();
+    _noCodes = reader.readValue<uint64_t>();
+    _dimensions = reader.readValue<uint64_t>();
+    reader.readVector(_centroids);
+    reader.readVector(_codebooks);
+    _listIDs.assign(_noLists, id_vt());
+    _listCodes.assign(_noLists, code_vt());
+    _noEntries = 0;
+    for (size_t l = 0; l < _noLists; ++l) {
+        reader.readVector(_listIDs[l]);
+        reader.readVector(_listCodes[l]);
+        for (const uint32_t id : _listIDs[l]) {
+            if (id >= _listOf.size()) {
+                _listOf.resize(id + 1, kNoList);
+            }
+            _listOf[id] = static_cast<uint32_t>(l);
+        }
+        _noEntries += _listIDs[l].size();
+    }
+    if (!reader.atEnd()) {
+        throw FileException(FLF, aPath.c_str(), "The IVF-PQ index is corrupt.");
+    }
+    return true;
+}
@@ -0,0 +1,172 @@
+/**
+ *	@file 	ivfpq_index.hh
+ *	@brief  Implements an inverted file index with product quantization (IVF-PQ) over the word embeddings vectors of
+ *          the documents. A coarse k-means quantizer partitions the unit length vectors into lists, the residual of a
+ *          vector to its list centroid is split into subspaces and every subspace is encoded as one byte (the nearest
+ *          of 256 k-means centroids). A search probes the nprobe lists whose centroids are most similar to the query
+ *          and scores the codes with one lookup table per query, so a document costs one byte per subspace
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+#include "trace.hh"
+#include "exception.hh"
+#include "document.hh"
+#include "serialization_util.hh"
+#include "thread_util.hh"
+#include "top_k_collector.hh"
+#include "simd_util.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+class IvfPqIndex {
+    friend class IndexManager;
+
+  private:
+    explicit IvfPqIndex();
+    IvfPqIndex(const IvfPqIndex&) = delete;
+    IvfPqIndex(IvfPqIndex&&) = delete;
+    IvfPqIndex& operator=(const IvfPqIndex&) = delete;
+    IvfPqIndex& operator=(IvfPqIndex&&) = delete;
+    ~IvfPqIndex() = default;
+
+  private:
+    /**
+     * @brief Get the IvfPqIndex Singleton instance
+     *
+     * @return IvfPqIndex& a reference to the IvfPqIndex Singleton instance
+     */
+    inline static IvfPqIndex& getInstance() {
+        static IvfPqIndex lInstance;
+        return lInstance;
+    }
+    /**
+     * @brief Initialize control block and the index parameters
+     *
+     * @param aControlBlock the control block
+     */
+    void init(const CB& aControlBlock);
+
+    /**
+     * @brief Train the coarse quantizer and the subspace codebooks on the word embeddings vectors of the documents and
+     *        encode them, documents without a vector are left out
+     *
+     * @param aDocs the documents
+     */
+    void build(const doc_mt& aDocs);
+    /**
+     * @brief Encode one more document with the trained quantizers, e.g. an added one
+     *
+     * @param aDocID the id of the document
+     * @param aVec the word embeddings vector of the document
+     */
+    void add(const size_t aDocID, const float_vt& aVec);
+    /**
+     * @brief Remove a document from its list, e.g. a deleted one
+     *
+     * @param aDocID the id of the document
+     */
+    void remove(const size_t aDocID);
+
+    /**
+     * @brief Write the quantizers and the lists to aPath
+     *
+     * @param aPath the path of the index file
+     */
+    void save(const std::string& aPath) const;
+    /**
+     * @brief Restore the index written by @see save. A file which was written for another collection or with other
+     *        parameters is not loaded
+     *
+     * @param aPath the path of the index file
+     * @return true if the index was loaded, false if it has to be built
+     */
+    bool load(const std::string& aPath);
+
+  public:
+    /**
+     * @brief Search the documents with the most similar word embeddings vectors, approximated by the codes
+     *
+     * @param aQuery the query vector, it does not need to have unit length
+     * @param aTopK the number of results
+     * @param aNoProbes the number of lists to search
+     * @return pair_sizet_float_vt the (docID, approximate cosine similarity) pairs ordered descending
+     */
+    pair_sizet_float_vt search(const float_vt& aQuery, const size_t aTopK, const size_t aNoProbes) const;
+
+    /**
+     * @brief Get the number of documents in the index
+     *
+     * @return size_t the number of encoded documents
+     */
+    inline size_t size() const { return _noEntries; }
+    /**
+     * @brief Get the memory used by the codes, the ids and the quantizers
+     *
+     * @return size_t the bytes
+     */
+    size_t memoryBytes() const;
+
+  private:
+    using code_vt = std::vector<uint8_t>;
+    using id_vt = std::vector<uint32_t>; // docIDs of a list, half the bytes of a sizet_vt
+
+    /**
+     * @brief Lloyd's k-means with squared euclidean distances, the centroids start at distinct random points and an
+     *        empty cluster is moved to a random point
+     *
+     * @param aData aNoPoints points with aDimensions components each
+     * @param aNoPoints the number of points
+     * @param aDimensions the number of components
+     * @param aK the number of centroids, at most aNoPoints
+     * @param aCentroids the aK * aDimensions components of the centroids
+     */
+    void kMeans(const float_vt& aData, const size_t aNoPoints, const size_t aDimensions, const size_t aK, float_vt& aCentroids);
+    /**
+     * @brief Get the nearest of aK centroids (squared euclidean distance)
+     */
+    static uint32_t nearest(const float* aPoint, const float* aCentroids, const size_t aK, const size_t aDimensions);
+    /**
+     * @brief Normalize aVec to unit length into aOut
+     *
+     * @return bool false if aVec is zero or too short
+     */
+    bool normalize(const float_vt& aVec, float_vt& aOut) const;
+    /**
+     * @brief Assign a unit length vector to its list and append its code
+     */
+    void encode(const size_t aDocID, const float* aVec);
+
+  private:
+    static constexpr uint32_t kMagic = 0x51505649; // "IVPQ"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kMaxCodes = 256;       // the centroids of a subspace, one byte per code
+    static constexpr size_t kIterations = 10;      // the iterations of k-means
+    static constexpr uint32_t kNoList = std::numeric_limits<uint32_t>::max();
+
+    const CB* _cb;
+    size_t _noLists;     // the configured number of lists, fewer if there are fewer documents
+    size_t _noSubspaces; // the number of bytes per code
+    size_t _noCodes;     // the centroids of a subspace, kMaxCodes unless there are fewer documents
+    size_t _dimensions;
+    size_t _noEntries;
+    std::mt19937 _rng;
+
+    float_vt _centroids;              // the coarse centroids, _dimensions components per list
+    float_vt _codebooks;              // per subspace kMaxCodes centroids of _dimensions / _noSubspaces components
+    std::vector<id_vt> _listIDs;      // the docIDs of every list
+    std::vector<code_vt> _listCodes;  // the codes of every list, _noSubspaces bytes per docID
+    std::vector<uint32_t> _listOf;    // the list of every docID, kNoList if it is not in the index
+};
@@ -0,0 +1,99 @@
+#include "lsh_index.hh"
+
+/**
+ * @brief Construct a new Lsh Index:: Lsh Index object
+ *
+ */
+LshIndex::LshIndex() :
+    _cb(nullptr),
+    _bandBits(0),
+    _tables()
+{}
+
+void LshIndex::init(const CB& aControlBlock) {
+    if (!_cb) {
+        _cb = &aControlBlock;
+        _bandBits = _cb->lshBandBits();
+        TRACE("LshIndex: Initialized");
+    }
+}
+
+uint64_t LshIndex::key(const uint64_t* aSignature, const size_t aTable) const {
+    const size_t lFirst = aTable * _bandBits;
+    const size_t lWord = lFirst / 64;
+    const size_t lShift = lFirst % 64;
+    uint64_t lKey = aSignature[lWord] >> lShift;
+    if (lShift + _bandBits > 64) { // the band continues in the next word
+        lKey |= aSignature[lWord + 1] << (64 - lShift);
+    }
+    return (_bandBits == 64) ? lKey : lKey & ((uint64_t(1) << _bandBits) - 1);
+}
+
+void LshIndex::build(const doc_mt& aDocs, const PackedSignatures& aSignatures) {
+    _tables.assign(_cb->lshTables(), table_t());
+    for (const auto& [id, doc] : aDocs) {
+        this->add(id, aSignatures.row(id));
+    }
+    TRACE("LshIndex: Hashed " + std::to_string(aDocs.size()) + " documents into " + std::to_string(_tables.size()) + " tables with " + std::to_string(_bandBits) + " bit keys (" + std::to_string(this->memoryBytes()) + " bytes)");
+}
+
+void LshIndex::add(const size_t aDocID, const uint64_t* aSignature) {
+    for (size_t t = 0; t < _tables.size(); ++t) {
+        _tables[t][this->key(aSignature, t)].push_back(static_cast<uint32_t>(aDocID));
+    }
+}
+
+void LshIndex::remove(const size_t aDocID, const uint64_t* aSignature) {
+    for (size_t t = 0; t < _tables.size(); ++t) {
+        const auto lBucket = _tables[t].find(this->key(aSignature, t));
+        if (lBucket == _tables[t].end()) { continue; }
+        id_vt& lIDs = lBucket->second;
+        lIDs.erase(std::remove(lIDs.begin(), lIDs.end(), static_cast<uint32_t>(aDocID)), lIDs.end());
+        if (lIDs.empty()) {
+            _tables[t].erase(lBucket);
+        }
+    }
+}
+
+void LshIndex::collect(const size_t aTable, const uint64_t aKey, sizet_vt& aOut) const {
+    const auto lBucket = _tables[aTable].find(aKey);
+    if (lBucket != _tables[aTable].end()) {
+        aOut.insert(aOut.end(), lBucket->second.begin(), lBucket->second.end());
+    }
+}
+
+sizet_vt LshIndex::search(const uint64_t* aQuery, const size_t aNoProbes) const {
+    sizet_vt lCandidates;
+    for (size_t t = 0; t < _tables.size(); ++t) {
+        const uint64_t lKey = this->key(aQuery, t);
+        size_t lProbes = aNoProbes;
+        const auto probe = [&](const uint64_t aKey) {
+            if (lProbes == 0) { return false; }
+            this->collect(t, aKey, lCandidates);
+            return --lProbes != 0;
+        };
+        if (!probe(lKey)) { continue; }
+        bool lMore = true;
+        for (size_t i = 0; lMore && i < _bandBits; ++i) { // the neighbouring buckets, one bit apart
+            lMore = probe(lKey ^ (uint64_t(1) << i));
+        }
+        for (size_t i = 0; lMore && i < _bandBits; ++i) { // two bits apart
+            for (size_t j = i + 1; lMore && j < _bandBits; ++j) {
+                lMore = probe(lKey ^ (uint64_t(1) << i) ^ (uint64_t(1) << j));
+            }
+        }
+    }
+    std::sort(lCandidates.begin(), lCandidates.end());
+    lCandidates.erase(std::unique(lCandidates.begin(), lCandidates.end()), lCandidates.end());
+    return lCandidates;
+}
+
+size_t LshIndex::memoryBytes() const {
+    size_t lBytes = 0;
+    for (const table_t& lTable : _tables) {
+        for (const auto& [key, ids] : lTable) {
+            lBytes += sizeof(key) + ids.capacity() * sizeof(uint32_t);
+        }
+    }
+    return lBytes;
+}
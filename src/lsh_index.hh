@@ -0,0 +1,113 @@
+/**
+ *	@file 	lsh_index.hh
+ *	@brief  Implements a banded locality sensitive hashing (LSH) index over the random projection signatures of the
+ *          documents. The first tables x bandBits bits of a signature are cut into bands, band t is the key of the
+ *          document in hash table t. Two documents collide in a table with probability p^bandBits, where p is the
+ *          fraction of equal signature bits, so more tables raise the recall and more bits per band shrink the
+ *          buckets. A search can also probe the buckets whose keys differ from the one of the query in one or two
+ *          bits (multi-probe) instead of adding tables
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+#include "trace.hh"
+#include "document.hh"
+#include "packed_signatures.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class LshIndex {
+    friend class IndexManager;
+
+  private:
+    explicit LshIndex();
+    LshIndex(const LshIndex&) = delete;
+    LshIndex(LshIndex&&) = delete;
+    LshIndex& operator=(const LshIndex&) = delete;
+    LshIndex& operator=(LshIndex&&) = delete;
+    ~LshIndex() = default;
+
+  private:
+    /**
+     * @brief Get the LshIndex Singleton instance
+     *
+     * @return LshIndex& a reference to the LshIndex Singleton instance
+     */
+    inline static LshIndex& getInstance() {
+        static LshIndex lInstance;
+        return lInstance;
+    }
+    /**
+     * @brief Initialize control block and the index parameters
+     *
+     * @param aControlBlock the control block
+     */
+    void init(const CB& aControlBlock);
+
+    /**
+     * @brief Hash the signatures of all documents into the tables
+     *
+     * @param aDocs the documents
+     * @param aSignatures the packed signatures of the documents, indexed by docID
+     */
+    void build(const doc_mt& aDocs, const PackedSignatures& aSignatures);
+    /**
+     * @brief Hash the signature of one more document into the tables, e.g. an added one
+     *
+     * @param aDocID the id of the document
+     * @param aSignature the packed signature of the document
+     */
+    void add(const size_t aDocID, const uint64_t* aSignature);
+    /**
+     * @brief Remove a document from its buckets, e.g. a deleted one
+     *
+     * @param aDocID the id of the document
+     * @param aSignature the packed signature of the document
+     */
+    void remove(const size_t aDocID, const uint64_t* aSignature);
+
+  public:
+    /**
+     * @brief Get the documents which share a bucket with the query in at least one table
+     *
+     * @param aQuery the packed signature of the query
+     * @param aNoProbes the number of buckets probed per table, 1 only probes the bucket of the query. The next
+     *        bandBits probes flip one bit of the key, the ones after them flip two bits
+     * @return sizet_vt the distinct docIDs ordered ascending
+     */
+    sizet_vt search(const uint64_t* aQuery, const size_t aNoProbes) const;
+
+    inline size_t tables() const { return _tables.size(); }
+    inline size_t bandBits() const { return _bandBits; }
+    /**
+     * @brief Get the memory used by the buckets
+     *
+     * @return size_t the bytes of the keys and the docIDs
+     */
+    size_t memoryBytes() const;
+
+  private:
+    using id_vt = std::vector<uint32_t>; // docIDs of a bucket, half the bytes of a sizet_vt
+    using table_t = std::unordered_map<uint64_t, id_vt>;
+
+    /**
+     * @brief Get the key of a signature in table aTable, i.e. its bits [aTable * bandBits, (aTable + 1) * bandBits)
+     */
+    uint64_t key(const uint64_t* aSignature, const size_t aTable) const;
+    /**
+     * @brief Append the docIDs of the bucket aKey of table aTable to aOut, if the bucket exists
+     */
+    void collect(const size_t aTable, const uint64_t aKey, sizet_vt& aOut) const;
+
+  private:
+    const CB* _cb;
+    size_t _bandBits;
+    std::vector<table_t> _tables;
+};
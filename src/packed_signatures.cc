@@ -0,0 +1,46 @@
+#include "packed_signatures.hh"
+#include "exception.hh"
+#include "simd_util.hh"
+
+#include <string>
+
+/**
+ * @brief Construct a new Packed Signatures:: Packed Signatures object
+ *
+ */
+PackedSignatures::PackedSignatures() :
+    _bits(0),
+    _noWords(0),
+    _stride(0),
+    _noRows(0),
+    _words()
+{}
+
+void PackedSignatures::reset(const size_t aBits) {
+    constexpr size_t kWordsPerLine = kRowAlignment / sizeof(uint64_t);
+    _bits = aBits;
+    _noWords = (aBits + 63) / 64;
+    _stride = (_noWords + kWordsPerLine - 1) / kWordsPerLine * kWordsPerLine;
+    _noRows = 0;
+    _words.clear();
+}
+
+void PackedSignatures::set(const size_t aRow, const boost::dynamic_bitset<>& aSignature) {
+    if (aRow >= _noRows) {
+        _noRows = aRow + 1;
+        _words.resize(_noRows * _stride, 0);
+    }
+    this->pack(aSignature, _words.data() + aRow * _stride);
+}
+
+void PackedSignatures::pack(const boost::dynamic_bitset<>& aSignature, uint64_t* aOut) const {
+    if (aSignature.size() != _bits) {
+        throw InvalidArgumentException(FLF, "The signature has " + std::to_string(aSignature.size()) + " bits instead of " + std::to_string(_bits) + ".");
+    }
+    static_assert(sizeof(boost::dynamic_bitset<>::block_type) == sizeof(uint64_t), "The blocks of the signatures are 64 bit words");
+    boost::to_block_range(aSignature, aOut); // the bits above size() are zero
+}
+
+void PackedSignatures::hammingDistances(const uint64_t* aQuery, const sizet_vt& aIds, uint32_t* aOut) const {
+    Util::simdKernels().hammingDistances(aQuery, _words.data(), _stride, _noWords, aIds.data(), aIds.size(), aOut);
+}
@@ -0,0 +1,89 @@
+/**
+ *	@file 	packed_signatures.hh
+ *	@brief  Implements a table of the random projection signatures of the documents, packed into 64 bit words and
+ *          stored contiguously row after row, indexed by docID. Every row starts on a cache line, so the Hamming scan
+ *          of the candidates reads whole lines and allocates nothing
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+
+#include <boost/dynamic_bitset.hpp>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+class PackedSignatures {
+  public:
+    static constexpr size_t kRowAlignment = 64; // byte alignment of every row (a cache line)
+
+  private:
+    template <typename T> struct CacheLineAllocator {
+        using value_type = T;
+        CacheLineAllocator() = default;
+        template <typename U> CacheLineAllocator(const CacheLineAllocator<U>&) {}
+        T* allocate(const size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kRowAlignment))); }
+        void deallocate(T* p, const size_t) { ::operator delete(p, std::align_val_t(kRowAlignment)); }
+        template <typename U> bool operator==(const CacheLineAllocator<U>&) const { return true; }
+        template <typename U> bool operator!=(const CacheLineAllocator<U>&) const { return false; }
+    };
+
+  public:
+    PackedSignatures();
+    PackedSignatures(const PackedSignatures&) = delete;
+    PackedSignatures(PackedSignatures&&) = delete;
+    PackedSignatures& operator=(const PackedSignatures&) = delete;
+    PackedSignatures& operator=(PackedSignatures&&) = delete;
+    ~PackedSignatures() = default;
+
+  public:
+    /**
+     * @brief Remove all rows and set the number of bits of every signature
+     *
+     * @param aBits the number of bits, i.e. the dimensions of the random projection
+     */
+    void reset(const size_t aBits);
+    /**
+     * @brief Set row aRow, the table grows with zero rows if needed
+     *
+     * @param aRow the row
+     * @param aSignature the signature with bits() bits
+     */
+    void set(const size_t aRow, const boost::dynamic_bitset<>& aSignature);
+    /**
+     * @brief Pack a signature into words() 64 bit words, e.g. the signature of a query
+     *
+     * @param aSignature the signature with bits() bits
+     * @param aOut the words() words to write
+     */
+    void pack(const boost::dynamic_bitset<>& aSignature, uint64_t* aOut) const;
+    /**
+     * @brief Compute the Hamming distances of a packed query signature to the rows aIds
+     *
+     * @param aQuery the words() words of the query, @see pack
+     * @param aIds the rows, all smaller than size()
+     * @param aOut the aIds.size() distances to write
+     */
+    void hammingDistances(const uint64_t* aQuery, const sizet_vt& aIds, uint32_t* aOut) const;
+
+    inline const uint64_t* row(const size_t aRow) const { return _words.data() + aRow * _stride; }
+    inline size_t bits() const { return _bits; }
+    inline size_t words() const { return _noWords; }
+    inline size_t size() const { return _noRows; }
+    /**
+     * @brief Get the memory used by the rows
+     *
+     * @return size_t the bytes of the rows including the padding
+     */
+    inline size_t memoryBytes() const { return _words.size() * sizeof(uint64_t); }
+
+  private:
+    size_t _bits;
+    size_t _noWords; // of a signature
+    size_t _stride;  // words of a row, _noWords padded to kRowAlignment
+    size_t _noRows;
+    std::vector<uint64_t, CacheLineAllocator<uint64_t>> _words;
+};
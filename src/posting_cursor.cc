@@ -0,0 +1,65 @@
+#include "posting_cursor.hh"
+
+/**
+ * @brief Construct a new Posting Cursor:: Posting Cursor object pointing to the first posting
+ *
+ * @param aPostingList the posting list
+ */
+PostingCursor::PostingCursor(const PostingList& aPostingList) :
+    _pl(&aPostingList),
+    _ids(aPostingList.getIDs().data()),
+    _tfs(aPostingList.getTfs().data()),
+    _n(aPostingList.getIDs().size()),
+    _pos(0),
+    _block(0),
+    _doc(kEnd),
+    _bufIDs(),
+    _bufTfs()
+{
+    if (_pl->isCompressed()) {
+        loadBlock(0);
+    } else if (_n > 0) {
+        _doc = _ids[0];
+    }
+}
+
+void PostingCursor::nextGEQ(const size_t aDocID) {
+    if (_doc >= aDocID) { return; }
+    if (_pl->isCompressed() && _ids[_n - 1] < aDocID) { // the current block is passed, skip to the block of aDocID
+        loadBlock(findBlock(aDocID));
+        if (_doc >= aDocID) { return; }
+    }
+    _pos = std::lower_bound(_ids + _pos, _ids + _n, aDocID) - _ids;
+    _doc = (_pos < _n) ? _ids[_pos] : kEnd;
+}
+
+size_t PostingCursor::findBlock(const size_t aDocID) const {
+    size_t lo = block();
+    size_t hi = _pl->getNoBlocks();
+    while (lo < hi) { // first block whose last docID is >= aDocID
+        const size_t mid = lo + (hi - lo) / 2;
+        if (_pl->getBlockLastID(mid) < aDocID) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void PostingCursor::loadBlock(const size_t aBlock) {
+    _pos = 0;
+    _block = aBlock;
+    if (!_pl->isCompressed() || aBlock >= _pl->getNoBlocks()) {
+        _n = 0;
+        _doc = kEnd;
+        return;
+    }
+    _bufIDs.clear();
+    _bufTfs.clear();
+    _pl->decodeBlock(aBlock, _bufIDs, _bufTfs);
+    _ids = _bufIDs.data();
+    _tfs = _bufTfs.data();
+    _n = _bufIDs.size();
+    _doc = _ids[0];
+}
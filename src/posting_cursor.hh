@@ -0,0 +1,97 @@
+/**
+ *	@file 	posting_cursor.hh
+ *	@brief  Implements a forward cursor over a posting list for document at a time query processing. Compressed
+ *          posting lists are decoded one block at a time, blocks which are skipped are never decoded
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+#include "posting_list.hh"
+
+#include <algorithm>
+#include <limits>
+
+class PostingCursor {
+  public:
+    static constexpr size_t kEnd = std::numeric_limits<size_t>::max(); // docID of an exhausted cursor
+
+  public:
+    explicit PostingCursor(const PostingList& aPostingList);
+    PostingCursor(const PostingCursor&) = delete;
+    PostingCursor(PostingCursor&&) = default;
+    PostingCursor& operator=(const PostingCursor&) = delete;
+    PostingCursor& operator=(PostingCursor&&) = default;
+    ~PostingCursor() = default;
+
+  public:
+    /**
+     * @brief Get the docID the cursor points to
+     *
+     * @return size_t the docID or kEnd if the cursor is exhausted
+     */
+    inline size_t doc() const { return _doc; }
+    /**
+     * @brief Get the term frequency of the posting the cursor points to
+     *
+     * @return float the tf
+     */
+    inline float tf() const { return _tfs[_pos]; }
+    /**
+     * @brief Get the block of the posting the cursor points to
+     *
+     * @return size_t the block
+     */
+    inline size_t block() const { return _block + (_pl->isCompressed() ? 0 : _pos / Util::kBlockSize); }
+    /**
+     * @brief Get the posting list of the cursor
+     *
+     * @return const PostingList& the posting list
+     */
+    inline const PostingList& getPostingList() const { return *_pl; }
+    /**
+     * @brief Move the cursor to the next posting
+     */
+    inline void next() {
+        if (++_pos < _n) {
+            _doc = _ids[_pos];
+        } else {
+            loadBlock(_block + 1);
+        }
+    }
+    /**
+     * @brief Move the cursor to the first posting with a docID >= aDocID
+     *
+     * @param aDocID the docID
+     */
+    void nextGEQ(const size_t aDocID);
+    /**
+     * @brief Find the block which contains the first posting with a docID >= aDocID without moving the cursor
+     *        or decoding anything (shallow move)
+     *
+     * @param aDocID the docID, not smaller than the current docID
+     * @return size_t the block or getNoBlocks() if there is no such posting
+     */
+    size_t findBlock(const size_t aDocID) const;
+
+  private:
+    /**
+     * @brief Load block aBlock of a compressed posting list and point to its first posting
+     *
+     * @param aBlock the block
+     */
+    void loadBlock(const size_t aBlock);
+
+  private:
+    const PostingList* _pl;
+    const size_t* _ids; // ids of the current window: the whole posting or one decoded block
+    const float* _tfs;  // tfs of the current window
+    size_t _n;          // size of the current window
+    size_t _pos;        // position in the current window
+    size_t _block;      // block of the current window if compressed
+    size_t _doc;        // current docID
+    sizet_vt _bufIDs;
+    float_vt _bufTfs;
+};
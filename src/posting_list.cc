@@ -4,11 +4,13 @@
  * @brief Construct a new Posting List:: Posting List object
  * 
  * @param aIdf the idf
- * @param aPosting the posting
+ * @param aIDs the docIDs of the posting, sorted ascending
+ * @param aTfs the tfs of the posting, parallel to aIDs
  */
-PostingList::PostingList(const float aIdf, const sizet_float_mt& aPosting) : 
+PostingList::PostingList(const float aIdf, const sizet_vt& aIDs, const float_vt& aTfs) : 
     _idf(aIdf),
-    _posting(aPosting)
+    _ids(aIDs),
+    _tfs(aTfs)
 {}
 
 /**
@@ -18,22 +20,228 @@ PostingList::PostingList(const float aIdf, const sizet_float_mt& aPosting) :
  */
 PostingList::PostingList(const PostingList& pl) : 
     _idf(pl.getIdf()),
-    _posting(pl.getPosting())
+    _ids(pl.getIDs()),
+    _tfs(pl.getTfs()),
+    _codec(pl._codec),
+    _noPostings(pl._noPostings),
+    _blockLastIDs(pl._blockLastIDs),
+    _blockOffsets(pl._blockOffsets),
+    _blockWidths(pl._blockWidths),
+    _data(pl._data),
+    _qtfs(pl._qtfs),
+    _maxScore(pl._maxScore),
+    _blockMaxScores(pl._blockMaxScores)
 {}
 
-const sizet_vt PostingList::getIDs() const {
+float PostingList::getTf(size_t aDocID) const {
+    if (isCompressed()) { // find the only block which may contain aDocID and decode it
+        const auto block = std::lower_bound(_blockLastIDs.begin(), _blockLastIDs.end(), aDocID);
+        if (block != _blockLastIDs.end()) {
+            sizet_vt ids;
+            float_vt tfs;
+            decodeBlock(std::distance(_blockLastIDs.begin(), block), ids, tfs);
+            auto it = std::lower_bound(ids.begin(), ids.end(), aDocID);
+            if (it != ids.end() && *it == aDocID)
+                return tfs[std::distance(ids.begin(), it)];
+        }
+        throw InvalidArgumentException(FLF, "The doc ID " + std::to_string(aDocID) + " does not appear in the posting list.");
+    }
+    auto it = std::lower_bound(_ids.begin(), _ids.end(), aDocID);
+    if (it != _ids.end() && *it == aDocID)
+        return _tfs[std::distance(_ids.begin(), it)];
+    else
+        throw InvalidArgumentException(FLF, "The doc ID " + std::to_string(aDocID) + " does not appear in the posting list.");
+}
+
+void PostingList::setTf(size_t aDocID, float aTf) {
+    if (isCompressed()) {
+        const POSTING_CODEC codec = _codec;
+        compress(kUNCOMPRESSED);
+        setTf(aDocID, aTf);
+        compress(codec);
+        return;
+    }
+    if (_ids.empty() || _ids.back() < aDocID) { // common case, append
+        _ids.push_back(aDocID);
+        _tfs.push_back(aTf);
+        return;
+    }
+    auto it = std::lower_bound(_ids.begin(), _ids.end(), aDocID);
+    const size_t pos = std::distance(_ids.begin(), it);
+    if (*it == aDocID) {
+        _tfs[pos] = aTf;
+    } else {
+        _ids.insert(it, aDocID);
+        _tfs.insert(_tfs.begin() + pos, aTf);
+    }
+}
+
+void PostingList::compress(const POSTING_CODEC aCodec) {
+    if (aCodec == _codec) { return; }
+    if (isCompressed()) { // decode into the plain arrays first
+        sizet_vt ids;
+        float_vt tfs;
+        ids.reserve(_noPostings);
+        tfs.reserve(_noPostings);
+        for (size_t block = 0; block < getNoBlocks(); ++block) {
+            decodeBlock(block, ids, tfs);
+        }
+        _ids.swap(ids);
+        _tfs.swap(tfs);
+        _noPostings = 0;
+        _blockLastIDs = sizet_vt();
+        _blockOffsets = sizet_vt();
+        _blockWidths = byte_vt();
+        _data = byte_vt();
+        _qtfs = byte_vt();
+        _codec = kUNCOMPRESSED;
+    }
+    if (aCodec == kUNCOMPRESSED) { return; }
+    if (aCodec != kVARBYTE && aCodec != kBITPACK)
+        throw InvalidArgumentException(FLF, "The posting codec " + codecToString(aCodec) + " is not supported.");
+
+    const size_t noBlocks = (_ids.size() + Util::kBlockSize - 1) / Util::kBlockSize;
+    _blockLastIDs.reserve(noBlocks);
+    _blockOffsets.reserve(noBlocks);
+    if (aCodec == kBITPACK) { _blockWidths.reserve(noBlocks); }
+    _qtfs.reserve(_ids.size());
+    uint32_t gaps[Util::kBlockSize];
+    size_t prev = 0;
+    for (size_t start = 0; start < _ids.size(); start += Util::kBlockSize) {
+        const size_t n = std::min(Util::kBlockSize, _ids.size() - start);
+        for (size_t i = 0; i < n; ++i) {
+            const size_t gap = _ids[start + i] - prev;
+            if (gap > UINT32_MAX)
+                throw InvalidArgumentException(FLF, "The doc ID gap " + std::to_string(gap) + " exceeds 32 bits.");
+            gaps[i] = static_cast<uint32_t>(gap);
+            prev = _ids[start + i];
+            _qtfs.push_back(Util::quantizeTf(_tfs[start + i]));
+        }
+        _blockLastIDs.push_back(prev);
+        _blockOffsets.push_back(_data.size());
+        if (aCodec == kBITPACK) {
+            const uint8_t width = Util::bitWidth(gaps, n);
+            _blockWidths.push_back(width);
+            Util::bitPack(gaps, n, width, _data);
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                Util::varByteEncode(gaps[i], _data);
+            }
+        }
+    }
+    _data.resize(_data.size() + Util::kBitPackPadding, 0);
+    _data.shrink_to_fit();
+    _noPostings = _ids.size();
+    _ids = sizet_vt();
+    _tfs = float_vt();
+    _codec = aCodec;
+}
+
+void PostingList::decodeBlock(const size_t aBlock, sizet_vt& aIDs) const {
+    const size_t start = aBlock * Util::kBlockSize;
+    const size_t n = std::min(Util::kBlockSize, _noPostings - start);
+    uint32_t gaps[Util::kBlockSize];
+    if (_codec == kBITPACK) {
+        Util::bitUnpack(_data.data() + _blockOffsets[aBlock], n, _blockWidths[aBlock], gaps);
+    } else {
+        Util::varByteDecode(_data.data() + _blockOffsets[aBlock], n, gaps);
+    }
+    size_t id = (aBlock == 0) ? 0 : _blockLastIDs[aBlock - 1];
+    for (size_t i = 0; i < n; ++i) {
+        id += gaps[i];
+        aIDs.push_back(id);
+    }
+}
+
+void PostingList::decodeBlock(const size_t aBlock, sizet_vt& aIDs, float_vt& aTfs) const {
+    decodeBlock(aBlock, aIDs);
+    const size_t start = aBlock * Util::kBlockSize;
+    const size_t end = std::min(start + Util::kBlockSize, _noPostings);
+    for (size_t i = start; i < end; ++i) {
+        aTfs.push_back(Util::dequantizeTf(_qtfs[i]));
+    }
+}
+
+void PostingList::decodeIDs(sizet_vt& aIDs) const {
+    aIDs.reserve(aIDs.size() + _noPostings);
+    for (size_t block = 0; block < getNoBlocks(); ++block) {
+        decodeBlock(block, aIDs);
+    }
+}
+
+void PostingList::computeScoreBounds(const float_vt& aDocNormLengths) {
+    _maxScore = 0;
+    _blockMaxScores.assign(getNoBlocks(), 0);
     sizet_vt ids;
-    ids.reserve(_posting.size());
-    for (auto& item : _posting) {
-        ids.push_back(item.first);
+    float_vt tfs;
+    for (size_t block = 0; block < getNoBlocks(); ++block) {
+        const size_t start = block * Util::kBlockSize;
+        const size_t n = std::min(Util::kBlockSize, size() - start);
+        const size_t* lIDs = _ids.data() + start;
+        const float* lTfs = _tfs.data() + start;
+        if (isCompressed()) {
+            ids.clear();
+            tfs.clear();
+            decodeBlock(block, ids, tfs);
+            lIDs = ids.data();
+            lTfs = tfs.data();
+        }
+        float blockMax = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const float normLength = aDocNormLengths[lIDs[i]];
+            if (normLength > 0) { blockMax = std::max(blockMax, lTfs[i] * _idf / normLength); } // tf-idf / norm length
+        }
+        _blockMaxScores[block] = blockMax;
+        _maxScore = std::max(_maxScore, blockMax);
     }
-    return ids;
+}
+
+void PostingList::save(std::ostream& aOut) const {
+    Util::writeValue(aOut, _idf);
+    Util::writeValue<int32_t>(aOut, _codec);
+    Util::writeVector(aOut, _ids);
+    Util::writeVector(aOut, _tfs);
+    Util::writeValue<uint64_t>(aOut, _noPostings);
+    Util::writeVector(aOut, _blockLastIDs);
+    Util::writeVector(aOut, _blockOffsets);
+    Util::writeVector(aOut, _blockWidths);
+    Util::writeVector(aOut, _data);
+    Util::writeVector(aOut, _qtfs);
+    Util::writeValue(aOut, _maxScore);
+    Util::writeVector(aOut, _blockMaxScores);
+}
+
+void PostingList::load(Util::BinaryReader& aReader) {
+    _idf = aReader.readValue<float>();
+    _codec = static_cast<POSTING_CODEC>(aReader.readValue<int32_t>());
+    aReader.readVector(_ids);
+    aReader.readVector(_tfs);
+    _noPostings = aReader.readValue<uint64_t>();
+    aReader.readVector(_blockLastIDs);
+    aReader.readVector(_blockOffsets);
+    aReader.readVector(_blockWidths);
+    aReader.readVector(_data);
+    aReader.readVector(_qtfs);
+    _maxScore = aReader.readValue<float>();
+    aReader.readVector(_blockMaxScores);
+}
+
+size_t PostingList::byteSize() const {
+    if (!isCompressed()) { return _ids.size() * sizeof(size_t) + _tfs.size() * sizeof(float); }
+    return _blockLastIDs.size() * sizeof(size_t) + _blockOffsets.size() * sizeof(size_t) + _blockWidths.size() + _data.size() + _qtfs.size();
 }
 
 std::ostream& operator<<(std::ostream& strm, const PostingList& pl) {
+    sizet_vt ids;
+    float_vt tfs;
+    for (size_t block = 0; pl.isCompressed() && block < pl.getNoBlocks(); ++block) {
+        pl.decodeBlock(block, ids, tfs);
+    }
+    const sizet_vt& lIDs = pl.isCompressed() ? ids : pl.getIDs();
+    const float_vt& lTfs = pl.isCompressed() ? tfs : pl.getTfs();
     strm << "[ ";
-    for (auto it = pl.getPosting().begin(); it != pl.getPosting().end(); ++it) {
-        strm << "(" << it->first << ", " << it->second << ") ";
+    for (size_t i = 0; i < lIDs.size(); ++i) {
+        strm << "(" << lIDs[i] << ", " << lTfs[i] << ") ";
     }
     return strm << "]";
 }
@@ -1,7 +1,9 @@
 /**
  *	@file 	posting_list.hh
  *	@author	Nicolas Wipfler (nwipfler@mail.uni-mannheim.de)
- *	@brief  Implements the postingList with idf and posting (docID, tf)
+ *	@brief  Implements the postingList with idf and posting (docID, tf). The posting is stored as two
+ *          parallel contiguous arrays (docIDs and tfs) which are sorted ascending by docID. After @see compress
+ *          the docIDs are stored as delta gaps in blocks of Util::kBlockSize postings and the tfs are quantized
  *	@bugs 	Currently no bugs known
  *
  *	@section DESCRIPTION docto_
@@ -9,7 +11,11 @@
 #pragma once
 
 #include "types.hh"
+#include "exception.hh"
+#include "compression_util.hh"
+#include "serialization_util.hh"
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <tuple>
@@ -18,10 +24,10 @@
 
 class PostingList {
   public:
-    explicit PostingList(const float aIdf, const sizet_float_mt& aPosting);
+    explicit PostingList(const float aIdf, const sizet_vt& aIDs, const float_vt& aTfs);
     explicit PostingList(const PostingList& pl);
     explicit PostingList() = default;
-    PostingList(PostingList&&) = delete;
+    PostingList(PostingList&&) = default;
     PostingList& operator=(const PostingList&) = delete;
     PostingList& operator=(PostingList&&) = default;
     ~PostingList() = default;
@@ -33,7 +39,7 @@ class PostingList {
      * @param aDocID the id of the document
      * @return float the tf of the term in document with id aDocID
      */
-    inline float getTf(size_t aDocID) const { return _posting.at(aDocID); }
+    float getTf(size_t aDocID) const;
     /**
      * @brief Get the inverse document frequency for the corresponding term of this posting list
      *
@@ -41,25 +47,147 @@ class PostingList {
      */
     inline float getIdf() const { return _idf; }
     /**
-     * @brief Get the posting for the corresponding term
+     * @brief Get all ids from the posting, sorted ascending (no copy). Empty if the posting list is compressed
      *
-     * @return const sizet_float_mt& the posting for the corresponding term
+     * @return const sizet_vt& the ids
      */
-    inline const sizet_float_mt& getPosting() const { return _posting; }
+    inline const sizet_vt& getIDs() const { return _ids; }
     /**
-     * @brief Get all ids from the posting
+     * @brief Get all ids from the posting, sorted ascending. A compressed posting list is decoded into aBuffer,
+     *        otherwise the ids are returned without copy
      *
-     * @return const sizet_vt a vector with the ids
+     * @param aBuffer the buffer for the decoded ids
+     * @return const sizet_vt& the ids
      */
-    const sizet_vt getIDs() const;
+    inline const sizet_vt& getIDs(sizet_vt& aBuffer) const {
+        if (!isCompressed()) { return _ids; }
+        aBuffer.clear();
+        decodeIDs(aBuffer);
+        return aBuffer;
+    }
+    /**
+     * @brief Get all term frequencies from the posting, _tfs[i] belongs to document _ids[i] (no copy).
+     *        Empty if the posting list is compressed
+     *
+     * @return const float_vt& the term frequencies
+     */
+    inline const float_vt& getTfs() const { return _tfs; }
+    /**
+     * @brief Get the number of documents in the posting
+     *
+     * @return size_t the number of documents
+     */
+    inline size_t size() const { return isCompressed() ? _noPostings : _ids.size(); }
+    /**
+     * @brief Whether the posting contains no document
+     *
+     * @return bool true if the posting is empty
+     */
+    inline bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Compress the posting with aCodec. The docIDs are delta gap encoded in blocks of Util::kBlockSize
+     *        postings and the tfs are quantized to one byte. kUNCOMPRESSED restores the plain arrays
+     *
+     * @param aCodec the codec
+     */
+    void compress(const POSTING_CODEC aCodec);
+    /**
+     * @brief Get the codec the posting is stored with
+     *
+     * @return POSTING_CODEC the codec
+     */
+    inline POSTING_CODEC getCodec() const { return _codec; }
+    /**
+     * @brief Whether the posting is stored compressed
+     *
+     * @return bool true if the posting is compressed
+     */
+    inline bool isCompressed() const { return _codec != kUNCOMPRESSED; }
+    /**
+     * @brief Get the number of blocks of Util::kBlockSize postings
+     *
+     * @return size_t the number of blocks
+     */
+    inline size_t getNoBlocks() const { return (size() + Util::kBlockSize - 1) / Util::kBlockSize; }
+    /**
+     * @brief Get the largest docID of block aBlock, used to skip blocks without decoding them
+     *
+     * @param aBlock the block
+     * @return size_t the last docID of the block
+     */
+    inline size_t getBlockLastID(const size_t aBlock) const {
+        return isCompressed() ? _blockLastIDs[aBlock] : _ids[std::min((aBlock + 1) * Util::kBlockSize, _ids.size()) - 1];
+    }
+    /**
+     * @brief Decode the docIDs of compressed block aBlock and append them to aIDs
+     *
+     * @param aBlock the block
+     * @param aIDs the output docIDs
+     */
+    void decodeBlock(const size_t aBlock, sizet_vt& aIDs) const;
+    /**
+     * @brief Decode the docIDs and tfs of compressed block aBlock and append them to aIDs and aTfs
+     *
+     * @param aBlock the block
+     * @param aIDs the output docIDs
+     * @param aTfs the output tfs, parallel to aIDs
+     */
+    void decodeBlock(const size_t aBlock, sizet_vt& aIDs, float_vt& aTfs) const;
+    /**
+     * @brief Decode all docIDs of the compressed posting and append them to aIDs
+     *
+     * @param aIDs the output docIDs
+     */
+    void decodeIDs(sizet_vt& aIDs) const;
+    /**
+     * @brief Compute the upper bounds of the score contributions tf-idf / norm length of the posting, for the whole
+     *        posting and for every block. Called after compression, so the bounds hold for the stored (quantized) tfs
+     *
+     * @param aDocNormLengths the norm lengths of the documents, indexed by docID
+     */
+    void computeScoreBounds(const float_vt& aDocNormLengths);
+    /**
+     * @brief Get the largest score contribution tf-idf / norm length of the posting, @see computeScoreBounds
+     *
+     * @return float the upper bound
+     */
+    inline float getMaxScore() const { return _maxScore; }
+    /**
+     * @brief Get the largest score contribution tf-idf / norm length of block aBlock, @see computeScoreBounds
+     *
+     * @param aBlock the block
+     * @return float the upper bound of the block
+     */
+    inline float getBlockMaxScore(const size_t aBlock) const { return _blockMaxScores[aBlock]; }
+    /**
+     * @brief Write the posting list (plain or compressed) with its score bounds to a snapshot
+     *
+     * @param aOut the output stream
+     */
+    void save(std::ostream& aOut) const;
+    /**
+     * @brief Restore a posting list written by @see save
+     *
+     * @param aReader the snapshot reader
+     */
+    void load(Util::BinaryReader& aReader);
+    /**
+     * @brief Get the number of bytes used by the docIDs and tfs of the posting
+     *
+     * @return size_t the number of bytes
+     */
+    size_t byteSize() const;
 
     /**
-     * @brief Set the term frequency from this terms posting list to tf for document with id aDocID
+     * @brief Set the term frequency from this terms posting list to tf for document with id aDocID.
+     *        Appending in ascending docID order (as during index construction) is O(1).
+     *        A compressed posting is decoded and compressed again
      *
      * @param aDocID the id of the document
      * @param aTf the term frequency to set
      */
-    inline void setTf(size_t aDocID, float aTf) { _posting[aDocID] = aTf; }
+    void setTf(size_t aDocID, float aTf);
     /**
      * @brief Set the inverse document frequency for this temr to aIdf
      *
@@ -78,10 +206,21 @@ class PostingList {
 
   private:
     float _idf;
-    sizet_float_mt _posting; // docID, Tf: [(1, 25), (2, 0), ...]
+    sizet_vt _ids; // docIDs, sorted: [1, 2, ...]
+    float_vt _tfs; // Tfs, parallel to _ids: [25, 0, ...]
+
+    POSTING_CODEC _codec = kUNCOMPRESSED;
+    size_t _noPostings = 0;  // number of postings if compressed
+    sizet_vt _blockLastIDs;  // last docID of each block
+    sizet_vt _blockOffsets;  // byte offset of each block in _data
+    byte_vt _blockWidths;    // bit width of each block (kBITPACK only)
+    byte_vt _data;           // encoded delta gaps
+    byte_vt _qtfs;           // quantized tfs, parallel to the postings
+
+    float _maxScore = 0;     // upper bound of tf-idf / norm length over all postings
+    float_vt _blockMaxScores; // upper bound of tf-idf / norm length per block
 };
 
-using str_postinglist_mt = std::unordered_map<std::string, PostingList>; // term, PostingList: [("Frodo", <PostingListObj>), ...]
-using posting_map_iter_t = str_postinglist_mt::iterator;
-using str_tierplmap_mt = std::unordered_map<std::string, std::map<size_t, PostingList>>; // term, <t1, PostingList>: [("Frodo", [(0, <PostingListObj>), (1, <PostingListObj>), ..]), ("Sam", ..), ..]
-using tiered_posting_map_iter_t = str_tierplmap_mt::iterator;
+using postinglist_vt = std::vector<PostingList>; // indexed by termID: [<PostingListObj of "Frodo">, <PostingListObj of "Sam">, ...]
+using tier_postinglist_mt = std::map<size_t, PostingList>; // tier, PostingList: [(0, <PostingListObj>), (1, <PostingListObj>), ..]
+using tierplmap_vt = std::vector<tier_postinglist_mt>; // indexed by termID: [[(0, <PostingListObj>), (1, <PostingListObj>), ..], ..]
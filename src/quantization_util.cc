@@ -0,0 +1,62 @@
+#include "quantization_util.hh"
+
+namespace Util {
+
+    uint16_t floatToHalf(const float aValue) {
+        uint32_t bits;
+        std::memcpy(&bits, &aValue, sizeof(bits));
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        const uint32_t exponent = (bits >> 23) & 0xFF;
+        uint32_t mantissa = bits & 0x7FFFFF;
+        if (exponent == 0xFF) { // inf or nan, a nan keeps a mantissa bit
+            return sign | 0x7C00 | ((mantissa != 0) ? 0x200 : 0);
+        }
+        const int32_t halfExponent = static_cast<int32_t>(exponent) - 112;
+        if (halfExponent >= 0x1F) { // overflow
+            return sign | 0x7C00;
+        }
+        if (halfExponent <= 0) { // subnormal or zero
+            if (halfExponent < -10) { return sign; }
+            mantissa |= 0x800000;
+            const uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+            uint32_t half = mantissa >> shift;
+            const uint32_t rest = mantissa & ((1u << shift) - 1);
+            const uint32_t halfway = 1u << (shift - 1);
+            if (rest > halfway || (rest == halfway && (half & 1))) { ++half; }
+            return sign | static_cast<uint16_t>(half);
+        }
+        uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        const uint32_t rest = mantissa & 0x1FFF;
+        if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) { ++half; } // a carry into the exponent is correct
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    float quantizeInt8(const float* aVec, const size_t aSize, int8_t* aOut) {
+        float maxAbs = 0;
+        for (size_t i = 0; i < aSize; ++i) {
+            maxAbs = std::max(maxAbs, std::fabs(aVec[i]));
+        }
+        const float scale = maxAbs / 127.0f;
+        for (size_t i = 0; i < aSize; ++i) {
+            aOut[i] = (scale > 0) ? static_cast<int8_t>(std::lround(aVec[i] / scale)) : 0;
+        }
+        return scale;
+    }
+
+    float dotHalf(const float* aVec, const uint16_t* aHalfs, const size_t aSize) {
+        float dot = 0;
+        for (size_t i = 0; i < aSize; ++i) {
+            dot += aVec[i] * halfToFloat(aHalfs[i]);
+        }
+        return dot;
+    }
+
+    float dotInt8(const float* aVec, const int8_t* aInts, const size_t aSize) {
+        float dot = 0;
+        for (size_t i = 0; i < aSize; ++i) {
+            dot += aVec[i] * static_cast<float>(aInts[i]);
+        }
+        return dot;
+    }
+
+} // namespace Util
@@ -0,0 +1,84 @@
+/*
+ * @file    quantization_util.hh
+ * @brief   Quantized embedding vectors. A vector is stored either as IEEE 754 half precision floats or as 8 bit
+ *          integers with one scale per vector (the largest absolute component maps to 127). The dot product
+ *          kernels take the other vector (the query) in full precision, so only the stored side loses precision
+ *
+ * @section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Util {
+
+    /**
+     * @brief Convert a float to half precision, rounding to the nearest even value
+     *
+     * @param aValue the float
+     * @return uint16_t the bits of the half
+     */
+    uint16_t floatToHalf(const float aValue);
+
+    /**
+     * @brief Convert a half precision float to a float, exact
+     *
+     * @param aHalf the bits of the half
+     * @return float the float
+     */
+    inline float halfToFloat(const uint16_t aHalf) {
+        const uint32_t sign = static_cast<uint32_t>(aHalf & 0x8000) << 16;
+        const uint32_t exponent = (aHalf >> 10) & 0x1F;
+        const uint32_t mantissa = aHalf & 0x3FF;
+        uint32_t bits;
+        if (exponent == 0x1F) { // inf or nan
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        } else if (exponent != 0) { // normal
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        } else { // zero or subnormal: mantissa * 2^-24
+            const float value = std::ldexp(static_cast<float>(mantissa), -24);
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits |= sign;
+        }
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    /**
+     * @brief Quantize aSize floats to 8 bit integers
+     *
+     * @param aVec the floats
+     * @param aSize the number of floats
+     * @param aOut the aSize output integers
+     * @return float the scale, a component is approximately aOut[i] * scale
+     */
+    float quantizeInt8(const float* aVec, const size_t aSize, int8_t* aOut);
+
+    /**
+     * @brief Dot product of a float vector with a half precision vector
+     *
+     * @param aVec the float vector
+     * @param aHalfs the half precision vector
+     * @param aSize the number of components
+     * @return float the dot product
+     */
+    float dotHalf(const float* aVec, const uint16_t* aHalfs, const size_t aSize);
+
+    /**
+     * @brief Dot product of a float vector with an 8 bit vector, without its scale
+     *
+     * @param aVec the float vector
+     * @param aInts the 8 bit vector
+     * @param aSize the number of components
+     * @return float the dot product, to be multiplied with the scale of aInts
+     */
+    float dotInt8(const float* aVec, const int8_t* aInts, const size_t aSize);
+
+} // namespace Util
@@ -0,0 +1,98 @@
+#include "quantized_vectors.hh"
+
+/**
+ * @brief Construct a new Quantized Vectors:: Quantized Vectors object
+ *
+ */
+QuantizedVectors::QuantizedVectors() :
+    _precision(kFP32),
+    _dimensions(0),
+    _noRows(0),
+    _floats(),
+    _halfs(),
+    _ints(),
+    _scales(),
+    _squaredLengths()
+{}
+
+void QuantizedVectors::reset(const EMBEDDING_PRECISION aPrecision, const size_t aDimensions) {
+    _precision = aPrecision;
+    _dimensions = aDimensions;
+    _noRows = 0;
+    _floats.clear();
+    _halfs.clear();
+    _ints.clear();
+    _scales.clear();
+    _squaredLengths.clear();
+}
+
+void QuantizedVectors::resize(const size_t aNoRows) {
+    _noRows = aNoRows;
+    switch (_precision) {
+        case kFP16: _halfs.resize(aNoRows * _dimensions, 0); break;
+        case kINT8:
+            _ints.resize(aNoRows * _dimensions, 0);
+            _scales.resize(aNoRows, 0);
+            break;
+        default: _floats.resize(aNoRows * _dimensions, 0); break;
+    }
+    _squaredLengths.resize(aNoRows, 0);
+}
+
+void QuantizedVectors::set(const size_t aRow, const float* aVec) {
+    if (aRow >= _noRows) {
+        this->resize(aRow + 1);
+    }
+    const size_t offset = aRow * _dimensions;
+    switch (_precision) {
+        case kFP16:
+            std::transform(aVec, aVec + _dimensions, _halfs.begin() + offset, Util::floatToHalf);
+            break;
+        case kINT8:
+            _scales[aRow] = Util::quantizeInt8(aVec, _dimensions, _ints.data() + offset);
+            break;
+        default:
+            std::copy(aVec, aVec + _dimensions, _floats.begin() + offset);
+            break;
+    }
+    float_vt dequantized(_dimensions, 0);
+    this->addTo(aRow, dequantized.data());
+    _squaredLengths[aRow] = this->dot(aRow, dequantized.data());
+}
+
+void QuantizedVectors::addTo(const size_t aRow, float* aOut) const {
+    if (aRow >= _noRows) { return; }
+    const size_t offset = aRow * _dimensions;
+    switch (_precision) {
+        case kFP16:
+            for (size_t i = 0; i < _dimensions; ++i) {
+                aOut[i] += Util::halfToFloat(_halfs[offset + i]);
+            }
+            break;
+        case kINT8:
+            for (size_t i = 0; i < _dimensions; ++i) {
+                aOut[i] += _ints[offset + i] * _scales[aRow];
+            }
+            break;
+        default:
+            for (size_t i = 0; i < _dimensions; ++i) {
+                aOut[i] += _floats[offset + i];
+            }
+            break;
+    }
+}
+
+float QuantizedVectors::dot(const size_t aRow, const float* aVec) const {
+    if (aRow >= _noRows) { return 0; }
+    const size_t offset = aRow * _dimensions;
+    switch (_precision) {
+        case kFP16: return Util::dotHalf(aVec, _halfs.data() + offset, _dimensions);
+        case kINT8: return Util::dotInt8(aVec, _ints.data() + offset, _dimensions) * _scales[aRow];
+        default: return static_cast<float>(Util::dot(aVec, _floats.data() + offset, _dimensions));
+    }
+}
+
+size_t QuantizedVectors::memoryBytes() const {
+    return _floats.size() * sizeof(float) + _halfs.size() * sizeof(uint16_t) + _ints.size() * sizeof(int8_t)
+           + (_scales.size() + _squaredLengths.size()) * sizeof(float);
+}
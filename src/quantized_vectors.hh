@@ -0,0 +1,89 @@
+/**
+ *	@file 	quantized_vectors.hh
+ *	@brief  Implements a table of dense vectors of one length in a chosen precision (float, half or 8 bit with a
+ *          scale per row), stored contiguously row after row. Used for the word embeddings of the terms and for the
+ *          embedding vectors of the documents
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "quantization_util.hh"
+#include "simd_util.hh"
+#include "types.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class QuantizedVectors {
+  public:
+    QuantizedVectors();
+    QuantizedVectors(const QuantizedVectors&) = delete;
+    QuantizedVectors(QuantizedVectors&&) = delete;
+    QuantizedVectors& operator=(const QuantizedVectors&) = delete;
+    QuantizedVectors& operator=(QuantizedVectors&&) = delete;
+    ~QuantizedVectors() = default;
+
+  public:
+    /**
+     * @brief Remove all rows and set the precision and the length of the rows
+     *
+     * @param aPrecision the precision
+     * @param aDimensions the number of components of every row
+     */
+    void reset(const EMBEDDING_PRECISION aPrecision, const size_t aDimensions);
+    /**
+     * @brief Set row aRow, the table grows with zero rows if needed
+     *
+     * @param aRow the row
+     * @param aVec the dimensions() components
+     */
+    void set(const size_t aRow, const float* aVec);
+    /**
+     * @brief Add the (dequantized) row aRow to aOut
+     *
+     * @param aRow the row
+     * @param aOut the dimensions() components to add to
+     */
+    void addTo(const size_t aRow, float* aOut) const;
+    /**
+     * @brief Dot product of the (dequantized) row aRow with aVec
+     *
+     * @param aRow the row
+     * @param aVec the dimensions() components of the other vector
+     * @return float the dot product, 0 for a row which was never set
+     */
+    float dot(const size_t aRow, const float* aVec) const;
+    /**
+     * @brief Get the squared length of the (dequantized) row aRow
+     *
+     * @param aRow the row
+     * @return float the squared length, 0 for a row which was never set
+     */
+    inline float squaredLength(const size_t aRow) const { return (aRow < _noRows) ? _squaredLengths[aRow] : 0; }
+
+    inline EMBEDDING_PRECISION precision() const { return _precision; }
+    inline size_t dimensions() const { return _dimensions; }
+    inline size_t size() const { return _noRows; }
+    /**
+     * @brief Get the memory used by the rows
+     *
+     * @return size_t the bytes of the components, scales and lengths
+     */
+    size_t memoryBytes() const;
+
+  private:
+    void resize(const size_t aNoRows);
+
+  private:
+    EMBEDDING_PRECISION _precision;
+    size_t _dimensions;
+    size_t _noRows;
+    float_vt _floats;                   // kFP32 components
+    std::vector<uint16_t> _halfs;       // kFP16 components
+    std::vector<int8_t> _ints;          // kINT8 components
+    float_vt _scales;                   // kINT8 scale of every row
+    float_vt _squaredLengths;           // of every dequantized row
+};
@@ -16,27 +16,50 @@ void QueryExecutionEngine::init(const control_block_t& aControlBlock) {
     }
 }
 
-const pair_sizet_float_vt QueryExecutionEngine::search(std::string& query, size_t topK, IR_MODE searchType) {
+const pair_sizet_float_vt QueryExecutionEngine::search(std::string& query, size_t topK, IR_MODE searchType, size_t searchWidth) {
+    std::shared_lock<std::shared_mutex> lock(IndexManager::getInstance().getMutex()); // the query is weighted with the live idf
     Document queryDoc = QueryManager::getInstance().createQueryDoc(query, "query-0", true);
-    return this->search(queryDoc, topK, searchType);
+    return this->searchLocked(queryDoc, topK, searchType, searchWidth);
 }
 
-const pair_sizet_float_vt QueryExecutionEngine::search(Document& queryDoc, size_t topK, IR_MODE searchType) {
+const pair_sizet_float_vt QueryExecutionEngine::search(Document& queryDoc, size_t topK, IR_MODE searchType, size_t searchWidth) {
+    std::shared_lock<std::shared_mutex> lock(IndexManager::getInstance().getMutex());
+    return this->searchLocked(queryDoc, topK, searchType, searchWidth);
+}
+
+const pair_sizet_float_vt QueryExecutionEngine::searchLocked(Document& queryDoc, size_t topK, IR_MODE searchType, size_t searchWidth) {
     pair_sizet_float_vt found_indices; // result vector
 
     if (queryDoc.getContent().size() == 0) { // if content is empty stop searching
         return found_indices;
     }
 
+    termid_vt queryTermIDs; // the distinct ids of the query terms which appear in the collection
+    queryTermIDs.reserve(queryDoc.getTermTfVector().size());
+    for (const auto& elem : queryDoc.getTermTfVector()) {
+        queryTermIDs.push_back(elem.first);
+    }
+
+    const auto vanillaCandidates = [&queryTermIDs]() { // the inverted index includes the mutable segment
+        sizet_vt candidates = IndexManager::getInstance().getInvertedIndex().getDocIDList(queryTermIDs);
+        IndexManager::getInstance().removeDeleted(candidates);
+        return candidates;
+    };
+    const auto tieredCandidates = [this, &queryTermIDs](size_t topK) {
+        sizet_vt candidates = IndexManager::getInstance().getTieredIndex().getDocIDList(topK, queryTermIDs);
+        this->addSegmentCandidates(queryTermIDs, candidates);
+        return candidates;
+    };
+
     switch (searchType) {
     case IR_MODE ::kVANILLA: {
-        found_indices = this->searchCollectionCos(&queryDoc, IndexManager::getInstance().getInvertedIndex().getDocIDList(queryDoc.getContent()), topK);
+        found_indices = this->searchCollectionCos(&queryDoc, vanillaCandidates(), topK);
     } break;
     case IR_MODE::kVANILLA_RAND: {
-        found_indices = this->searchRandomProjCos(&queryDoc, IndexManager::getInstance().getInvertedIndex().getDocIDList(queryDoc.getContent()), topK);
+        found_indices = this->searchRandomProjCos(&queryDoc, vanillaCandidates(), topK);
     } break;
     case IR_MODE::kVANILLA_W2V: {
-        found_indices = this->searchCollectionCos(&queryDoc, IndexManager::getInstance().getInvertedIndex().getDocIDList(queryDoc.getContent()), topK, true);
+        found_indices = this->searchCollectionCos(&queryDoc, vanillaCandidates(), topK, true);
     } break;
     case IR_MODE ::kCLUSTER: {
         std::vector<std::pair<size_t, float>> leader_indexes = this->searchClusterCos(&queryDoc, IndexManager::getInstance().getClusteredIndex().getLeaders(), 0);
@@ -44,6 +67,9 @@ const pair_sizet_float_vt QueryExecutionEngine::search(Document& queryDoc, size_
         // Get docIds from the clusters to search in, vector will be filled from the IndexManager::getInstance().getClusteredIndex().getIDs() method
         sizet_vt clusterDocIds;
         IndexManager::getInstance().getClusteredIndex().getIDs(leader_indexes, topK, clusterDocIds);
+        std::sort(clusterDocIds.begin(), clusterDocIds.end()); // a leader appears twice in its own cluster
+        clusterDocIds.erase(std::unique(clusterDocIds.begin(), clusterDocIds.end()), clusterDocIds.end());
+        IndexManager::getInstance().removeDeleted(clusterDocIds);
 
         // Search the docs from the clusters
         found_indices = this->searchClusterCos(&queryDoc, clusterDocIds, topK);
@@ -55,6 +81,9 @@ const pair_sizet_float_vt QueryExecutionEngine::search(Document& queryDoc, size_
         // Get docIds from the clusters to search in, vector will be filled from the IndexManager::getInstance().getClusteredIndex().getIDs() method
         sizet_vt clusterDocIds;
         IndexManager::getInstance().getClusteredIndex().getIDs(leader_indexes, topK, clusterDocIds);
+        std::sort(clusterDocIds.begin(), clusterDocIds.end()); // a leader appears twice in its own cluster
+        clusterDocIds.erase(std::unique(clusterDocIds.begin(), clusterDocIds.end()), clusterDocIds.end());
+        IndexManager::getInstance().removeDeleted(clusterDocIds);
 
         // Search the docs from the clusters
         found_indices = this->searchRandomProjCos(&queryDoc, clusterDocIds, topK);
@@ -66,17 +95,41 @@ const pair_sizet_float_vt QueryExecutionEngine::search(Document& queryDoc, size_
         // Get docIds from the clusters to search in, vector will be filled from the IndexManager::getInstance().getClusteredIndex().getIDs() method
         sizet_vt clusterDocIds;
         IndexManager::getInstance().getClusteredIndex().getIDs(leader_indexes, topK, clusterDocIds);
+        std::sort(clusterDocIds.begin(), clusterDocIds.end()); // a leader appears twice in its own cluster
+        clusterDocIds.erase(std::unique(clusterDocIds.begin(), clusterDocIds.end()), clusterDocIds.end());
+        IndexManager::getInstance().removeDeleted(clusterDocIds);
         // Search the docs from the clusters
         found_indices = this->searchClusterCos(&queryDoc, clusterDocIds, topK, true);
     } break;
     case IR_MODE ::kTIERED: {
-        found_indices = this->searchTieredCos(&queryDoc, IndexManager::getInstance().getTieredIndex().getDocIDList(topK, queryDoc.getContent()), topK);
+        found_indices = this->searchTieredCos(&queryDoc, tieredCandidates(topK), topK);
     } break;
     case IR_MODE::kTIERED_RAND: {
-        found_indices = this->searchRandomProjCos(&queryDoc, IndexManager::getInstance().getTieredIndex().getDocIDList(topK, queryDoc.getContent()), topK);
+        found_indices = this->searchRandomProjCos(&queryDoc, tieredCandidates(topK), topK);
     } break;
     case IR_MODE::kTIERED_W2V: {
-        found_indices = this->searchTieredCos(&queryDoc, IndexManager::getInstance().getTieredIndex().getDocIDList(topK, queryDoc.getContent()), topK, true);
+        found_indices = this->searchTieredCos(&queryDoc, tieredCandidates(topK), topK, true);
+    } break;
+    case IR_MODE::kVANILLA_TAAT: {
+        found_indices = this->searchCollectionTaat(&queryDoc, topK);
+    } break;
+    case IR_MODE::kVANILLA_WAND: {
+        found_indices = this->searchCollectionWand(&queryDoc, topK);
+    } break;
+    case IR_MODE::kVANILLA_BMW: {
+        found_indices = this->searchCollectionWand(&queryDoc, topK, true);
+    } break;
+    case IR_MODE::kVANILLA_MAXSCORE: {
+        found_indices = this->searchCollectionMaxScore(&queryDoc, topK);
+    } break;
+    case IR_MODE::kHNSW_W2V: {
+        found_indices = this->searchHnsw(&queryDoc, topK, (searchWidth != 0) ? searchWidth : _cb->hnswEfSearch());
+    } break;
+    case IR_MODE::kIVFPQ_W2V: {
+        found_indices = this->searchIvfPq(&queryDoc, topK, (searchWidth != 0) ? searchWidth : _cb->ivfNprobe());
+    } break;
+    case IR_MODE::kLSH_RAND: {
+        found_indices = this->searchLsh(&queryDoc, topK, (searchWidth != 0) ? searchWidth : _cb->lshProbes());
     } break;
     case IR_MODE ::kNoMode: break;
     case IR_MODE ::kNumberOfModes: break;
@@ -87,81 +140,259 @@ const pair_sizet_float_vt QueryExecutionEngine::search(Document& queryDoc, size_
 
 const pair_sizet_float_vt QueryExecutionEngine::searchCollectionCos(const Document* query, const sizet_vt& collectionIds, size_t topK, bool use_w2v) {
 
-    std::map<size_t, float> docId2Length;
-    for (auto& elem : collectionIds) { // Map of doc id to length og that doc
-        docId2Length[elem] = DocumentManager::getInstance().getDocumentMap().at(elem).getNormLength();
-    }
-    std::map<size_t, float> docId2Scores;
+    TopKCollector topKCollector(topK);
     
     // if we are using w2v we can not use our posting list, instead we have to use the normal tfidf vectors + the document word embedding vector
     if (use_w2v) {
-        float_vt queryWordEmbedding = Util::combineVectors((*query).getTfIdfVector(), ((*query).getWordEmbeddingsVector()));
+        const double queryLength = Util::combinedVectorLength(query->getTfIdfVector(), query->getWordEmbeddingsVector());
         for (auto& elem : collectionIds) {
-            float sim = Util::calcCosSim(queryWordEmbedding,Util::combineVectors(DocumentManager::getInstance().getDocument(elem).getTfIdfVector(), DocumentManager::getInstance().getDocument(elem).getWordEmbeddingsVector()));
-            docId2Scores[elem] = sim;
+            const Document& doc = DocumentManager::getInstance().getDocument(elem);
+            float sim = this->calcW2VCosSim(query, queryLength, doc, elem);
+            topKCollector.push(elem, sim / doc.getNormLength()); // Divide every score of a doc by the length of the document
         }
     } else {
-
+        const double queryLength = Util::vectorLength(query->getTfIdfVector()); // the lengths of the documents are stored
         for (auto& elem : collectionIds) {
-            
-            float sim = Util::calcCosSim(*query, DocumentManager::getInstance().getDocument(elem));
-            docId2Scores[elem] = sim;
-        }
-
-        /* Efficient Vanilla VSM Algorithm, not used for comparison reasons
-        const string_vt& qcontent = query->getContent();
-        for (const auto& term : qcontent) { // Calculate weightings per doc using the tf-idf of the word in the doc collection times the tf-idf of the term in the query
-            try {
-                const PostingList& postingList = IndexManager::getInstance().getInvertedIndex().getPostingList(term);
-                for (auto& [id, tf] : postingList.getPosting()) {
-                    float idf = IndexManager::getInstance().getIdf(term);
-                    docId2Scores[id] += (tf * idf * (query->getTf(term) * idf));
+            const Document& doc = DocumentManager::getInstance().getDocument(elem);
+            float sim = Util::calcCosSim(query->getTfIdfVector(), queryLength, doc.getTfIdfVector(), doc.getNormLength());
+            topKCollector.push(elem, sim / doc.getNormLength()); // Divide every score of a doc by the length of the document
+        }
+    }
+    return topKCollector.finish();
+}
+
+const pair_sizet_float_vt QueryExecutionEngine::searchCollectionTaat(const Document* query, size_t topK) {
+
+    const float_vt& normLengths = IndexManager::getInstance().getNormLengthVector(); // indexed by doc id
+    const double queryLength = query->getNormLength();
+    if (normLengths.empty() || queryLength == 0) {
+        return pair_sizet_float_vt();
+    }
+
+    const InvertedIndex& index = IndexManager::getInstance().getInvertedIndex();
+    ScoreAccumulator& accumulator = ScoreAccumulator::getInstance(); // reused by all queries of this thread
+    accumulator.reset(normLengths.size());
+
+    thread_local sizet_vt blockIDs;
+    thread_local float_vt blockTfs;
+    for (const auto& [termID, queryWeight] : query->getTfIdfVector()) { // term at a time: one posting list after the other
+        const PostingList& postingList = index.getPostingList(termID);
+        const float idf = postingList.getIdf();
+        auto accumulate = [&](const sizet_vt& ids, const float_vt& tfs) {
+            for (size_t i = 0; i < ids.size(); ++i) {
+                accumulator.add(ids[i], Util::calcTfIdf(tfs[i], idf) * queryWeight);
+            }
+        };
+        if (postingList.isCompressed()) {
+            for (size_t block = 0; block < postingList.getNoBlocks(); ++block) {
+                blockIDs.clear();
+                blockTfs.clear();
+                postingList.decodeBlock(block, blockIDs, blockTfs);
+                accumulate(blockIDs, blockTfs);
+            }
+        } else {
+            accumulate(postingList.getIDs(), postingList.getTfs());
+        }
+        if (termID < index.getSegmentPostingLists().size()) { // the documents added since the last merge
+            const PostingList& segmentList = index.getSegmentPostingLists()[termID];
+            accumulate(segmentList.getIDs(), segmentList.getTfs());
+        }
+    }
+
+    const IndexManager& indexManager = IndexManager::getInstance();
+    TopKCollector topKCollector(topK);
+    for (const size_t id : accumulator.getTouched()) { // Divide every score of a doc by the length of the document and the query
+        if (indexManager.isDeleted(id)) { continue; }
+        const double docLength = normLengths[id];
+        topKCollector.push(id, (docLength == 0) ? 0 : static_cast<float>(accumulator.get(id) / (docLength * queryLength)));
+    }
+    return topKCollector.finish();
+}
+
+const pair_sizet_float_vt QueryExecutionEngine::searchCollectionWand(const Document* query, size_t topK, bool use_block_max) {
+
+    if (!topK) { // without a top-k there is nothing to prune
+        return this->searchCollectionTaat(query, topK);
+    }
+    const float_vt& normLengths = IndexManager::getInstance().getNormLengthVector(); // indexed by doc id
+    const double queryLength = query->getNormLength();
+    if (normLengths.empty() || queryLength == 0) {
+        return pair_sizet_float_vt();
+    }
+
+    const IndexManager& indexManager = IndexManager::getInstance();
+    const InvertedIndex& index = indexManager.getInvertedIndex();
+    const sparse_vt& queryVec = query->getTfIdfVector();
+    std::vector<PostingCursor> cursors; // in termID order, so the scores are summed up in the same order as in the TAAT search
+    float_vt weights;
+    float_vt upperBounds;
+    cursors.reserve(queryVec.size());
+    for (const auto& [termID, queryWeight] : queryVec) {
+        const PostingList& postingList = index.getPostingList(termID);
+        cursors.emplace_back(postingList);
+        weights.push_back(queryWeight);
+        upperBounds.push_back(queryWeight * postingList.getMaxScore());
+    }
+
+    constexpr double kBoundSlack = 1.0001; // covers the rounding of the precomputed upper bounds
+    TopKCollector topKCollector(topK);
+    auto canEnter = [&](const double bound) { return topKCollector.canEnter(static_cast<float>(bound * kBoundSlack / queryLength)); };
+
+    sizet_vt order(cursors.size()); // cursor indexes, sorted by the current docID of the cursor
+    std::iota(order.begin(), order.end(), 0);
+    while (true) {
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return cursors[a].doc() < cursors[b].doc(); });
+
+        // find the pivot, the first cursor at which the upper bounds of all cursors up to it can beat the top-k
+        double boundSum = 0;
+        size_t pivot = 0;
+        for (; pivot < order.size() && cursors[order[pivot]].doc() != PostingCursor::kEnd; ++pivot) {
+            boundSum += upperBounds[order[pivot]];
+            if (canEnter(boundSum)) { break; }
+        }
+        if (pivot == order.size() || cursors[order[pivot]].doc() == PostingCursor::kEnd) { break; }
+        const size_t pivotDoc = cursors[order[pivot]].doc();
+        while (pivot + 1 < order.size() && cursors[order[pivot + 1]].doc() == pivotDoc) { ++pivot; }
+
+        if (use_block_max && topKCollector.full()) { // check the tighter bounds of the blocks which may contain the pivot
+            double blockSum = 0;
+            size_t nextDoc = (pivot + 1 < order.size()) ? cursors[order[pivot + 1]].doc() : PostingCursor::kEnd;
+            for (size_t i = 0; i <= pivot; ++i) {
+                const PostingCursor& cursor = cursors[order[i]];
+                const size_t block = cursor.findBlock(pivotDoc);
+                if (block < cursor.getPostingList().getNoBlocks()) {
+                    blockSum += weights[order[i]] * cursor.getPostingList().getBlockMaxScore(block);
+                    nextDoc = std::min(nextDoc, cursor.getPostingList().getBlockLastID(block) + 1);
                 }
-            } catch (const InvalidArgumentException& e) { continue; } // One of the query terms does not appear in the document collection.
-        }*/
+            }
+            if (!canEnter(blockSum)) { // no document up to the end of these blocks can beat the top-k
+                for (size_t i = 0; i <= pivot; ++i) {
+                    cursors[order[i]].nextGEQ(nextDoc);
+                }
+                continue;
+            }
+        }
+
+        if (cursors[order[0]].doc() == pivotDoc) { // all cursors up to the pivot point to the pivot, score it
+            float score = 0;
+            for (size_t c = 0; c < cursors.size(); ++c) {
+                if (cursors[c].doc() == pivotDoc) { score += Util::calcTfIdf(cursors[c].tf(), cursors[c].getPostingList().getIdf()) * weights[c]; }
+            }
+            const double docLength = normLengths[pivotDoc];
+            if (!indexManager.isDeleted(pivotDoc)) { topKCollector.push(pivotDoc, (docLength == 0) ? 0 : static_cast<float>(score / (docLength * queryLength))); }
+            for (size_t i = 0; i <= pivot; ++i) {
+                cursors[order[i]].next();
+            }
+        } else { // move the cursors in front of the pivot to the pivot
+            for (size_t i = 0; i < pivot && cursors[order[i]].doc() < pivotDoc; ++i) {
+                cursors[order[i]].nextGEQ(pivotDoc);
+            }
+        }
     }
-    
-    for (const auto& elem : docId2Length) { // Divide every score of a doc by the length of the document
-        docId2Scores[elem.first] = docId2Scores[elem.first] / docId2Length[elem.first];
+
+    this->searchSegment(query, queryLength, topKCollector);
+    return topKCollector.finish();
+}
+
+const pair_sizet_float_vt QueryExecutionEngine::searchCollectionMaxScore(const Document* query, size_t topK) {
+
+    if (!topK) { // without a top-k there is nothing to prune
+        return this->searchCollectionTaat(query, topK);
+    }
+    const float_vt& normLengths = IndexManager::getInstance().getNormLengthVector(); // indexed by doc id
+    const double queryLength = query->getNormLength();
+    if (normLengths.empty() || queryLength == 0) {
+        return pair_sizet_float_vt();
+    }
+
+    const IndexManager& indexManager = IndexManager::getInstance();
+    const InvertedIndex& index = indexManager.getInvertedIndex();
+    const sparse_vt& queryVec = query->getTfIdfVector();
+    std::vector<PostingCursor> cursors; // in termID order, so the scores are summed up in the same order as in the TAAT search
+    float_vt weights;
+    float_vt upperBounds;
+    cursors.reserve(queryVec.size());
+    for (const auto& [termID, queryWeight] : queryVec) {
+        const PostingList& postingList = index.getPostingList(termID);
+        cursors.emplace_back(postingList);
+        weights.push_back(queryWeight);
+        upperBounds.push_back(queryWeight * postingList.getMaxScore());
     }
 
-    std::vector<std::pair<size_t, float>> results;
-    for (const auto& elem : docId2Scores) { // Convert map into vector of pairs
-        results.push_back(elem);
+    sizet_vt order(cursors.size()); // cursor indexes, sorted ascending by the upper bound of the term
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return upperBounds[a] < upperBounds[b]; });
+    std::vector<double> prefixBounds(order.size()); // prefixBounds[i] = sum of the upper bounds of order[0..i]
+    double boundSum = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        boundSum += upperBounds[order[i]];
+        prefixBounds[i] = boundSum;
+    }
+
+    constexpr double kBoundSlack = 1.0001; // covers the rounding of the precomputed upper bounds
+    TopKCollector topKCollector(topK);
+    auto canEnter = [&](const double bound) { return topKCollector.canEnter(static_cast<float>(bound * kBoundSlack / queryLength)); };
+
+    size_t firstEssential = 0; // order[0..firstEssential) are the non-essential terms
+    while (firstEssential < order.size()) {
+        size_t candidate = PostingCursor::kEnd; // the next document of the essential terms
+        for (size_t i = firstEssential; i < order.size(); ++i) {
+            candidate = std::min(candidate, cursors[order[i]].doc());
+        }
+        if (candidate == PostingCursor::kEnd) { break; }
+
+        const double docLength = normLengths[candidate];
+        auto contribution = [&](const size_t aCursor) { // in the unit of the upper bounds, i.e. divided by the norm
+            const PostingCursor& cursor = cursors[aCursor];
+            return (cursor.doc() != candidate || docLength == 0) ? 0 : Util::calcTfIdf(cursor.tf(), cursor.getPostingList().getIdf()) * weights[aCursor] / docLength;
+        };
+        double bound = 0; // the contributions of the essential terms plus the upper bounds of the non-essential terms
+        for (size_t i = firstEssential; i < order.size(); ++i) {
+            bound += contribution(order[i]);
+        }
+        bound += (firstEssential > 0) ? prefixBounds[firstEssential - 1] : 0;
+        for (size_t i = firstEssential; i-- > 0 && canEnter(bound);) { // probe the non-essential terms, largest bound first
+            cursors[order[i]].nextGEQ(candidate);
+            bound -= upperBounds[order[i]];
+            bound += contribution(order[i]);
+        }
+
+        if (canEnter(bound)) {
+            float score = 0;
+            for (size_t c = 0; c < cursors.size(); ++c) {
+                if (cursors[c].doc() == candidate) { score += Util::calcTfIdf(cursors[c].tf(), cursors[c].getPostingList().getIdf()) * weights[c]; }
+            }
+            if (!indexManager.isDeleted(candidate)) { topKCollector.push(candidate, (docLength == 0) ? 0 : static_cast<float>(score / (docLength * queryLength))); }
+            while (firstEssential < order.size() && !canEnter(prefixBounds[firstEssential])) { // the threshold only grows
+                ++firstEssential;
+            }
+        }
+        for (size_t i = firstEssential; i < order.size(); ++i) {
+            if (cursors[order[i]].doc() == candidate) { cursors[order[i]].next(); }
+        }
     }
 
-    // Sort vector desc
-    std::sort(results.begin(), results.end(), [](std::pair<size_t, float> elem1, std::pair<size_t, float> elem2) { return elem1.second > elem2.second; });
-    return (!topK || topK > results.size()) ? results : std::vector<std::pair<size_t, float>>(results.begin(), results.begin() + topK);
+    this->searchSegment(query, queryLength, topKCollector);
+    return topKCollector.finish();
 }
 
 const pair_sizet_float_vt QueryExecutionEngine::searchClusterCos(const Document* query, const sizet_vt& collectionIds, size_t topK, bool use_w2v) {
 
-    std::map<size_t, float> docId2Scores;
+    TopKCollector topKCollector(topK);
 
-    if (use_w2v){
-        float_vt queryWordEmbedding = Util::combineVectors((*query).getTfIdfVector(), ((*query).getWordEmbeddingsVector()));
+    if (use_w2v) {
+        const double queryLength = Util::combinedVectorLength(query->getTfIdfVector(), query->getWordEmbeddingsVector());
         for (auto& elem : collectionIds) {
-            float sim = Util::calcCosSim(queryWordEmbedding,
-                                        Util::combineVectors(DocumentManager::getInstance().getDocument(elem).getTfIdfVector(), DocumentManager::getInstance().getDocument(elem).getWordEmbeddingsVector()));
-            docId2Scores[elem] = sim;
+            topKCollector.push(elem, this->calcW2VCosSim(query, queryLength, DocumentManager::getInstance().getDocument(elem), elem));
         }
     } else {
+        const double queryLength = Util::vectorLength(query->getTfIdfVector()); // the lengths of the documents are stored
         for (auto& elem : collectionIds) {
-            float sim = Util::calcCosSim(*query, DocumentManager::getInstance().getDocument(elem));
-            docId2Scores[elem] = sim;
+            const Document& doc = DocumentManager::getInstance().getDocument(elem);
+            topKCollector.push(elem, Util::calcCosSim(query->getTfIdfVector(), queryLength, doc.getTfIdfVector(), doc.getNormLength()));
         }
     }
-   
-    // Convert map into vector of pairs
-    std::vector<std::pair<size_t, float>> results;
-    for (const auto& elem : docId2Scores) {
-        results.push_back(elem);
-    }
-
-    // Sort vector desc
-    std::sort(results.begin(), results.end(), [](std::pair<size_t, float> elem1, std::pair<size_t, float> elem2) { return elem1.second > elem2.second; });
-    return (!topK || topK > results.size()) ? results : std::vector<std::pair<size_t, float>>(results.begin(), results.begin() + topK);
+    return topKCollector.finish();
 }
 
 size_t QueryExecutionEngine::searchClusterCosFirstIndex(const Document* query, const sizet_vt& collectionIds) {
@@ -170,47 +401,109 @@ size_t QueryExecutionEngine::searchClusterCosFirstIndex(const Document* query, c
 
 const pair_sizet_float_vt QueryExecutionEngine::searchTieredCos(const Document* query, const sizet_vt& collectionIds, size_t topK, bool use_w2v) {
 
-    std::map<size_t, float> docId2Scores;
+    TopKCollector topKCollector(topK);
 
-     if (use_w2v){
-        float_vt queryWordEmbedding = Util::combineVectors((*query).getTfIdfVector(), ((*query).getWordEmbeddingsVector()));
+    if (use_w2v) {
+        const double queryLength = Util::combinedVectorLength(query->getTfIdfVector(), query->getWordEmbeddingsVector());
         for (auto& elem : collectionIds) {
-            float sim = Util::calcCosSim(queryWordEmbedding,
-                                         Util::combineVectors(DocumentManager::getInstance().getDocument(elem).getTfIdfVector(), DocumentManager::getInstance().getDocument(elem).getWordEmbeddingsVector()));
-            docId2Scores[elem] = sim;
+            topKCollector.push(elem, this->calcW2VCosSim(query, queryLength, DocumentManager::getInstance().getDocument(elem), elem));
         }
     } else {
+        const double queryLength = Util::vectorLength(query->getTfIdfVector()); // the lengths of the documents are stored
         for (auto& elem : collectionIds) {
-            float sim = Util::calcCosSim(*query, DocumentManager::getInstance().getDocument(elem));
-            docId2Scores[elem] = sim;
+            const Document& doc = DocumentManager::getInstance().getDocument(elem);
+            topKCollector.push(elem, Util::calcCosSim(query->getTfIdfVector(), queryLength, doc.getTfIdfVector(), doc.getNormLength()));
         }
     }
+    return topKCollector.finish();
+}
 
-    // Convert map into vector of pairs
-    std::vector<std::pair<size_t, float>> results;
-    for (const auto& elem : docId2Scores) {
-        results.push_back(elem);
+const pair_sizet_float_vt QueryExecutionEngine::searchHnsw(const Document* query, size_t topK, size_t efSearch) {
+    const IndexManager& indexManager = IndexManager::getInstance();
+    pair_sizet_float_vt found;
+    // deleted documents stay in the graph to route the search, widen the candidate list until topK live ones are found
+    for (size_t ef = std::max(topK, efSearch);; ef *= 2) {
+        found = indexManager.getHnswIndex().search(query->getWordEmbeddingsVector(), topK, ef);
+        const size_t noCandidates = found.size();
+        found.erase(std::remove_if(found.begin(), found.end(), [&indexManager](const auto& elem) { return indexManager.isDeleted(elem.first); }), found.end());
+        if (topK == 0 || found.size() >= topK || noCandidates < ef) { // noCandidates < ef: every reachable node was found
+            break;
+        }
+    }
+    if (topK != 0 && found.size() > topK) {
+        found.resize(topK);
     }
+    return found;
+}
+
+const pair_sizet_float_vt QueryExecutionEngine::searchIvfPq(const Document* query, size_t topK, size_t nprobe) {
+    return IndexManager::getInstance().getIvfPqIndex().search(query->getWordEmbeddingsVector(), topK, nprobe); // deleted documents are removed from the lists
+}
 
-    // Sort vector desc
-    std::sort(results.begin(), results.end(), [](std::pair<size_t, float> elem1, std::pair<size_t, float> elem2) { return elem1.second > elem2.second; });
-    return (!topK || topK > results.size()) ? results : std::vector<std::pair<size_t, float>>(results.begin(), results.begin() + topK);
+const pair_sizet_float_vt QueryExecutionEngine::searchLsh(const Document* query, size_t topK, size_t probes) {
+    const IndexManager& indexManager = IndexManager::getInstance();
+    std::vector<uint64_t> packedQuery(indexManager.getSignatures().words());
+    indexManager.getSignatures().pack(query->getRandProjVec(), packedQuery.data());
+    // deleted documents are removed from the buckets
+    return this->searchRandomProjCos(query, indexManager.getLshIndex().search(packedQuery.data(), probes), topK);
+}
+
+float QueryExecutionEngine::calcW2VCosSim(const Document* query, const double queryLength, const Document& doc, const size_t docID) const {
+    IndexManager& indexManager = IndexManager::getInstance();
+    const double docLength = indexManager.getW2VNormLengthVector()[docID];
+    if (_cb->embeddingPrecision() == kFP32) {
+        return Util::calcCombinedCosSim(query->getTfIdfVector(), query->getWordEmbeddingsVector(), queryLength, doc.getTfIdfVector(), doc.getWordEmbeddingsVector(), docLength);
+    }
+    if (queryLength == 0 || docLength == 0) { // the document vector is in the quantized table of the IndexManager
+        return 0;
+    }
+    const double dot = Util::scalar_product(query->getTfIdfVector(), doc.getTfIdfVector()) + indexManager.getDocumentVectors().dot(docID, query->getWordEmbeddingsVector().data());
+    return static_cast<float>(dot / (queryLength * docLength));
 }
 
 const pair_sizet_float_vt QueryExecutionEngine::searchRandomProjCos(const Document* query, const sizet_vt& collectionIds, size_t topK) {
 
-    std::map<size_t, float> docId2Scores;
-    for (auto& elem : collectionIds) {
-        docId2Scores[elem] = Util::calcHammingDist(query->getRandProjVec(),DocumentManager::getInstance().getDocumentMap().at(elem).getRandProjVec());
+    const PackedSignatures& signatures = IndexManager::getInstance().getSignatures();
+    std::vector<uint64_t> packedQuery(signatures.words());
+    signatures.pack(query->getRandProjVec(), packedQuery.data());
+    std::vector<uint32_t> distances(collectionIds.size());
+    signatures.hammingDistances(packedQuery.data(), collectionIds, distances.data()); // one scan over the packed rows
+
+    TopKCollector topKCollector(topK, true); // ascending as this is a DISTANCE measure
+    for (size_t i = 0; i < collectionIds.size(); ++i) {
+        topKCollector.push(collectionIds[i], static_cast<float>(distances[i]));
     }
+    return topKCollector.finish();
+}
 
-    // Convert map into vector of pairs
-    std::vector<std::pair<size_t, float>> results;
-    for (const auto& elem : docId2Scores) {
-        results.push_back(elem);
+void QueryExecutionEngine::searchSegment(const Document* query, const double queryLength, TopKCollector& topKCollector) {
+    const IndexManager& indexManager = IndexManager::getInstance();
+    const InvertedIndex& index = indexManager.getInvertedIndex();
+    const postinglist_vt& segmentLists = index.getSegmentPostingLists();
+    const float_vt& normLengths = IndexManager::getInstance().getNormLengthVector();
+    ScoreAccumulator& accumulator = ScoreAccumulator::getInstance(); // free again once the main lists are searched
+    accumulator.reset(normLengths.size());
+    for (const auto& [termID, queryWeight] : query->getTfIdfVector()) { // in termID order, as in the TAAT search
+        if (termID >= segmentLists.size()) { continue; }
+        const PostingList& segmentList = segmentLists[termID];
+        const float idf = index.getPostingList(termID).getIdf();
+        for (size_t i = 0; i < segmentList.size(); ++i) {
+            accumulator.add(segmentList.getIDs()[i], Util::calcTfIdf(segmentList.getTfs()[i], idf) * queryWeight);
+        }
+    }
+    for (const size_t id : accumulator.getTouched()) {
+        if (indexManager.isDeleted(id)) { continue; }
+        const double docLength = normLengths[id];
+        topKCollector.push(id, (docLength == 0) ? 0 : static_cast<float>(accumulator.get(id) / (docLength * queryLength)));
     }
+}
 
-    // Sort vector ascending as this is a DISTANCE measure
-    std::sort(results.begin(), results.end(), [](std::pair<size_t, float> elem1, std::pair<size_t, float> elem2) { return elem1.second < elem2.second; });
-    return (!topK || topK > results.size()) ? results : std::vector<std::pair<size_t, float>>(results.begin(), results.begin() + topK);
+void QueryExecutionEngine::addSegmentCandidates(const termid_vt& queryTermIDs, sizet_vt& candidates) {
+    const sizet_vt segmentIDs = IndexManager::getInstance().getInvertedIndex().getSegmentDocIDList(queryTermIDs);
+    if (!segmentIDs.empty()) {
+        sizet_vt merged;
+        Util::orPostingLists(std::vector<const sizet_vt*>{&candidates, &segmentIDs}, merged);
+        candidates.swap(merged);
+    }
+    IndexManager::getInstance().removeDeleted(candidates);
 }
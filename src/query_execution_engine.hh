@@ -21,9 +21,16 @@
 #include "document.hh"
 #include "query_manager.hh"
 #include "posting_list.hh"
+#include "posting_cursor.hh"
+#include "top_k_collector.hh"
+#include "score_accumulator.hh"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <nlohmann/json.hpp>
+#include <numeric>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -62,9 +69,12 @@ class QueryExecutionEngine {
      * @param query The raw string query
      * @param topK How many results are retrieved
      * @param searchType What type of search should be executed
+     * @param searchWidth the candidate list size (efSearch) of a kHNSW_W2V search, the number of probed lists (nprobe)
+     *        of a kIVFPQ_W2V search or the number of probed buckets per table (probes) of a kLSH_RAND search, 0 for the
+     *        one of the control block
      * @return pair_sizet_float_vt A list of document - similarity pairs ordered descending
      */
-    const pair_sizet_float_vt search(std::string& query, size_t topK, IR_MODE searchType);
+    const pair_sizet_float_vt search(std::string& query, size_t topK, IR_MODE searchType, size_t searchWidth = 0);
 
     /**
      * @brief A top level implementation of the search function. Use a string and type to search for similar documents
@@ -74,9 +84,12 @@ class QueryExecutionEngine {
      * @param query A query document
      * @param topK How many results are retrieved
      * @param searchType What type of search should be executed
+     * @param searchWidth the candidate list size (efSearch) of a kHNSW_W2V search, the number of probed lists (nprobe)
+     *        of a kIVFPQ_W2V search or the number of probed buckets per table (probes) of a kLSH_RAND search, 0 for the
+     *        one of the control block
      * @return pair_sizet_float_vt A list of document - similarity pairs ordered descending
      */
-    const pair_sizet_float_vt search(Document& query, size_t topK, IR_MODE searchType);
+    const pair_sizet_float_vt search(Document& query, size_t topK, IR_MODE searchType, size_t searchWidth = 0);
 
     /**
      * @brief Search function for searching the whole document collection
@@ -88,6 +101,44 @@ class QueryExecutionEngine {
      */
     const pair_sizet_float_vt searchCollectionCos(const Document* query, const sizet_vt& collectionIds, size_t topK, bool use_w2v = false);
 
+    /**
+     * @brief Term at a time search function for searching the whole document collection. Walks the posting list of
+     *        every query term and accumulates the tf-idf products in a per query array indexed by doc id. The scores are
+     *        normalized by the precomputed norm lengths, so the cost scales with the posting lengths and not with the
+     *        number of candidates times the vocabulary size
+     *
+     * @param query A preprocessed query document
+     * @param topK How many results are retrieved
+     * @return pair_sizet_float_vt  A list of document - similarity (cosine) pairs ordered descending
+     */
+    const pair_sizet_float_vt searchCollectionTaat(const Document* query, size_t topK);
+
+    /**
+     * @brief Document at a time search function with dynamic pruning (WAND) for searching the whole document collection.
+     *        The query term cursors are kept sorted by docID, a document is only scored if the sum of the score upper
+     *        bounds of the terms up to it can beat the current top-k. With Block-Max WAND the per block upper bounds are
+     *        checked as well, and whole blocks are skipped. Returns the same top-k as @see searchCollectionTaat
+     *
+     * @param query A preprocessed query document
+     * @param topK How many results are retrieved
+     * @param use_block_max whether the per block upper bounds are used (Block-Max WAND)
+     * @return pair_sizet_float_vt  A list of document - similarity (cosine) pairs ordered descending
+     */
+    const pair_sizet_float_vt searchCollectionWand(const Document* query, size_t topK, bool use_block_max = false);
+
+    /**
+     * @brief Document at a time search function with dynamic pruning (MaxScore) for searching the whole document collection.
+     *        The query terms are sorted by their maximum score contribution. The terms whose summed contributions can not
+     *        beat the current top-k are non-essential: only the essential terms generate candidates, the non-essential
+     *        posting lists are only probed for candidates which can still enter the top-k. Returns the same top-k as
+     *        @see searchCollectionTaat
+     *
+     * @param query A preprocessed query document
+     * @param topK How many results are retrieved
+     * @return pair_sizet_float_vt  A list of document - similarity (cosine) pairs ordered descending
+     */
+    const pair_sizet_float_vt searchCollectionMaxScore(const Document* query, size_t topK);
+
     /**
      * @brief Search function for searching the cluster representation
      *
@@ -118,15 +169,94 @@ class QueryExecutionEngine {
     const pair_sizet_float_vt searchTieredCos(const Document* query, const sizet_vt& collectionIds, size_t topK, bool use_w2v = false);
 
     /**
-     * @brief Search function for searching when random projections are used
+     * @brief Search function for searching when random projections are used, the Hamming distances are computed in one
+     *        scan over the packed signature table of the IndexManager
      *
      * @param query A preprocessed query document
      * @param collectionIds IDs of docs to search in
      * @param topK How many results are retrieved
-     * @return pair_sizet_float_vt  A list of document - similarity pairs ordered descending
+     * @return pair_sizet_float_vt  A list of document - distance pairs ordered ascending
      */
     const pair_sizet_float_vt searchRandomProjCos(const Document* query, const sizet_vt& collectionIds, size_t topK);
 
+    /**
+     * @brief Search function for the approximate nearest neighbours of the word embeddings vector of the query in the
+     *        HNSW graph, the similarity is the cosine of the word embeddings vectors only
+     *
+     * @param query A preprocessed query document
+     * @param topK How many results are retrieved, 0 retrieves all live documents of the candidate list
+     * @param efSearch the size of the candidate list, a larger one finds more of the exact neighbours. It is widened
+     *        while deleted documents leave fewer than topK live ones
+     * @return pair_sizet_float_vt  A list of document - similarity pairs ordered descending
+     */
+    const pair_sizet_float_vt searchHnsw(const Document* query, size_t topK, size_t efSearch);
+
+    /**
+     * @brief Search function for the documents whose word embeddings vectors are most similar to the one of the query
+     *        in the IVF-PQ index, the similarity is approximated from the product quantization codes
+     *
+     * @param query A preprocessed query document
+     * @param topK How many results are retrieved
+     * @param nprobe the number of lists to search, more lists find more of the exact neighbours
+     * @return pair_sizet_float_vt  A list of document - similarity pairs ordered descending
+     */
+    const pair_sizet_float_vt searchIvfPq(const Document* query, size_t topK, size_t nprobe);
+
+    /**
+     * @brief Search function for the documents whose random projection vectors share a bucket of the LSH index with
+     *        the one of the query, ranked by their Hamming distance. The posting lists are not used
+     *
+     * @param query A preprocessed query document
+     * @param topK How many results are retrieved
+     * @param probes the number of buckets to probe per table, more buckets find more of the similar documents
+     * @return pair_sizet_float_vt  A list of document - distance pairs ordered ascending
+     */
+    const pair_sizet_float_vt searchLsh(const Document* query, size_t topK, size_t probes);
+
+  private:
+    /**
+     * @brief The search function behind @see search, the caller holds the shared lock of the IndexManager
+     *
+     * @param queryDoc the query document
+     * @param topK the number of results
+     * @param searchType What type of search should be executed
+     * @param searchWidth the candidate list size (efSearch) of a kHNSW_W2V search, the number of probed lists (nprobe)
+     *        of a kIVFPQ_W2V search or the number of probed buckets per table (probes) of a kLSH_RAND search, 0 for the
+     *        one of the control block
+     * @return const pair_sizet_float_vt the top-k (docID, similarity) pairs
+     */
+    const pair_sizet_float_vt searchLocked(Document& queryDoc, size_t topK, IR_MODE searchType, size_t searchWidth);
+    /**
+     * @brief Score the documents of the mutable segment exhaustively (term at a time) into the collector. The dynamic
+     *        pruning searches use it, because the segment lists carry no upper bounds
+     *
+     * @param query the query document
+     * @param queryLength the norm length of the query
+     * @param topKCollector the collector
+     */
+    void searchSegment(const Document* query, const double queryLength, TopKCollector& topKCollector);
+    /**
+     * @brief Add the documents of the mutable segment which contain one of the query terms to a sorted candidate list
+     *        and remove the deleted documents from it
+     *
+     * @param queryTermIDs the ids of the query terms
+     * @param candidates the sorted candidate list
+     */
+    void addSegmentCandidates(const termid_vt& queryTermIDs, sizet_vt& candidates);
+    /**
+     * @brief The cosine similarity of the combined tf-idf and word embeddings vectors of the query and a document. The
+     *        combined length of the document is cached in the IndexManager, so only the dot products are computed. A
+     *        document vector in the quantized table of the IndexManager is read from there, the query vector stays in
+     *        full precision
+     *
+     * @param query the query document
+     * @param queryLength the length of the combined query vector, @see Util::combinedVectorLength
+     * @param doc the document
+     * @param docID the id of the document
+     * @return float the cosine similarity
+     */
+    float calcW2VCosSim(const Document* query, const double queryLength, const Document& doc, const size_t docID) const;
+
   private:
     const CB* _cb;
 };
@@ -18,40 +18,42 @@ Document QueryManager::QueryType::createQueryDoc(const str_set& aStopwords, std:
 
     Document lQueryDoc(aQueryID, content);
 
-    const string_vt& con = lQueryDoc.getContent(); // start build docTermTFMap
-    str_int_mt tf_counts;
-    str_float_mt tf_out;
-
+    const string_vt& con = lQueryDoc.getContent(); // start build docTermTFVector
+    termid_vt termIDs;
+    termIDs.reserve(con.size());
     for (const std::string& term : con) {
-        ++tf_counts[term];
-    }
-
-    int maxFreq = Util::getMaxWordFrequency(con);
-    for (const auto& [term, count] : tf_counts) { // this loops through the distinct terms of this document
-        tf_out[term] = Util::calcTf(count, maxFreq);
+        const term_id_t termID = TermDictionary::getInstance().getID(term);
+        if (termID != TermDictionary::kNoTerm) { termIDs.push_back(termID); } // terms outside of the collection carry no weight
     }
-    lQueryDoc.setTermTfMap(tf_out); // end build docTermTFMap
+    sparse_vt tf_out;
+    Util::calcTfVector(termIDs, Util::getMaxWordFrequency(con), tf_out);
+    lQueryDoc.setTermTfVector(tf_out); // end build docTermTFVector
 
-    IndexManager::getInstance().buildTfIdfVector(lQueryDoc);
+    IndexManager::getInstance().buildTfIdfVector(lQueryDoc, true);
     IndexManager::getInstance().buildWordEmbeddingsVector(lQueryDoc);
     IndexManager::getInstance().buildRandProjVector(lQueryDoc);
 
     return lQueryDoc;
 }
 
-void QueryManager::QueryType::init(const std::string& aPath, const char aDelimiter)
+void QueryManager::QueryType::init(const std::string& aPath, const char aDelimiter, const size_t aNoThreads)
 {
     TRACE(std::string("QueryManager: Start reading the query collection and creating Document objects for query type '") + _qType  + std::string("'"));
     const std::string lFilePath = aPath + std::string("q-") + _qType + std::string(".queries");
-    string_vvt lFileContent;
-    Util::readIn(lFilePath, aDelimiter, lFileContent);
-    //std::cout << "Build Vecs for QueryType: " << lFilePath << std::endl;
-    for(auto& line : lFileContent)
+    if(!fs::exists(lFilePath)) // not every query type has its own file (e.g. 'all')
     {
-        const std::string& lQueryID = line.at(0);
-        std::string& lQueryContent = line.at(1);
-        addDoc(lQueryID, lQueryContent);
+        TRACE(std::string("QueryManager: There is no query file for query type '") + _qType + std::string("'"));
+        return;
     }
+    using query_chunk_t = std::vector<std::pair<std::string, std::string>>; // (queryID, content) in file order
+    Util::readInParallel<query_chunk_t>(lFilePath, aDelimiter, aNoThreads, [](const strview_vt& line, query_chunk_t& chunk) {
+        chunk.emplace_back(std::string(line.at(0)), std::string(line.at(1)));
+    }, [this](query_chunk_t& chunk) {
+        for(const auto& [lQueryID, lQueryContent] : chunk)
+        {
+            addDoc(lQueryID, lQueryContent);
+        }
+    });
     TRACE("QueryManager: Finished reading the query collection");
 }
 
@@ -86,11 +88,11 @@ void QueryManager::init(const CB& aControlBlock)
         }
 
         const std::string& lQueryPath = _cb->queryPath();
-        _qAll.init(lQueryPath, _delimiter);
-        _qNTT.init(lQueryPath, _delimiter);
-        _qTitles.init(lQueryPath, _delimiter);
-        _qVidDesc.init(lQueryPath, _delimiter);
-        _qVidTitles.init(lQueryPath, _delimiter);
+        _qAll.init(lQueryPath, _delimiter, _cb->threads());
+        _qNTT.init(lQueryPath, _delimiter, _cb->threads());
+        _qTitles.init(lQueryPath, _delimiter, _cb->threads());
+        _qVidDesc.init(lQueryPath, _delimiter, _cb->threads());
+        _qVidTitles.init(lQueryPath, _delimiter, _cb->threads());
     }
 }
 
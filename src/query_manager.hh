@@ -58,8 +58,9 @@ class QueryManager
                  * 
                  * @param aPath         the path to the query file from which to read the content into main memory
                  * @param aDelimiter    the delimiter to split the file content with
+                 * @param aNoThreads    the number of threads parsing the file
                  */
-                void init(const std::string& aPath, const char aDelimiter);
+                void init(const std::string& aPath, const char aDelimiter, const size_t aNoThreads);
 
             public:
                 /**
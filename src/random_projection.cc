@@ -26,6 +26,27 @@ void RandomProjection::init(const control_block_t& aCB, const size_t origVectorS
         }
     }
 
+void RandomProjection::save(std::ostream& aOut) const {
+    Util::writeValue<uint64_t>(aOut, _origVectorSize);
+    Util::writeValue<uint64_t>(aOut, _randomVectors.size());
+    for (const float_vt& randomVector : _randomVectors) {
+        Util::writeVector(aOut, randomVector);
+    }
+}
+
+void RandomProjection::load(const control_block_t& aCB, Util::BinaryReader& aReader) {
+    if (!_cb) {
+        _cb = &aCB;
+        _dimension = _cb->dimensions();
+        _seed = _cb->seed() + _dimension; // the seed as if the vectors were generated, see initRandomVectors
+        setOrigVectorSize(aReader.readValue<uint64_t>());
+        _randomVectors.resize(aReader.readValue<uint64_t>());
+        for (float_vt& randomVector : _randomVectors) {
+            aReader.readVector(randomVector);
+        }
+    }
+}
+
 boost::dynamic_bitset<> RandomProjection::localitySensitiveHashProjection(std::vector<float>& vector,
                                                                           std::function<unsigned int(std::vector<float>&,
                                                                           std::vector<float>&)> hashFunc) {
@@ -35,3 +56,13 @@ boost::dynamic_bitset<> RandomProjection::localitySensitiveHashProjection(std::v
     }
     return result;
 }
+
+boost::dynamic_bitset<> RandomProjection::localitySensitiveHashProjection(const sparse_vt& vector,
+                                                                          std::function<unsigned int(const sparse_vt&,
+                                                                          const float_vt&)> hashFunc) {
+    boost::dynamic_bitset<> result(_dimension);
+    for (size_t j = 0; j < _dimension; ++j) {
+        result[j] = hashFunc(vector, _randomVectors[j]);
+    }
+    return result;
+}
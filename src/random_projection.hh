@@ -14,6 +14,7 @@
 #include "exception.hh"
 #include "trace.hh"
 #include "vec_util.hh"
+#include "serialization_util.hh"
 
 #include <bitset>
 #include <boost/dynamic_bitset.hpp>
@@ -41,6 +42,14 @@ class RandomProjection {
      * @return boost::dynamic_bitset bitvector
      */
     boost::dynamic_bitset<> localitySensitiveHashProjection(std::vector<float>& vector, std::function<unsigned int(std::vector<float>&, std::vector<float>&)>);
+    /**
+     * Use random projections to reduce the number of dimensions of a sparse vector
+     *
+     * @param vector original sparse vector
+     * @param hashFunc hash function to use to combine original vector and random vectors
+     * @return boost::dynamic_bitset bitvector
+     */
+    boost::dynamic_bitset<> localitySensitiveHashProjection(const sparse_vt& vector, std::function<unsigned int(const sparse_vt&, const float_vt&)>);
 
   public:
     /**
@@ -111,6 +120,21 @@ class RandomProjection {
      */
     void init(const CB& aCB, const size_t origVectorSize); 
 
+    /**
+     * @brief Write the random vectors to a snapshot
+     *
+     * @param aOut the output stream
+     */
+    void save(std::ostream& aOut) const;
+
+    /**
+     * @brief Initialize the random projection with the random vectors written by @see save instead of generating them
+     *
+     * @param aCB the control block
+     * @param aReader the snapshot reader
+     */
+    void load(const CB& aCB, Util::BinaryReader& aReader);
+
     /**
      * @brief Initialize the random vectors
      *
@@ -0,0 +1,24 @@
+#include "score_accumulator.hh"
+
+/**
+ * @brief Construct a new Score Accumulator:: Score Accumulator object
+ *
+ */
+ScoreAccumulator::ScoreAccumulator() :
+    _epoch(0),
+    _epochs(),
+    _scores(),
+    _touched()
+{}
+
+void ScoreAccumulator::reset(const size_t aSize) {
+    if (aSize > _epochs.size()) {
+        _epochs.resize(aSize, 0);
+        _scores.resize(aSize, 0);
+    }
+    if (++_epoch == 0) { // the epoch wrapped around, the old tags could collide
+        std::fill(_epochs.begin(), _epochs.end(), 0);
+        _epoch = 1;
+    }
+    _touched.clear();
+}
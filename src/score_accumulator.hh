@@ -0,0 +1,79 @@
+/**
+ *	@file 	score_accumulator.hh
+ *	@brief  Implements the dense per query score accumulator, indexed by docID. Every slot is tagged with the epoch
+ *          (query) it was last written in, so starting a new query only increments the epoch instead of clearing the
+ *          array. There is one instance per thread, which is reused by all queries of that thread
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class ScoreAccumulator {
+  private:
+    ScoreAccumulator();
+    ScoreAccumulator(const ScoreAccumulator&) = delete;
+    ScoreAccumulator(ScoreAccumulator&&) = delete;
+    ScoreAccumulator& operator=(const ScoreAccumulator&) = delete;
+    ScoreAccumulator& operator=(ScoreAccumulator&&) = delete;
+    ~ScoreAccumulator() = default;
+
+  public:
+    /**
+     * @brief Get the score accumulator instance of the calling thread
+     *
+     * @return ScoreAccumulator& the instance
+     */
+    inline static ScoreAccumulator& getInstance() {
+        thread_local ScoreAccumulator lInstance;
+        return lInstance;
+    }
+
+  public:
+    /**
+     * @brief Start a new query. All scores are zero afterwards, the array only grows if aSize is larger than before
+     *
+     * @param aSize the number of docIDs (largest docID + 1)
+     */
+    void reset(const size_t aSize);
+    /**
+     * @brief Add aScore to the score of document aDocID
+     *
+     * @param aDocID the docID
+     * @param aScore the score to add
+     */
+    inline void add(const size_t aDocID, const float aScore) {
+        if (_epochs[aDocID] != _epoch) { // first score of this document in the current query
+            _epochs[aDocID] = _epoch;
+            _scores[aDocID] = aScore;
+            _touched.push_back(aDocID);
+        } else {
+            _scores[aDocID] += aScore;
+        }
+    }
+    /**
+     * @brief Get the accumulated score of document aDocID
+     *
+     * @param aDocID the docID
+     * @return float the score (0 if the document got no score in the current query)
+     */
+    inline float get(const size_t aDocID) const { return (_epochs[aDocID] == _epoch) ? _scores[aDocID] : 0; }
+    /**
+     * @brief Get the docIDs which got a score in the current query, in the order of their first score
+     *
+     * @return const sizet_vt& the docIDs
+     */
+    inline const sizet_vt& getTouched() const { return _touched; }
+
+  private:
+    uint32_t _epoch;
+    std::vector<uint32_t> _epochs; // the epoch each slot was last written in
+    float_vt _scores;
+    sizet_vt _touched;
+};
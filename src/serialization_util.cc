@@ -0,0 +1,160 @@
+#include "serialization_util.hh"
+
+namespace Util {
+
+    void writeString(std::ostream& aOut, const std::string& aString) {
+        writeValue<uint64_t>(aOut, aString.size());
+        aOut.write(aString.data(), aString.size());
+    }
+
+    void writeStrings(std::ostream& aOut, const string_vt& aStrings) {
+        writeValue<uint64_t>(aOut, aStrings.size());
+        for (const std::string& str : aStrings) {
+            writeString(aOut, str);
+        }
+    }
+
+    void writeSparse(std::ostream& aOut, const sparse_vt& aVec) {
+        writeValue<uint64_t>(aOut, aVec.size());
+        for (const auto& elem : aVec) {
+            writeValue(aOut, elem.first);
+        }
+        for (const auto& elem : aVec) {
+            writeValue(aOut, elem.second);
+        }
+    }
+
+    void writeBitset(std::ostream& aOut, const boost::dynamic_bitset<>& aBits) {
+        std::vector<boost::dynamic_bitset<>::block_type> blocks(aBits.num_blocks());
+        boost::to_block_range(aBits, blocks.begin());
+        writeValue<uint64_t>(aOut, aBits.size());
+        writeVector(aOut, blocks);
+    }
+
+    void writeFileStamp(std::ostream& aOut, const std::string& aPath) {
+        struct stat st;
+        if (aPath.empty() || stat(aPath.c_str(), &st) != 0) {
+            writeValue<uint64_t>(aOut, 0);
+            writeValue<int64_t>(aOut, 0);
+            writeValue<int64_t>(aOut, 0);
+            return;
+        }
+        writeValue<uint64_t>(aOut, st.st_size);
+        writeValue<int64_t>(aOut, st.st_mtim.tv_sec);
+        writeValue<int64_t>(aOut, st.st_mtim.tv_nsec);
+    }
+
+    std::string snapshotHeader(const CB& aCB) {
+        std::ostringstream header;
+        writeValue(header, kSnapshotMagic);
+        writeValue(header, kSnapshotVersion);
+        writeString(header, aCB.collectionPath());
+        writeString(header, aCB.wordEmbeddingsPath());
+        writeFileStamp(header, aCB.collectionPath()); // an input edited at the same path invalidates the snapshot
+        writeFileStamp(header, aCB.wordEmbeddingsPath());
+        writeFileStamp(header, aCB.stopwordPath());
+        writeValue<uint32_t>(header, aCB.tiers());
+        writeValue<uint32_t>(header, aCB.dimensions());
+        writeValue<uint32_t>(header, aCB.seed());
+        writeValue<int32_t>(header, aCB.postingCodec());
+        writeValue<uint8_t>(header, aCB.filterWordEmbeddings());
+        return header.str();
+    }
+
+    bool isSnapshotUsable(const CB& aCB) {
+        if (aCB.indexPath().empty()) { return false; }
+        std::ifstream file(aCB.indexPath(), std::ios::binary);
+        if (!file) { return false; }
+        const std::string expected = snapshotHeader(aCB);
+        std::string header(expected.size(), '\0');
+        file.read(header.data(), header.size());
+        return file && header == expected;
+    }
+
+    BinaryReader::BinaryReader(const std::string& aPath, const bool aMmap) :
+        _path(aPath),
+        _buffer(),
+        _map(nullptr),
+        _mapSize(0),
+        _pos(nullptr),
+        _end(nullptr)
+    {
+        if (aMmap) {
+            const int fd = open(aPath.c_str(), O_RDONLY);
+            if (fd < 0) { throw FileException(FLF, aPath.c_str(), "The file can not be opened."); }
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                throw FileException(FLF, aPath.c_str(), "The file size can not be determined.");
+            }
+            _mapSize = st.st_size;
+            if (_mapSize > 0) {
+                _map = mmap(nullptr, _mapSize, PROT_READ, MAP_SHARED, fd, 0);
+            }
+            close(fd); // the mapping stays valid
+            if (_map == MAP_FAILED) {
+                _map = nullptr;
+                throw FileException(FLF, aPath.c_str(), "The file can not be memory-mapped.");
+            }
+            madvise(_map, _mapSize, MADV_SEQUENTIAL);
+            _pos = static_cast<const char*>(_map);
+            _end = _pos + _mapSize;
+        } else {
+            std::ifstream file(aPath, std::ios::binary | std::ios::ate);
+            if (!file) { throw FileException(FLF, aPath.c_str(), "The file can not be opened."); }
+            _buffer.resize(file.tellg());
+            file.seekg(0);
+            file.read(_buffer.data(), _buffer.size());
+            _pos = _buffer.data();
+            _end = _pos + _buffer.size();
+        }
+    }
+
+    BinaryReader::~BinaryReader() {
+        if (_map) { munmap(_map, _mapSize); }
+    }
+
+    std::string BinaryReader::readString() {
+        const uint64_t size = readValue<uint64_t>();
+        check(size);
+        std::string str(_pos, size);
+        _pos += size;
+        return str;
+    }
+
+    void BinaryReader::readStrings(string_vt& aStrings) {
+        const uint64_t size = readValue<uint64_t>();
+        aStrings.clear();
+        aStrings.reserve(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            aStrings.push_back(readString());
+        }
+    }
+
+    void BinaryReader::readSparse(sparse_vt& aVec) {
+        const uint64_t size = readValue<uint64_t>();
+        check(size * (sizeof(term_id_t) + sizeof(float)));
+        aVec.resize(size);
+        for (auto& elem : aVec) {
+            elem.first = readValue<term_id_t>();
+        }
+        for (auto& elem : aVec) {
+            elem.second = readValue<float>();
+        }
+    }
+
+    void BinaryReader::readBitset(boost::dynamic_bitset<>& aBits) {
+        const uint64_t size = readValue<uint64_t>();
+        std::vector<boost::dynamic_bitset<>::block_type> blocks;
+        readVector(blocks);
+        aBits.clear();
+        aBits.append(blocks.begin(), blocks.end());
+        aBits.resize(size);
+    }
+
+    void BinaryReader::check(const size_t aBytes) const {
+        if (static_cast<size_t>(_end - _pos) < aBytes) {
+            throw FileException(FLF, _path.c_str(), "The snapshot is truncated or corrupt.");
+        }
+    }
+}
@@ -0,0 +1,215 @@
+/*
+ * @file    serialization_util.hh
+ * @brief   Utils for the binary index snapshot. Values are written in the native byte order, vectors with their
+ *          size in front. The BinaryReader reads a file in a single pass, either from a private buffer or from a
+ *          read-only memory mapping of the file, e.g. the SPIMI runs which do not fit into the memory budget
+ *
+ * @section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+#include "exception.hh"
+
+#include <boost/dynamic_bitset.hpp>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+namespace Util {
+
+    constexpr uint32_t kSnapshotMagic = 0x52535645;  // "EVSR"
+    constexpr uint32_t kSnapshotVersion = 3;         // increment on every change of the snapshot layout
+
+    /**
+     * @brief Write a trivially copyable value
+     *
+     * @param aOut the output stream
+     * @param aValue the value
+     */
+    template <typename T>
+    inline void writeValue(std::ostream& aOut, const T& aValue) {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be written");
+        aOut.write(reinterpret_cast<const char*>(&aValue), sizeof(T));
+    }
+
+    /**
+     * @brief Write a vector of trivially copyable values, prefixed with its size
+     *
+     * @param aOut the output stream
+     * @param aVec the vector
+     */
+    template <typename T>
+    inline void writeVector(std::ostream& aOut, const std::vector<T>& aVec) {
+        static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be written");
+        writeValue<uint64_t>(aOut, aVec.size());
+        aOut.write(reinterpret_cast<const char*>(aVec.data()), aVec.size() * sizeof(T));
+    }
+
+    /**
+     * @brief Write a string, prefixed with its size
+     *
+     * @param aOut the output stream
+     * @param aString the string
+     */
+    void writeString(std::ostream& aOut, const std::string& aString);
+
+    /**
+     * @brief Write a vector of strings, prefixed with its size
+     *
+     * @param aOut the output stream
+     * @param aStrings the strings
+     */
+    void writeStrings(std::ostream& aOut, const string_vt& aStrings);
+
+    /**
+     * @brief Write a sparse vector as its termIDs followed by its weights
+     *
+     * @param aOut the output stream
+     * @param aVec the sparse vector
+     */
+    void writeSparse(std::ostream& aOut, const sparse_vt& aVec);
+
+    /**
+     * @brief Write a bitset as its size followed by its blocks
+     *
+     * @param aOut the output stream
+     * @param aBits the bitset
+     */
+    void writeBitset(std::ostream& aOut, const boost::dynamic_bitset<>& aBits);
+
+    /**
+     * @brief Write the size and the modification time of a file, zeros if it does not exist
+     *
+     * @param aOut the output stream
+     * @param aPath the path of the file
+     */
+    void writeFileStamp(std::ostream& aOut, const std::string& aPath);
+
+    /**
+     * @brief Get the header a snapshot starts with. Besides the format version it contains the parameters the
+     *        snapshot content depends on and the size and modification time of the input files, so a snapshot is
+     *        only used if it was built with the same parameters from the same files
+     *
+     * @param aCB the control block
+     * @return std::string the header bytes
+     */
+    std::string snapshotHeader(const CB& aCB);
+
+    /**
+     * @brief Whether the file at aCB.indexPath() is a snapshot with the header @see snapshotHeader
+     *
+     * @param aCB the control block
+     * @return bool true if the snapshot can be loaded
+     */
+    bool isSnapshotUsable(const CB& aCB);
+
+    class BinaryReader {
+      public:
+        /**
+         * @brief Open the file at aPath for reading
+         *
+         * @param aPath the path of the file
+         * @param aMmap whether the file is memory-mapped read-only instead of read into a buffer
+         */
+        explicit BinaryReader(const std::string& aPath, const bool aMmap);
+        BinaryReader(const BinaryReader&) = delete;
+        BinaryReader(BinaryReader&&) = delete;
+        BinaryReader& operator=(const BinaryReader&) = delete;
+        BinaryReader& operator=(BinaryReader&&) = delete;
+        ~BinaryReader();
+
+      public:
+        /**
+         * @brief Read a trivially copyable value
+         *
+         * @return T the value
+         */
+        template <typename T>
+        inline T readValue() {
+            static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be read");
+            check(sizeof(T));
+            T value;
+            std::memcpy(&value, _pos, sizeof(T));
+            _pos += sizeof(T);
+            return value;
+        }
+        /**
+         * @brief Read a vector written by @see writeVector
+         *
+         * @param aVec the output vector
+         */
+        template <typename T>
+        inline void readVector(std::vector<T>& aVec) {
+            static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be read");
+            const uint64_t size = readValue<uint64_t>();
+            check(size * sizeof(T));
+            aVec.resize(size);
+            std::memcpy(aVec.data(), _pos, size * sizeof(T));
+            _pos += size * sizeof(T);
+        }
+        /**
+         * @brief Read a string written by @see writeString
+         *
+         * @return std::string the string
+         */
+        std::string readString();
+        /**
+         * @brief Read strings written by @see writeStrings
+         *
+         * @param aStrings the output strings
+         */
+        void readStrings(string_vt& aStrings);
+        /**
+         * @brief Read a sparse vector written by @see writeSparse
+         *
+         * @param aVec the output sparse vector
+         */
+        void readSparse(sparse_vt& aVec);
+        /**
+         * @brief Read a bitset written by @see writeBitset
+         *
+         * @param aBits the output bitset
+         */
+        void readBitset(boost::dynamic_bitset<>& aBits);
+        /**
+         * @brief Skip aBytes bytes
+         *
+         * @param aBytes the number of bytes
+         */
+        inline void skip(const size_t aBytes) {
+            check(aBytes);
+            _pos += aBytes;
+        }
+        /**
+         * @brief Whether the whole file was read
+         *
+         * @return bool true if the end is reached
+         */
+        inline bool atEnd() const { return _pos == _end; }
+
+      private:
+        /**
+         * @brief Throw if fewer than aBytes bytes are left
+         *
+         * @param aBytes the number of bytes to read next
+         */
+        void check(const size_t aBytes) const;
+
+      private:
+        const std::string _path;
+        std::string _buffer; // the file content if the file is not mapped
+        void* _map;          // the mapping if the file is mapped
+        size_t _mapSize;
+        const char* _pos;
+        const char* _end;
+    };
+}
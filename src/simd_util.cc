@@ -0,0 +1,329 @@
+#include "simd_util.hh"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EVSR_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Util {
+
+    namespace {
+
+        // scalar kernels, the products of two floats are exact in double precision
+
+        double dotScalar(const float* a, const float* b, const size_t size) {
+            double dot = 0;
+            for (size_t i = 0; i < size; ++i) {
+                dot += static_cast<double>(a[i]) * b[i];
+            }
+            return dot;
+        }
+
+        double squaredNormScalar(const float* a, const size_t size) {
+            double magn = 0;
+            for (size_t i = 0; i < size; ++i) {
+                magn += static_cast<double>(a[i]) * a[i];
+            }
+            return magn;
+        }
+
+        double squaredL2Scalar(const float* a, const float* b, const size_t size) {
+            double sum = 0;
+            for (size_t i = 0; i < size; ++i) {
+                const double diff = static_cast<double>(a[i]) - b[i];
+                sum += diff * diff;
+            }
+            return sum;
+        }
+
+        void dotAndSquaredNormsScalar(const float* a, const float* b, const size_t size, double& dot, double& squaredNorm_a, double& squaredNorm_b) {
+            dot = squaredNorm_a = squaredNorm_b = 0;
+            for (size_t i = 0; i < size; ++i) {
+                dot += static_cast<double>(a[i]) * b[i];
+                squaredNorm_a += static_cast<double>(a[i]) * a[i];
+                squaredNorm_b += static_cast<double>(b[i]) * b[i];
+            }
+        }
+
+        void hammingDistancesScalar(const uint64_t* query, const uint64_t* rows, const size_t stride, const size_t words, const size_t* ids, const size_t noIds, uint32_t* out) {
+            for (size_t n = 0; n < noIds; ++n) {
+                const uint64_t* row = rows + ids[n] * stride;
+                uint32_t dist = 0;
+                for (size_t w = 0; w < words; ++w) {
+                    dist += static_cast<uint32_t>(__builtin_popcountll(query[w] ^ row[w]));
+                }
+                out[n] = dist;
+            }
+        }
+
+#ifdef EVSR_SIMD_X86
+
+        // SSE2, 4 floats per step widened to 2 x 2 doubles
+
+        inline double horizontalSum(const __m128d x) { return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x))); }
+
+        double dotSse2(const float* a, const float* b, const size_t size) {
+            __m128d lo = _mm_setzero_pd(), hi = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4) {
+                const __m128 x = _mm_loadu_ps(a + i), y = _mm_loadu_ps(b + i);
+                lo = _mm_add_pd(lo, _mm_mul_pd(_mm_cvtps_pd(x), _mm_cvtps_pd(y)));
+                hi = _mm_add_pd(hi, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)), _mm_cvtps_pd(_mm_movehl_ps(y, y))));
+            }
+            return horizontalSum(_mm_add_pd(lo, hi)) + dotScalar(a + i, b + i, size - i);
+        }
+
+        double squaredNormSse2(const float* a, const size_t size) {
+            __m128d lo = _mm_setzero_pd(), hi = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4) {
+                const __m128 x = _mm_loadu_ps(a + i);
+                const __m128d xlo = _mm_cvtps_pd(x), xhi = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+                lo = _mm_add_pd(lo, _mm_mul_pd(xlo, xlo));
+                hi = _mm_add_pd(hi, _mm_mul_pd(xhi, xhi));
+            }
+            return horizontalSum(_mm_add_pd(lo, hi)) + squaredNormScalar(a + i, size - i);
+        }
+
+        double squaredL2Sse2(const float* a, const float* b, const size_t size) {
+            __m128d lo = _mm_setzero_pd(), hi = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4) {
+                const __m128 x = _mm_loadu_ps(a + i), y = _mm_loadu_ps(b + i);
+                const __m128d dlo = _mm_sub_pd(_mm_cvtps_pd(x), _mm_cvtps_pd(y));
+                const __m128d dhi = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)), _mm_cvtps_pd(_mm_movehl_ps(y, y)));
+                lo = _mm_add_pd(lo, _mm_mul_pd(dlo, dlo));
+                hi = _mm_add_pd(hi, _mm_mul_pd(dhi, dhi));
+            }
+            return horizontalSum(_mm_add_pd(lo, hi)) + squaredL2Scalar(a + i, b + i, size - i);
+        }
+
+        void dotAndSquaredNormsSse2(const float* a, const float* b, const size_t size, double& dot, double& squaredNorm_a, double& squaredNorm_b) {
+            __m128d d = _mm_setzero_pd(), na = _mm_setzero_pd(), nb = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 2 <= size; i += 2) {
+                const __m128d x = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(a + i))));
+                const __m128d y = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(b + i))));
+                d = _mm_add_pd(d, _mm_mul_pd(x, y));
+                na = _mm_add_pd(na, _mm_mul_pd(x, x));
+                nb = _mm_add_pd(nb, _mm_mul_pd(y, y));
+            }
+            double tailDot, tailNorm_a, tailNorm_b;
+            dotAndSquaredNormsScalar(a + i, b + i, size - i, tailDot, tailNorm_a, tailNorm_b);
+            dot = horizontalSum(d) + tailDot;
+            squaredNorm_a = horizontalSum(na) + tailNorm_a;
+            squaredNorm_b = horizontalSum(nb) + tailNorm_b;
+        }
+
+        // AVX2 + FMA, 8 floats per step widened to 2 x 4 doubles
+
+        __attribute__((target("avx2,fma"))) inline double horizontalSumAvx2(const __m256d x) {
+            return horizontalSum(_mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1)));
+        }
+
+        __attribute__((target("avx2,fma"))) double dotAvx2(const float* a, const float* b, const size_t size) {
+            __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                lo = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)), _mm256_cvtps_pd(_mm_loadu_ps(b + i)), lo);
+                hi = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)), _mm256_cvtps_pd(_mm_loadu_ps(b + i + 4)), hi);
+            }
+            return horizontalSumAvx2(_mm256_add_pd(lo, hi)) + dotScalar(a + i, b + i, size - i);
+        }
+
+        __attribute__((target("avx2,fma"))) double squaredNormAvx2(const float* a, const size_t size) {
+            __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                const __m256d xlo = _mm256_cvtps_pd(_mm_loadu_ps(a + i)), xhi = _mm256_cvtps_pd(_mm_loadu_ps(a + i + 4));
+                lo = _mm256_fmadd_pd(xlo, xlo, lo);
+                hi = _mm256_fmadd_pd(xhi, xhi, hi);
+            }
+            return horizontalSumAvx2(_mm256_add_pd(lo, hi)) + squaredNormScalar(a + i, size - i);
+        }
+
+        __attribute__((target("avx2,fma"))) double squaredL2Avx2(const float* a, const float* b, const size_t size) {
+            __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                const __m256d dlo = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)), _mm256_cvtps_pd(_mm_loadu_ps(b + i)));
+                const __m256d dhi = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)), _mm256_cvtps_pd(_mm_loadu_ps(b + i + 4)));
+                lo = _mm256_fmadd_pd(dlo, dlo, lo);
+                hi = _mm256_fmadd_pd(dhi, dhi, hi);
+            }
+            return horizontalSumAvx2(_mm256_add_pd(lo, hi)) + squaredL2Scalar(a + i, b + i, size - i);
+        }
+
+        __attribute__((target("avx2,fma"))) void dotAndSquaredNormsAvx2(const float* a, const float* b, const size_t size, double& dot, double& squaredNorm_a, double& squaredNorm_b) {
+            __m256d d = _mm256_setzero_pd(), na = _mm256_setzero_pd(), nb = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4) {
+                const __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(a + i)), y = _mm256_cvtps_pd(_mm_loadu_ps(b + i));
+                d = _mm256_fmadd_pd(x, y, d);
+                na = _mm256_fmadd_pd(x, x, na);
+                nb = _mm256_fmadd_pd(y, y, nb);
+            }
+            double tailDot, tailNorm_a, tailNorm_b;
+            dotAndSquaredNormsScalar(a + i, b + i, size - i, tailDot, tailNorm_a, tailNorm_b);
+            dot = horizontalSumAvx2(d) + tailDot;
+            squaredNorm_a = horizontalSumAvx2(na) + tailNorm_a;
+            squaredNorm_b = horizontalSumAvx2(nb) + tailNorm_b;
+        }
+
+        // every AVX2 CPU has POPCNT, one 64 bit word per instruction. The rows are gathered by docID, so the next rows
+        // are prefetched while the current one is counted
+
+        constexpr size_t kPrefetchDistance = 4;
+
+        __attribute__((target("popcnt"))) void hammingDistancesPopcnt(const uint64_t* query, const uint64_t* rows, const size_t stride, const size_t words, const size_t* ids, const size_t noIds, uint32_t* out) {
+            for (size_t n = 0; n < noIds; ++n) {
+                if (n + kPrefetchDistance < noIds) { __builtin_prefetch(rows + ids[n + kPrefetchDistance] * stride); }
+                const uint64_t* row = rows + ids[n] * stride;
+                uint64_t dist = 0;
+                for (size_t w = 0; w < words; ++w) {
+                    dist += static_cast<uint64_t>(__builtin_popcountll(query[w] ^ row[w])); // POPCNT in this target
+                }
+                out[n] = static_cast<uint32_t>(dist);
+            }
+        }
+
+        // AVX-512F, 16 floats per step widened to 2 x 8 doubles, GCC warns about the undefined source operand of the
+        // conversion and the reduction intrinsics
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+        __attribute__((target("avx512f"))) double dotAvx512(const float* a, const float* b, const size_t size) {
+            __m512d lo = _mm512_setzero_pd(), hi = _mm512_setzero_pd();
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                lo = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i)), _mm512_cvtps_pd(_mm256_loadu_ps(b + i)), lo);
+                hi = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i + 8)), _mm512_cvtps_pd(_mm256_loadu_ps(b + i + 8)), hi);
+            }
+            return _mm512_reduce_add_pd(_mm512_add_pd(lo, hi)) + dotScalar(a + i, b + i, size - i);
+        }
+
+        __attribute__((target("avx512f"))) double squaredNormAvx512(const float* a, const size_t size) {
+            __m512d lo = _mm512_setzero_pd(), hi = _mm512_setzero_pd();
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m512d xlo = _mm512_cvtps_pd(_mm256_loadu_ps(a + i)), xhi = _mm512_cvtps_pd(_mm256_loadu_ps(a + i + 8));
+                lo = _mm512_fmadd_pd(xlo, xlo, lo);
+                hi = _mm512_fmadd_pd(xhi, xhi, hi);
+            }
+            return _mm512_reduce_add_pd(_mm512_add_pd(lo, hi)) + squaredNormScalar(a + i, size - i);
+        }
+
+        __attribute__((target("avx512f"))) double squaredL2Avx512(const float* a, const float* b, const size_t size) {
+            __m512d lo = _mm512_setzero_pd(), hi = _mm512_setzero_pd();
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m512d dlo = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i)), _mm512_cvtps_pd(_mm256_loadu_ps(b + i)));
+                const __m512d dhi = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i + 8)), _mm512_cvtps_pd(_mm256_loadu_ps(b + i + 8)));
+                lo = _mm512_fmadd_pd(dlo, dlo, lo);
+                hi = _mm512_fmadd_pd(dhi, dhi, hi);
+            }
+            return _mm512_reduce_add_pd(_mm512_add_pd(lo, hi)) + squaredL2Scalar(a + i, b + i, size - i);
+        }
+
+        __attribute__((target("avx512f"))) void dotAndSquaredNormsAvx512(const float* a, const float* b, const size_t size, double& dot, double& squaredNorm_a, double& squaredNorm_b) {
+            __m512d d = _mm512_setzero_pd(), na = _mm512_setzero_pd(), nb = _mm512_setzero_pd();
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                const __m512d x = _mm512_cvtps_pd(_mm256_loadu_ps(a + i)), y = _mm512_cvtps_pd(_mm256_loadu_ps(b + i));
+                d = _mm512_fmadd_pd(x, y, d);
+                na = _mm512_fmadd_pd(x, x, na);
+                nb = _mm512_fmadd_pd(y, y, nb);
+            }
+            double tailDot, tailNorm_a, tailNorm_b;
+            dotAndSquaredNormsScalar(a + i, b + i, size - i, tailDot, tailNorm_a, tailNorm_b);
+            dot = _mm512_reduce_add_pd(d) + tailDot;
+            squaredNorm_a = _mm512_reduce_add_pd(na) + tailNorm_a;
+            squaredNorm_b = _mm512_reduce_add_pd(nb) + tailNorm_b;
+        }
+
+        // VPOPCNTQ counts 8 words per instruction, the last words of a row are loaded with a mask
+
+        __attribute__((target("avx512f,avx512vpopcntdq"))) void hammingDistancesVpopcnt(const uint64_t* query, const uint64_t* rows, const size_t stride, const size_t words, const size_t* ids, const size_t noIds, uint32_t* out) {
+            const __mmask8 tailMask = static_cast<__mmask8>((1u << (words % 8)) - 1);
+            const size_t fullWords = words - words % 8;
+            for (size_t n = 0; n < noIds; ++n) {
+                if (n + kPrefetchDistance < noIds) { __builtin_prefetch(rows + ids[n + kPrefetchDistance] * stride); }
+                const uint64_t* row = rows + ids[n] * stride;
+                __m512i dist = _mm512_setzero_si512();
+                for (size_t w = 0; w < fullWords; w += 8) {
+                    const __m512i x = _mm512_xor_si512(_mm512_loadu_si512(query + w), _mm512_loadu_si512(row + w));
+                    dist = _mm512_add_epi64(dist, _mm512_popcnt_epi64(x));
+                }
+                if (tailMask) {
+                    const __m512i x = _mm512_xor_si512(_mm512_maskz_loadu_epi64(tailMask, query + fullWords), _mm512_maskz_loadu_epi64(tailMask, row + fullWords));
+                    dist = _mm512_add_epi64(dist, _mm512_popcnt_epi64(x));
+                }
+                out[n] = static_cast<uint32_t>(_mm512_reduce_add_epi64(dist));
+            }
+        }
+
+        void hammingDistancesAvx512(const uint64_t* query, const uint64_t* rows, const size_t stride, const size_t words, const size_t* ids, const size_t noIds, uint32_t* out) {
+            static const bool lVpopcnt = __builtin_cpu_supports("avx512vpopcntdq"); // not part of AVX-512F
+            if (lVpopcnt) {
+                hammingDistancesVpopcnt(query, rows, stride, words, ids, noIds, out);
+            } else {
+                hammingDistancesPopcnt(query, rows, stride, words, ids, noIds, out);
+            }
+        }
+
+#pragma GCC diagnostic pop
+
+#endif
+
+        const SimdKernels kKernels[kNumberOfISAs] = {
+            { dotScalar, squaredNormScalar, squaredL2Scalar, dotAndSquaredNormsScalar, hammingDistancesScalar },
+#ifdef EVSR_SIMD_X86
+            { dotSse2, squaredNormSse2, squaredL2Sse2, dotAndSquaredNormsSse2, hammingDistancesScalar }, // POPCNT is not part of SSE2
+            { dotAvx2, squaredNormAvx2, squaredL2Avx2, dotAndSquaredNormsAvx2, hammingDistancesPopcnt },
+            { dotAvx512, squaredNormAvx512, squaredL2Avx512, dotAndSquaredNormsAvx512, hammingDistancesAvx512 }
+#else
+            { dotScalar, squaredNormScalar, squaredL2Scalar, dotAndSquaredNormsScalar, hammingDistancesScalar },
+            { dotScalar, squaredNormScalar, squaredL2Scalar, dotAndSquaredNormsScalar, hammingDistancesScalar },
+            { dotScalar, squaredNormScalar, squaredL2Scalar, dotAndSquaredNormsScalar, hammingDistancesScalar }
+#endif
+        };
+
+    } // namespace
+
+    bool simdSupported(const SIMD_ISA aIsa) {
+#ifdef EVSR_SIMD_X86
+        __builtin_cpu_init();
+        switch (aIsa) {
+            case kSCALAR: return true;
+            case kSSE2: return __builtin_cpu_supports("sse2"); // cpuid, the AVX checks include the OS support (xgetbv)
+            case kAVX2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("popcnt");
+            case kAVX512: return __builtin_cpu_supports("avx512f");
+            default: return false;
+        }
+#else
+        return aIsa == kSCALAR;
+#endif
+    }
+
+    SIMD_ISA simdIsa() {
+        for (int isa = kNumberOfISAs - 1; isa > kSCALAR; --isa) {
+            if (simdSupported(static_cast<SIMD_ISA>(isa))) { return static_cast<SIMD_ISA>(isa); }
+        }
+        return kSCALAR;
+    }
+
+    const SimdKernels& simdKernels(const SIMD_ISA aIsa) { return kKernels[(aIsa < kNumberOfISAs) ? aIsa : kSCALAR]; }
+
+    std::string isaToString(const SIMD_ISA aIsa) {
+        switch (aIsa) {
+            case kSCALAR: return "scalar";
+            case kSSE2: return "SSE2";
+            case kAVX2: return "AVX2";
+            case kAVX512: return "AVX-512";
+            default: return "ISA not supported";
+        }
+    }
+
+} // namespace Util
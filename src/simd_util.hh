@@ -0,0 +1,127 @@
+/*
+ * @file    simd_util.hh
+ * @brief   Dense vector kernels (dot product, squared norm, squared euclidean distance and cosine) in a scalar, an
+ *          SSE2, an AVX2 and an AVX-512 variant. The widest variant the CPU supports is chosen by CPUID on the first
+ *          call. All variants accumulate in double precision like the scalar loops they replace, so a score only
+ *          differs in the rounding of the summation order. The Hamming kernel scans packed bit signatures with
+ *          XOR and POPCNT (VPOPCNTQ if the CPU has it) and is exact in every variant
+ *
+ * @section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Util {
+
+    enum SIMD_ISA {
+        kSCALAR = 0,
+        kSSE2 = 1,
+        kAVX2 = 2,
+        kAVX512 = 3,
+        kNumberOfISAs = 4
+    };
+
+    /**
+     * @brief The kernels of one instruction set
+     */
+    struct SimdKernels {
+        double (*dot)(const float* a, const float* b, const size_t size);
+        double (*squaredNorm)(const float* a, const size_t size);
+        double (*squaredL2)(const float* a, const float* b, const size_t size);
+        /**
+         * @brief One pass over a and b for the dot product and both squared norms
+         */
+        void (*dotAndSquaredNorms)(const float* a, const float* b, const size_t size, double& dot, double& squaredNorm_a, double& squaredNorm_b);
+        /**
+         * @brief Hamming distances of the query signature to the rows ids[0..noIds) of a packed signature table, the
+         *        row r starts at rows + r * stride and has words 64 bit words like the query
+         */
+        void (*hammingDistances)(const uint64_t* query, const uint64_t* rows, const size_t stride, const size_t words, const size_t* ids, const size_t noIds, uint32_t* out);
+    };
+
+    /**
+     * @brief Check if the CPU (and the operating system) supports an instruction set
+     *
+     * @param aIsa the instruction set
+     * @return true if its kernels can run
+     */
+    bool simdSupported(const SIMD_ISA aIsa);
+
+    /**
+     * @brief Get the widest instruction set the CPU supports
+     *
+     * @return SIMD_ISA the instruction set of @see simdKernels()
+     */
+    SIMD_ISA simdIsa();
+
+    /**
+     * @brief Get the kernels of an instruction set, e.g. to compare them. The caller has to check @see simdSupported
+     *
+     * @param aIsa the instruction set
+     * @return const SimdKernels& the kernels
+     */
+    const SimdKernels& simdKernels(const SIMD_ISA aIsa);
+
+    /**
+     * @brief Get the kernels of the widest instruction set the CPU supports, chosen once
+     *
+     * @return const SimdKernels& the kernels
+     */
+    inline const SimdKernels& simdKernels() {
+        static const SimdKernels& lKernels = simdKernels(simdIsa());
+        return lKernels;
+    }
+
+    std::string isaToString(const SIMD_ISA aIsa);
+
+    /**
+     * @brief Dot product of two dense vectors
+     *
+     * @param a first vector
+     * @param b second vector
+     * @param size the number of components
+     * @return double the dot product
+     */
+    inline double dot(const float* a, const float* b, const size_t size) { return simdKernels().dot(a, b, size); }
+
+    /**
+     * @brief Squared euclidean length of a dense vector
+     *
+     * @param a the vector
+     * @param size the number of components
+     * @return double the squared length
+     */
+    inline double squaredNorm(const float* a, const size_t size) { return simdKernels().squaredNorm(a, size); }
+
+    /**
+     * @brief Squared euclidean distance of two dense vectors
+     *
+     * @param a first vector
+     * @param b second vector
+     * @param size the number of components
+     * @return double the squared distance
+     */
+    inline double squaredL2(const float* a, const float* b, const size_t size) { return simdKernels().squaredL2(a, b, size); }
+
+    /**
+     * @brief Cosine similarity of two dense vectors in one pass
+     *
+     * @param a first vector
+     * @param b second vector
+     * @param size the number of components
+     * @return double the cosine similarity, 0 if one of the vectors is zero
+     */
+    inline double cosine(const float* a, const float* b, const size_t size) {
+        double lDot, lSquaredNorm_a, lSquaredNorm_b;
+        simdKernels().dotAndSquaredNorms(a, b, size, lDot, lSquaredNorm_a, lSquaredNorm_b);
+        if (lSquaredNorm_a == 0 || lSquaredNorm_b == 0) { return 0; }
+        return lDot / (std::sqrt(lSquaredNorm_a) * std::sqrt(lSquaredNorm_b));
+    }
+
+} // namespace Util
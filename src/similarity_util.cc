@@ -9,20 +9,29 @@ namespace Util
                 throw VectorException(FLF, traceMsg);
             }
 
-            if (vectorLength(aTfIdf_a) == 0 || vectorLength(aTfIdf_b) == 0){
-                return 0;
-            }
+            return static_cast<float>(cosine(aTfIdf_a.data(), aTfIdf_b.data(), aTfIdf_a.size()));
+        }
+
+        float calcCosSim(const sparse_vt& aTfIdf_a, const sparse_vt& aTfIdf_b) {
+            return calcCosSim(aTfIdf_a, vectorLength(aTfIdf_a), aTfIdf_b, vectorLength(aTfIdf_b));
+        }
 
-            double dotProduct = 0;
-            for (size_t i = 0; i < aTfIdf_a.size(); ++i) {
-                dotProduct += (aTfIdf_a[i] * aTfIdf_b[i]);
+        double combinedVectorLength(const sparse_vt& aTfIdf, const float_vt& aEmbeddings) {
+            double magn = 0;
+            for (const auto& elem : aTfIdf) {
+                magn += static_cast<double>(elem.second) * elem.second;
             }
+            return sqrt(magn + squaredNorm(aEmbeddings.data(), aEmbeddings.size()));
+        }
 
-            return static_cast<float>(dotProduct / (vectorLength(aTfIdf_a) * vectorLength(aTfIdf_b)));  
+        float calcCombinedCosSim(const sparse_vt& aTfIdf_a, const float_vt& aEmbeddings_a, const double aLength_a, const sparse_vt& aTfIdf_b, const float_vt& aEmbeddings_b) {
+            return calcCombinedCosSim(aTfIdf_a, aEmbeddings_a, aLength_a, aTfIdf_b, aEmbeddings_b, combinedVectorLength(aTfIdf_b, aEmbeddings_b));
         }
 
         float calcCosDist(const float_vt& aTF_IDF_a, const float_vt& aTF_IDF_b) { return 1 - calcCosSim(aTF_IDF_a, aTF_IDF_b); }
 
+        float calcCosDist(const sparse_vt& aTF_IDF_a, const sparse_vt& aTF_IDF_b) { return 1 - calcCosSim(aTF_IDF_a, aTF_IDF_b); }
+
         float calcCosSim(const Document& doc_a, const Document& doc_b) { return calcCosSim(doc_a.getTfIdfVector(), doc_b.getTfIdfVector()); }
 
         float calcCosDist(const Document& doc_a, const Document& doc_b) { return calcCosDist(doc_a.getTfIdfVector(), doc_b.getTfIdfVector()); }
@@ -42,6 +51,13 @@ namespace Util
             return static_cast<float>(1 - (theta / M_PI));
         }
 
+        float calcAngularSimilarity(const sparse_vt& aTfIdf_a, const sparse_vt& aTfIdf_b) {
+            float cosine = calcCosSim(aTfIdf_a, aTfIdf_b);
+            float theta = acosf(cosine);
+
+            return static_cast<float>(1 - (theta / M_PI));
+        }
+
         float calcAngularSimilarity(const Document& doc_a, const Document& doc_b) {
             return calcAngularSimilarity(doc_a.getTfIdfVector(), doc_b.getTfIdfVector());
         }
@@ -84,11 +100,7 @@ namespace Util
                 throw VectorException(FLF, traceMsg);
             }
 
-            double sum = 0;
-            for (size_t i = 0; i < doc_a.size(); ++i) {
-                sum += pow((doc_a[i] - doc_b[i]), 2);
-            }
-            return static_cast<float>(sqrt(sum));
+            return static_cast<float>(sqrt(squaredL2(doc_a.data(), doc_b.data(), doc_a.size())));
         }
 
         float calcEuclDistNormalized(float_vt& doc_a, float_vt& doc_b) {
@@ -14,6 +14,8 @@
 #include "trace.hh"
 
 #include "document.hh"
+#include "vec_util.hh"
+#include "simd_util.hh"
 
 #include <bits/stl_algo.h>
 #include <boost/dynamic_bitset.hpp>
@@ -28,10 +30,18 @@ namespace Util {
          * @param vec the vector
          * @return float the length
          */
-        inline double vectorLength(const float_vt& vec) {
+        inline double vectorLength(const float_vt& vec) { return sqrt(squaredNorm(vec.data(), vec.size())); }
+
+        /**
+         * @brief Calculate and return the length of the given sparse vector
+         *
+         * @param vec the sparse vector
+         * @return float the length
+         */
+        inline double vectorLength(const sparse_vt& vec) {
             double magn = 0;
-            for (size_t i = 0; i < vec.size(); ++i) {
-                magn += pow(vec[i], 2);
+            for (const auto& elem : vec) {
+                magn += static_cast<double>(elem.second) * elem.second;
             }
             return sqrt(magn);
         }
@@ -45,6 +55,76 @@ namespace Util {
          */
         float calcCosSim(const float_vt& aTfIdf_a, const float_vt& aTfIdf_b);
 
+        /**
+         * @brief Calculates the cosine similarity between two sparse vectors, costs O(nnz) instead of O(V)
+         *
+         * @param aTfIdf_a a sparse tf-idf vector
+         * @param aTfIdf_b a sparse tf-idf vector
+         * @return the cosine similarity
+         */
+        float calcCosSim(const sparse_vt& aTfIdf_a, const sparse_vt& aTfIdf_b);
+
+        /**
+         * @brief Calculates the cosine similarity between two sparse vectors whose lengths are known, e.g. the norm length
+         *        of a document and the length of the query computed once, so only the dot product is left
+         *
+         * @param aTfIdf_a a sparse tf-idf vector
+         * @param aLength_a the length of aTfIdf_a
+         * @param aTfIdf_b a sparse tf-idf vector
+         * @param aLength_b the length of aTfIdf_b
+         * @return the cosine similarity
+         */
+        inline float calcCosSim(const sparse_vt& aTfIdf_a, const double aLength_a, const sparse_vt& aTfIdf_b, const double aLength_b) {
+            if (aLength_a == 0 || aLength_b == 0) {
+                return 0;
+            }
+            return static_cast<float>(scalar_product(aTfIdf_a, aTfIdf_b) / (aLength_a * aLength_b));
+        }
+
+        /**
+         * @brief Calculate the length of a tf-idf vector with a word embeddings vector appended, without appending it
+         *
+         * @param aTfIdf the sparse tf-idf vector
+         * @param aEmbeddings the word embeddings vector
+         * @return double the length, equal to the vectorLength of the combined vector
+         */
+        double combinedVectorLength(const sparse_vt& aTfIdf, const float_vt& aEmbeddings);
+
+        /**
+         * @brief Calculates the cosine similarity of two tf-idf vectors with their word embeddings vectors appended in
+         *        without building them. Equals calcCosSim of the vectors built with combineVectors up to the rounding of
+         *        the summation order, but allocates nothing
+         *
+         * @param aTfIdf_a a sparse tf-idf vector
+         * @param aEmbeddings_a the word embeddings vector of a
+         * @param aLength_a the combinedVectorLength of a, e.g. computed once for the query
+         * @param aTfIdf_b a sparse tf-idf vector
+         * @param aEmbeddings_b the word embeddings vector of b
+         * @return the cosine similarity
+         */
+        float calcCombinedCosSim(const sparse_vt& aTfIdf_a, const float_vt& aEmbeddings_a, const double aLength_a, const sparse_vt& aTfIdf_b, const float_vt& aEmbeddings_b);
+
+        /**
+         * @brief Calculates the cosine similarity of two tf-idf vectors with their word embeddings vectors appended whose
+         *        combined lengths are known, so only the dot products are left
+         *
+         * @param aTfIdf_a a sparse tf-idf vector
+         * @param aEmbeddings_a the word embeddings vector of a
+         * @param aLength_a the combinedVectorLength of a
+         * @param aTfIdf_b a sparse tf-idf vector
+         * @param aEmbeddings_b the word embeddings vector of b
+         * @param aLength_b the combinedVectorLength of b, e.g. cached per document
+         * @return the cosine similarity
+         */
+        inline float calcCombinedCosSim(const sparse_vt& aTfIdf_a, const float_vt& aEmbeddings_a, const double aLength_a, const sparse_vt& aTfIdf_b,
+                                        const float_vt& aEmbeddings_b, const double aLength_b) {
+            if (aLength_a == 0 || aLength_b == 0) {
+                return 0;
+            }
+            const size_t dimensions = std::min(aEmbeddings_a.size(), aEmbeddings_b.size());
+            return static_cast<float>((scalar_product(aTfIdf_a, aTfIdf_b) + dot(aEmbeddings_a.data(), aEmbeddings_b.data(), dimensions)) / (aLength_a * aLength_b));
+        }
+
         /**
          * @brief Wrapper method for \link Utility#StringOp#calcCosSim() calcCosSim() \endlink which accepts documents instead of the raw vector
          *
@@ -62,6 +142,15 @@ namespace Util {
          */
         float calcCosDist(const float_vt& aTF_IDF_a, const float_vt& aTF_IDF_b);
 
+        /**
+         * @brief Calculates the cosine distance of two sparse vectors
+         *
+         * @param aTF_IDF_a
+         * @param aTF_IDF_b
+         * @return
+         */
+        float calcCosDist(const sparse_vt& aTF_IDF_a, const sparse_vt& aTF_IDF_b);
+
         /**
          * @brief Calculates the cosine distance of two documents
          *
@@ -81,6 +170,15 @@ namespace Util {
          */
         float calcAngularSimilarity(const float_vt& aTfIdf_a, const float_vt& aTfIdf_b);
 
+        /**
+         * Returns the angular similarity between two sparse vectors
+         *
+         * @param aTfIdf_a a sparse tf-idf vector
+         * @param aTfIdf_b a sparse tf-idf vector
+         * @return
+         */
+        float calcAngularSimilarity(const sparse_vt& aTfIdf_a, const sparse_vt& aTfIdf_b);
+
         /**
          * Returns the angular similarity between two docs
          *
@@ -0,0 +1,113 @@
+#include "spimi_indexer.hh"
+
+namespace {
+    constexpr size_t kPostingBytes = sizeof(size_t) + sizeof(float);
+    constexpr size_t kTermBytes = sizeof(term_id_t) + 2 * sizeof(sizet_vt) + 64; // map node and vector headers
+}
+
+SpimiIndexer::SpimiIndexer(const std::string& aRunPath, const size_t aBudget) :
+    _runPath(aRunPath.empty() ? std::experimental::filesystem::temp_directory_path().string() : aRunPath),
+    _budget(aBudget),
+    _bytes(0),
+    _postings(),
+    _runPaths()
+{}
+
+SpimiIndexer::~SpimiIndexer() {
+    removeRuns();
+}
+
+void SpimiIndexer::add(const size_t aDocID, const sparse_vt& aTermTfVec) {
+    for (const auto& [termID, tf] : aTermTfVec) {
+        auto [it, inserted] = _postings.try_emplace(termID);
+        it->second.first.push_back(aDocID);
+        it->second.second.push_back(tf);
+        _bytes += kPostingBytes + (inserted ? kTermBytes : 0);
+    }
+    if (_bytes >= _budget) {
+        flush();
+    }
+}
+
+void SpimiIndexer::flush() {
+    if (_postings.empty()) {
+        return;
+    }
+    const std::string path = _runPath + "/evsr_spimi_" + std::to_string(::getpid()) + "_" + std::to_string(_runPaths.size()) + ".run";
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    for (const auto& [termID, postings] : _postings) {
+        Util::writeValue(out, termID);
+        Util::writeVector(out, postings.first);
+        Util::writeVector(out, postings.second);
+    }
+    out.close();
+    if (!out) {
+        throw FileException(FLF, path.c_str(), "The SPIMI run can not be written.");
+    }
+    _runPaths.push_back(path);
+    _postings.clear();
+    _bytes = 0;
+}
+
+void SpimiIndexer::merge(const size_t aNoTerms, const std::function<void(term_id_t, sizet_vt&, float_vt&)>& aFunc) {
+    sizet_vt ids;
+    float_vt tfs;
+    if (_runPaths.empty()) { // everything fit into the budget, no run was written
+        for (term_id_t termID = 0; termID < aNoTerms; ++termID) {
+            auto it = _postings.find(termID);
+            ids.clear();
+            tfs.clear();
+            if (it != _postings.end()) {
+                ids.swap(it->second.first);
+                tfs.swap(it->second.second);
+            }
+            aFunc(termID, ids, tfs);
+        }
+        _postings.clear();
+        _bytes = 0;
+        return;
+    }
+    flush();
+    std::vector<std::unique_ptr<Util::BinaryReader>> runs; // mapped, the runs are read sequentially
+    for (const std::string& path : _runPaths) {
+        runs.push_back(std::make_unique<Util::BinaryReader>(path, true));
+    }
+    // min-heap of (termID, run), the postings of a term are appended in run order, which is ascending by docID
+    using head_t = std::pair<term_id_t, size_t>;
+    std::priority_queue<head_t, std::vector<head_t>, std::greater<head_t>> heads;
+    for (size_t r = 0; r < runs.size(); ++r) {
+        if (!runs[r]->atEnd()) {
+            heads.emplace(runs[r]->readValue<term_id_t>(), r);
+        }
+    }
+    sizet_vt runIDs;
+    float_vt runTfs;
+    for (term_id_t termID = 0; termID < aNoTerms; ++termID) {
+        ids.clear();
+        tfs.clear();
+        while (!heads.empty() && heads.top().first == termID) {
+            const size_t r = heads.top().second;
+            heads.pop();
+            runs[r]->readVector(runIDs);
+            runs[r]->readVector(runTfs);
+            ids.insert(ids.end(), runIDs.begin(), runIDs.end());
+            tfs.insert(tfs.end(), runTfs.begin(), runTfs.end());
+            if (!runs[r]->atEnd()) {
+                heads.emplace(runs[r]->readValue<term_id_t>(), r);
+            }
+        }
+        aFunc(termID, ids, tfs);
+    }
+    if (!heads.empty()) {
+        throw InvalidArgumentException(FLF, "The SPIMI runs contain the unknown termID " + std::to_string(heads.top().first) + ".");
+    }
+    runs.clear();
+    removeRuns();
+}
+
+void SpimiIndexer::removeRuns() {
+    for (const std::string& path : _runPaths) {
+        std::remove(path.c_str());
+    }
+    _runPaths.clear();
+}
@@ -0,0 +1,82 @@
+/**
+ *	@file 	spimi_indexer.hh
+ *	@brief  Implements single-pass in-memory indexing (SPIMI). The postings of the documents are collected per term
+ *          until the memory budget is reached, then they are written as a run sorted by termID to a temporary file.
+ *          At the end all runs are merged k-way, so the posting lists are assembled one term at a time
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+#include "exception.hh"
+#include "serialization_util.hh"
+
+#include <cstdio>
+#include <experimental/filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+class SpimiIndexer {
+  public:
+    /**
+     * @brief Construct a new SPIMI indexer
+     *
+     * @param aRunPath the directory for the temporary runs, the temporary directory of the system if empty
+     * @param aBudget the memory budget for the collected postings in bytes
+     */
+    explicit SpimiIndexer(const std::string& aRunPath, const size_t aBudget);
+    SpimiIndexer(const SpimiIndexer&) = delete;
+    SpimiIndexer& operator=(const SpimiIndexer&) = delete;
+    ~SpimiIndexer();
+
+  public:
+    /**
+     * @brief Add the postings of a document. The documents have to be added in ascending order of their ids
+     *
+     * @param aDocID the id of the document
+     * @param aTermTfVec the (termID, tf) vector of the document
+     */
+    void add(const size_t aDocID, const sparse_vt& aTermTfVec);
+    /**
+     * @brief Merge the runs and pass the posting list of every term in [0, aNoTerms) to aFunc, in ascending order of the
+     *        termIDs. Terms without postings get empty lists. The runs are removed afterwards
+     *
+     * @param aNoTerms the number of terms
+     * @param aFunc the function which gets the termID, the docIDs and the tfs of each posting list
+     */
+    void merge(const size_t aNoTerms, const std::function<void(term_id_t, sizet_vt&, float_vt&)>& aFunc);
+    /**
+     * @brief Get the number of runs written so far
+     *
+     * @return size_t the number of runs
+     */
+    inline size_t getNoRuns() const { return _runPaths.size(); }
+
+  private:
+    /**
+     * @brief Write the collected postings as a run sorted by termID and clear them
+     */
+    void flush();
+    /**
+     * @brief Remove all runs
+     */
+    void removeRuns();
+
+  private:
+    using postings_mt = std::map<term_id_t, std::pair<sizet_vt, float_vt>>;
+
+    const std::string _runPath;
+    const size_t _budget;
+    size_t _bytes;
+    postings_mt _postings;
+    string_vt _runPaths;
+};
@@ -16,6 +16,16 @@ namespace Util {
         boost::split(aOutputVector, aString, boost::is_any_of(std::string(1, aDelimiter)));
     }
 
+    void splitStringView(const std::string_view aString, const char aDelimiter, strview_vt& aOutputVector) {
+        aOutputVector.clear();
+        size_t start = 0;
+        for (size_t pos = aString.find(aDelimiter); pos != std::string_view::npos; pos = aString.find(aDelimiter, start)) {
+            aOutputVector.push_back(aString.substr(start, pos - start));
+            start = pos + 1;
+        }
+        aOutputVector.push_back(aString.substr(start));
+    }
+
     bool endsWith(const std::string& aString, const std::string& aSuffix) { return boost::algorithm::ends_with(aString, aSuffix); }
 
     std::string toLower(const std::string& aString) {
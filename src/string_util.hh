@@ -19,6 +19,7 @@
 #include <boost/algorithm/string_regex.hpp>
 #include <boost/regex.hpp>
 #include <string>
+#include <string_view>
 #include <regex>
 #include <vector>
 #include <functional>
@@ -43,6 +44,16 @@ namespace Util
          */
         void splitStringBoost(const std::string& aString, const char aDelimiter, string_vt& aOutputVector);
 
+        /**
+         * @brief Splits a given string view with the given delimiter without copying, the tokens point into aString.
+         *        Produces the same tokens as @see splitStringBoost (including empty ones)
+         *
+         * @param aString the input string to split
+         * @param aDelimiter the delimiter used for splitting
+         * @param aOutputVector the vector to store the token views in, cleared first
+         */
+        void splitStringView(const std::string_view aString, const char aDelimiter, strview_vt& aOutputVector);
+
         /**
          * @brief Checks whether a given string ends with a specified suffix. Wrapper function for call to boost
          *
@@ -0,0 +1,39 @@
+#include "term_dictionary.hh"
+
+/**
+ * @brief Construct a new Term Dictionary:: Term Dictionary object
+ *
+ */
+TermDictionary::TermDictionary() :
+    _term_ids(),
+    _terms()
+{}
+
+term_id_t TermDictionary::insert(const std::string& aTerm) {
+    auto [it, inserted] = _term_ids.try_emplace(aTerm, static_cast<term_id_t>(_terms.size()));
+    if (inserted) {
+        _terms.push_back(aTerm);
+    }
+    return it->second;
+}
+
+const std::string& TermDictionary::getTerm(const term_id_t aTermID) const {
+    if (aTermID < _terms.size())
+        return _terms[aTermID];
+    else
+        throw InvalidArgumentException(FLF, "The term id " + std::to_string(aTermID) + " does not appear in the term dictionary.");
+}
+
+void TermDictionary::save(std::ostream& aOut) const {
+    Util::writeStrings(aOut, _terms);
+}
+
+void TermDictionary::load(Util::BinaryReader& aReader) {
+    string_vt terms;
+    aReader.readStrings(terms);
+    _term_ids.clear();
+    _terms.clear();
+    for (const std::string& term : terms) {
+        insert(term);
+    }
+}
@@ -0,0 +1,95 @@
+/**
+ *	@file 	term_dictionary.hh
+ *	@brief  Implements the term dictionary which assigns a dense integer id to every distinct term of the
+ *          collection. All index structures are addressed by these ids, strings are only resolved at the edges
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+#include "exception.hh"
+#include "trace.hh"
+#include "serialization_util.hh"
+
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+class TermDictionary {
+  private:
+    TermDictionary();
+    TermDictionary(const TermDictionary&) = delete;
+    TermDictionary(TermDictionary&&) = delete;
+    TermDictionary& operator=(const TermDictionary&) = delete;
+    TermDictionary& operator=(TermDictionary&&) = delete;
+    ~TermDictionary() = default;
+
+  public:
+    static constexpr term_id_t kNoTerm = std::numeric_limits<term_id_t>::max(); // returned for unknown terms
+
+    /**
+     * @brief Get the TermDictionary Singleton instance
+     *
+     * @return TermDictionary& a reference to the TermDictionary Singleton instance
+     */
+    inline static TermDictionary& getInstance() {
+        static TermDictionary lInstance;
+        return lInstance;
+    }
+
+  public:
+    /**
+     * @brief Insert aTerm if it is not in the dictionary yet and return its id
+     *
+     * @param aTerm the term to insert
+     * @return term_id_t the (new or existing) id of aTerm
+     */
+    term_id_t insert(const std::string& aTerm);
+    /**
+     * @brief Get the id of aTerm
+     *
+     * @param aTerm the term
+     * @return term_id_t the id of aTerm or kNoTerm if the term does not appear in the collection
+     */
+    inline term_id_t getID(const std::string& aTerm) const {
+        auto it = _term_ids.find(aTerm);
+        return (it != _term_ids.end()) ? it->second : kNoTerm;
+    }
+    /**
+     * @brief Get the term with id aTermID
+     *
+     * @param aTermID the id of the term
+     * @return const std::string& the term
+     */
+    const std::string& getTerm(const term_id_t aTermID) const;
+    /**
+     * @brief Get all terms, the position of a term is its id
+     *
+     * @return const string_vt& the terms
+     */
+    inline const string_vt& getTerms() const { return _terms; }
+    /**
+     * @brief Get the number of distinct terms
+     *
+     * @return size_t the size of the dictionary
+     */
+    inline size_t size() const { return _terms.size(); }
+    /**
+     * @brief Write the terms to a snapshot
+     *
+     * @param aOut the output stream
+     */
+    void save(std::ostream& aOut) const;
+    /**
+     * @brief Restore the terms written by @see save, the terms keep their ids
+     *
+     * @param aReader the snapshot reader
+     */
+    void load(Util::BinaryReader& aReader);
+
+  private:
+    std::unordered_map<std::string, term_id_t> _term_ids; // term, id: [("Frodo", 0), ("Sam", 1), ...]
+    string_vt _terms;                                      // id -> term
+};
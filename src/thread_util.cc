@@ -0,0 +1,54 @@
+#include "thread_util.hh"
+
+namespace Util {
+
+    sizet_vt shardBoundaries(const size_t aSize, const size_t aNoShards) {
+        sizet_vt boundaries(aNoShards + 1);
+        for (size_t s = 0; s <= aNoShards; ++s) {
+            boundaries[s] = aSize * s / aNoShards;
+        }
+        return boundaries;
+    }
+
+    void parallelFor(const size_t aSize, const size_t aNoThreads, const std::function<void(size_t, size_t)>& aFunc, size_t aGrainSize) {
+        if (aSize == 0) {
+            return;
+        }
+        if (aGrainSize == 0) {
+            aGrainSize = std::max<size_t>(1, aSize / (std::max<size_t>(1, aNoThreads) * 8));
+        }
+        const size_t noRanges = (aSize + aGrainSize - 1) / aGrainSize;
+        const size_t noThreads = std::min(std::max<size_t>(1, aNoThreads), noRanges);
+        if (noThreads == 1) {
+            aFunc(0, aSize);
+            return;
+        }
+        std::atomic<size_t> nextRange(0);
+        std::vector<std::exception_ptr> errors(noThreads);
+        auto worker = [&](const size_t t) {
+            try {
+                for (size_t r = nextRange++; r < noRanges; r = nextRange++) {
+                    aFunc(r * aGrainSize, std::min(aSize, (r + 1) * aGrainSize));
+                }
+            } catch (...) {
+                errors[t] = std::current_exception();
+                nextRange = noRanges; // the other threads stop after their current range
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(noThreads - 1);
+        for (size_t t = 1; t < noThreads; ++t) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        for (const std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+} // namespace Util
@@ -0,0 +1,43 @@
+/*
+ * @file    thread_util.hh
+ * @brief   Helpers to run the index construction on several threads. Work is handed out as contiguous
+ *          index ranges, so results which are written per range can be merged in a fixed order and do not
+ *          depend on the number of threads or on the scheduling.
+ *
+ * @section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace Util {
+
+    /**
+     * @brief Split [0, aSize) into aNoShards contiguous shards of (almost) equal size
+     *
+     * @param aSize the size of the range
+     * @param aNoShards the number of shards, at least one
+     * @return sizet_vt the aNoShards + 1 shard boundaries, shard s is [result[s], result[s + 1])
+     */
+    sizet_vt shardBoundaries(const size_t aSize, const size_t aNoShards);
+
+    /**
+     * @brief Call aFunc(begin, end) for disjoint ranges covering [0, aSize) on up to aNoThreads threads. The ranges are
+     *        aGrainSize long and handed out in ascending order to whichever thread is free. An exception thrown by
+     *        aFunc is rethrown on the calling thread after all threads finished
+     *
+     * @param aSize the size of the range
+     * @param aNoThreads the maximal number of threads, the calling thread does the work if it is one
+     * @param aFunc the function to call for every range
+     * @param aGrainSize the length of the ranges, if 0 it is chosen such that every thread gets several ranges
+     */
+    void parallelFor(const size_t aSize, const size_t aNoThreads, const std::function<void(size_t, size_t)>& aFunc, size_t aGrainSize = 0);
+
+} // namespace Util
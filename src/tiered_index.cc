@@ -14,55 +14,62 @@ void TieredIndex::init(const control_block_t& aControlBlock) {
     }
 }
 
-bool TieredIndex::insert(const std::string& aTerm, const std::map<size_t, PostingList>& aTierMap) {
-    return _term_tier_map.insert(std::make_pair(aTerm, aTierMap)).second;
+bool TieredIndex::insert(const term_id_t aTermID, const tier_postinglist_mt& aTierMap) {
+    if (aTermID >= _term_tier_map.size()) {
+        _term_tier_map.resize(aTermID + 1);
+    } else if (!_term_tier_map[aTermID].empty()) {
+        return false;
+    }
+    _term_tier_map[aTermID] = aTierMap;
+    return true;
 }
 
-tiered_posting_map_iter_t TieredIndex::find(const std::string& aKey) { return _term_tier_map.find(aKey); }
-
-void TieredIndex::erase(const std::string& aKey) { _term_tier_map.erase(aKey); }
-
-void TieredIndex::erase(const tiered_posting_map_iter_t aIterator) { _term_tier_map.erase(aIterator); }
-
-sizet_vt TieredIndex::getDocIDList(const size_t top, const string_vt& terms) const {
+sizet_vt TieredIndex::getDocIDList(const size_t top, const termid_vt& termIDs) const {
     sizet_vt qids;
     size_t tier = 0;
 
-    std::vector<sizet_vt> vecs;
-    vecs.resize(terms.size());
+    std::vector<const sizet_vt*> lists; // the posting arrays of one tier, merged in place without copying
+    std::vector<sizet_vt> buffers(termIDs.size()); // decoded ids of compressed posting lists
+    lists.reserve(termIDs.size());
+    sizet_vt tierIDs;
+    sizet_vt merged;
     do {
-        for (size_t i = 0; i < terms.size(); ++i) {
-            try {
-                const sizet_vt& tierIDs = this->getPostingList(terms.at(i), tier).getIDs();
-                sizet_vt& termIDs = vecs.at(i);
-                termIDs.insert(termIDs.end(), tierIDs.begin(), tierIDs.end());
-                vecs.at(i) = termIDs;
-            } catch (const InvalidArgumentException& e) { continue; /* One of the (query) terms does not appear in the document collection. */ }
+        lists.clear();
+        for (size_t i = 0; i < termIDs.size(); ++i) {
+            if (termIDs[i] < _term_tier_map.size()) { lists.push_back(&_term_tier_map[termIDs[i]].at(tier).getIDs(buffers[i])); }
         }
-        Util::orPostingLists(vecs, qids);
+        Util::orPostingLists(lists, tierIDs);
+        merged.clear();
+        std::set_union(qids.begin(), qids.end(), tierIDs.begin(), tierIDs.end(), std::back_inserter(merged)); // add the ids of this tier
+        qids.swap(merged);
     } while (qids.size() < top && ++tier < _num_tiers);
     return qids; // may return < top if all tiers are processed and we did not find enough qualifying ids
 }
 
+const PostingList& TieredIndex::getPostingList(const term_id_t aTermID, const size_t aTier) const {
+    if (aTermID < _term_tier_map.size())
+        return _term_tier_map[aTermID].at(aTier);
+    else
+        throw InvalidArgumentException(FLF, "The term id " + std::to_string(aTermID) + " does not appear in the document collection.");
+}
+
 const PostingList& TieredIndex::getPostingList(const std::string& aTerm, const size_t aTier) const {
-    if (_term_tier_map.find(aTerm) != _term_tier_map.end())
-        return _term_tier_map.at(aTerm).at(aTier);
+    const term_id_t lTermID = TermDictionary::getInstance().getID(aTerm);
+    if (lTermID < _term_tier_map.size()) // kNoTerm is always out of range
+        return _term_tier_map[lTermID].at(aTier);
     else
         throw InvalidArgumentException(FLF, "The term " + aTerm + " does not appear in the document collection.");
 }
 
 size_t TieredIndex::getNoDocs(const std::string& aTerm, const size_t aTier) {
-    if (_term_tier_map.find(aTerm) != _term_tier_map.end())
-        return _term_tier_map.at(aTerm).at(aTier).getPosting().size();
-    else
-        throw InvalidArgumentException(FLF, "The term " + aTerm + " does not appear in the document collection.");
+    return this->getPostingList(aTerm, aTier).size();
 }
 
 std::ostream& operator<<(std::ostream& strm, const TieredIndex& ti) {
     auto& ttpm = ti.getPostingLists();
-    for (auto itt = ttpm.begin(); itt != ttpm.end(); ++itt) {
-        std::string termt = itt->first;
-        const std::map<size_t, PostingList>& tierplmap = itt->second;
+    for (size_t termID = 0; termID < ttpm.size(); ++termID) {
+        const std::string& termt = TermDictionary::getInstance().getTerm(termID);
+        const tier_postinglist_mt& tierplmap = ttpm[termID];
         strm << termt << " -> [ ";
         for (auto itm = tierplmap.begin(); itm != tierplmap.end(); ++itm) {
             size_t tier = itm->first;
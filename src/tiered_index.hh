@@ -13,6 +13,7 @@
 #include "ir_util.hh"
 #include "document.hh"
 #include "posting_list.hh"
+#include "term_dictionary.hh"
 
 class TieredIndex {
     friend class IndexManager;
@@ -27,32 +28,13 @@ class TieredIndex {
 
   private:
     /**
-     * @brief Insert aTierMap for aTerm, if this term is not in the tiered index yet
+     * @brief Insert aTierMap for aTermID, if this term is not in the tiered index yet
      *
-     * @param aTerm the term to insert the tierMap for
+     * @param aTermID the id of the term to insert the tierMap for
      * @param aTierMap the tierMap to insert
      * @return whether the insertion was successful
      */
-    bool insert(const std::string& aTerm, const std::map<size_t, PostingList>& aTierMap);
-    /**
-     * @brief Find the map of tiers to postingLists for aKey and return an iterator
-     *
-     * @param aKey the term to find in the map
-     * @return tiered_posting_map_iter_t the map<tier, postingList>::iterator for aKey (the term)
-     */
-    tiered_posting_map_iter_t find(const std::string& aKey);
-    /**
-     * @brief Erase the TieredIndex entry of aKey
-     *
-     * @param aKey the term to erase
-     */
-    void erase(const std::string& aKey);
-    /**
-     * @brief Erase the postingList for aIterator
-     *
-     * @param aIterator the iterator to erase with
-     */
-    void erase(const tiered_posting_map_iter_t aIterator);
+    bool insert(const term_id_t aTermID, const tier_postinglist_mt& aTierMap);
 
     /**
      * @brief Get the TieredIndex Singleton instance.
@@ -73,17 +55,17 @@ class TieredIndex {
     /**
      * @brief Get the Term Tier Posting Map object
      * 
-     * @return str_tierplmap_mt* 
+     * @return tierplmap_vt* the tier maps, indexed by termID
      */
-    inline str_tierplmap_mt* getTermTierPostingMap() { return &_term_tier_map; }
+    inline tierplmap_vt* getTermTierPostingMap() { return &_term_tier_map; }
 
   public:
     /**
      * @brief Get the posting lists
      *
-     * @return str_tierplmap_mt& the posting lists
+     * @return tierplmap_vt& the posting lists, indexed by termID
      */
-    inline const str_tierplmap_mt& getPostingLists() const { return _term_tier_map; }
+    inline const tierplmap_vt& getPostingLists() const { return _term_tier_map; }
     /**
      * @brief Get the dictionary size
      *
@@ -101,13 +83,21 @@ class TieredIndex {
      * @brief Get the top doc ids
      *
      * @param top the requested amount of results (ids)
-     * @param terms the query terms for which to retrieve the ids
+     * @param termIDs the ids of the query terms for which to retrieve the ids
      * @return sizet_vt the ids to return
      */
-    sizet_vt getDocIDList(const size_t top, const string_vt& terms) const;
+    sizet_vt getDocIDList(const size_t top, const termid_vt& termIDs) const;
     /**
      * @brief Get the Posting List object
      *
+     * @param aTermID
+     * @param aTier
+     * @return PostingList&
+     */
+    const PostingList& getPostingList(const term_id_t aTermID, const size_t aTier) const;
+    /**
+     * @brief Get the Posting List object, resolves the term with the TermDictionary
+     *
      * @param aTerm
      * @param aTier
      * @return PostingList&
@@ -134,5 +124,5 @@ class TieredIndex {
   private:
     const control_block_t* _cb;
     size_t _num_tiers;
-    str_tierplmap_mt _term_tier_map;
+    tierplmap_vt _term_tier_map; // indexed by termID
 };
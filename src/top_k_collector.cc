@@ -0,0 +1,27 @@
+#include "top_k_collector.hh"
+
+/**
+ * @brief Construct a new Top K Collector:: Top K Collector object
+ *
+ * @param aTopK how many results are collected, 0 collects all results
+ * @param aAscending true if smaller scores are better
+ */
+TopKCollector::TopKCollector(const size_t aTopK, const bool aAscending) :
+    _topK(aTopK),
+    _ascending(aAscending),
+    _heap()
+{
+    _heap.reserve(aTopK);
+}
+
+pair_sizet_float_vt TopKCollector::finish() {
+    auto cmp = [this](const std::pair<size_t, float>& a, const std::pair<size_t, float>& b) { return better(a, b); };
+    if (_topK) {
+        std::sort_heap(_heap.begin(), _heap.end(), cmp);
+    } else {
+        std::sort(_heap.begin(), _heap.end(), cmp);
+    }
+    pair_sizet_float_vt results;
+    results.swap(_heap);
+    return results;
+}
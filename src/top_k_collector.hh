@@ -0,0 +1,98 @@
+/**
+ *	@file 	top_k_collector.hh
+ *	@brief  Implements the top-k collector shared by all search functions. The scored candidates are pushed into a
+ *          bounded heap while they are scored, so selecting the top-k costs O(n log k) instead of sorting all n.
+ *          Ties are broken by the smaller docID, so the results are reproducible
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "types.hh"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+class TopKCollector {
+  public:
+    /**
+     * @brief Construct a new Top K Collector object
+     *
+     * @param aTopK how many results are collected, 0 collects all results
+     * @param aAscending true if smaller scores are better (distances), false if larger scores are better (similarities)
+     */
+    explicit TopKCollector(const size_t aTopK, const bool aAscending = false);
+    TopKCollector(const TopKCollector&) = delete;
+    TopKCollector(TopKCollector&&) = delete;
+    TopKCollector& operator=(const TopKCollector&) = delete;
+    TopKCollector& operator=(TopKCollector&&) = delete;
+    ~TopKCollector() = default;
+
+  public:
+    /**
+     * @brief Whether aElem1 ranks before aElem2
+     *
+     * @param aElem1 the first (docID, score) pair
+     * @param aElem2 the second (docID, score) pair
+     * @return bool true if aElem1 ranks before aElem2
+     */
+    inline bool better(const std::pair<size_t, float>& aElem1, const std::pair<size_t, float>& aElem2) const {
+        if (aElem1.second != aElem2.second) { return _ascending ? aElem1.second < aElem2.second : aElem1.second > aElem2.second; }
+        return aElem1.first < aElem2.first;
+    }
+    /**
+     * @brief Whether k results are collected, i.e. a new result has to beat @see threshold
+     *
+     * @return bool true if the collector is full
+     */
+    inline bool full() const { return _topK && _heap.size() == _topK; }
+    /**
+     * @brief Get the score of the worst collected result, only valid if @see full
+     *
+     * @return float the threshold
+     */
+    inline float threshold() const { return _heap.front().second; }
+    /**
+     * @brief Whether a result with score aScore could still enter the top-k (ties are decided by the docID)
+     *
+     * @param aScore the score or an upper bound of the score
+     * @return bool true if the result could enter
+     */
+    inline bool canEnter(const float aScore) const {
+        return !full() || (_ascending ? aScore <= threshold() : aScore >= threshold());
+    }
+    /**
+     * @brief Push the result (aDocID, aScore), it is only kept if it ranks among the top-k
+     *
+     * @param aDocID the docID
+     * @param aScore the score
+     * @return bool true if the result is kept
+     */
+    inline bool push(const size_t aDocID, const float aScore) {
+        const std::pair<size_t, float> result(aDocID, aScore);
+        auto cmp = [this](const std::pair<size_t, float>& a, const std::pair<size_t, float>& b) { return better(a, b); };
+        if (!full()) {
+            _heap.push_back(result);
+            if (_topK) { std::push_heap(_heap.begin(), _heap.end(), cmp); }
+            return true;
+        }
+        if (!better(result, _heap.front())) { return false; }
+        std::pop_heap(_heap.begin(), _heap.end(), cmp);
+        _heap.back() = result;
+        std::push_heap(_heap.begin(), _heap.end(), cmp);
+        return true;
+    }
+    /**
+     * @brief Get the collected results, best first. The collector is empty afterwards
+     *
+     * @return pair_sizet_float_vt the (docID, score) pairs
+     */
+    pair_sizet_float_vt finish();
+
+  private:
+    const size_t _topK;
+    const bool _ascending;
+    pair_sizet_float_vt _heap; // heap with the worst result on top, unordered if _topK is 0
+};
@@ -16,6 +16,7 @@
 #include <unordered_set>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using size_t = std::size_t;
@@ -27,6 +28,7 @@ using float_vt = std::vector<float>;
 using sizet_vt = std::vector<size_t>;
 using string_vt = std::vector<std::string>;
 using string_vvt = std::vector<string_vt>;
+using strview_vt = std::vector<std::string_view>; // views into a buffer which outlives them, e.g. @see Util::MappedFile
 using str_set = std::unordered_set<std::string>;
 using str_int_mt = std::map<std::string, uint>;
 using str_float_mt = std::map<std::string, float>;
@@ -35,8 +37,62 @@ using str_str_mt = std::unordered_map<std::string, std::string>;
 using sizet_float_mt = std::map<size_t, float>;
 using float_vector_vt = std::vector<std::vector<float>>;
 using pair_sizet_float_vt = std::vector<std::pair<size_t, float>>;
+using term_id_t = uint32_t;                        // dense id of a term, @see TermDictionary
+using termid_vt = std::vector<term_id_t>;          // list of termIDs
+using sparse_elem_t = std::pair<term_id_t, float>; // (termID, weight) entry of a sparse vector
+using sparse_vt = std::vector<sparse_elem_t>;      // sparse vector, sorted ascending by termID
 using sizet_set = std::set<size_t>;
 
+enum POSTING_CODEC {
+    kNoCodec = -1,
+    kUNCOMPRESSED = 0, // plain docID and tf arrays
+    kVARBYTE = 1,      // delta gaps with variable byte encoding, quantized tfs
+    kBITPACK = 2,      // delta gaps with one bit width per block (binary packing), quantized tfs
+    kNumberOfCodecs = 3
+};
+
+inline std::string codecToString(POSTING_CODEC aCodec) {
+    switch (aCodec) {
+        case kUNCOMPRESSED: return "kUNCOMPRESSED"; break;
+        case kVARBYTE: return "kVARBYTE"; break;
+        case kBITPACK: return "kBITPACK"; break;
+        default: return "Codec not supported"; break;
+    }
+}
+
+inline POSTING_CODEC stringToCodec(const std::string& aCodec)
+{
+    if(aCodec == "kUNCOMPRESSED"){ return kUNCOMPRESSED; }
+    else if(aCodec == "kVARBYTE"){ return kVARBYTE; }
+    else if(aCodec == "kBITPACK"){ return kBITPACK; }
+    else{ return kNoCodec; }
+}
+
+enum EMBEDDING_PRECISION {
+    kNoPrecision = -1,
+    kFP32 = 0, // 32 bit floats
+    kFP16 = 1, // IEEE 754 half precision floats
+    kINT8 = 2, // 8 bit integers with one float scale per vector
+    kNumberOfPrecisions = 3
+};
+
+inline std::string precisionToString(EMBEDDING_PRECISION aPrecision) {
+    switch (aPrecision) {
+        case kFP32: return "kFP32"; break;
+        case kFP16: return "kFP16"; break;
+        case kINT8: return "kINT8"; break;
+        default: return "Precision not supported"; break;
+    }
+}
+
+inline EMBEDDING_PRECISION stringToPrecision(const std::string& aPrecision)
+{
+    if(aPrecision == "kFP32"){ return kFP32; }
+    else if(aPrecision == "kFP16"){ return kFP16; }
+    else if(aPrecision == "kINT8"){ return kINT8; }
+    else{ return kNoPrecision; }
+}
+
 struct control_block_t {
     
     const bool _trace;   // indicate if tracing is activated
@@ -55,6 +111,30 @@ struct control_block_t {
     const uint _noTiers;      // number of tiers for the tiered index
     const uint _noDimensions; // the number of dimensions for the random projection
     const uint _seed;         // seed for random projection and selecting the cluster leaders
+    const uint _noThreads;    // the number of threads used to parse the files and build the indices
+
+    const POSTING_CODEC _postingCodec; // the codec used to compress the posting lists
+
+    const std::string _indexPath; // the path of the index snapshot, empty if no snapshot is used
+
+    const uint _spimiBudget;       // the memory budget in MB for the postings of the external (SPIMI) build, 0 builds in memory
+    const std::string _spimiPath;  // the directory for the temporary runs of the external build
+
+    const bool _filterWordEmbeddings;   // indicate if only the word embeddings of the collection terms are kept
+    const bool _wordEmbeddingsFallback; // indicate if the full word embeddings stay mapped for the other query terms
+    const EMBEDDING_PRECISION _embeddingPrecision; // the precision of the stored word and document embeddings
+
+    const uint _hnswM;              // the number of neighbours per layer of the HNSW graph, 0 if no graph is built
+    const uint _hnswEfConstruction; // the size of the candidate list while building the HNSW graph
+    const uint _hnswEfSearch;       // the default size of the candidate list of a HNSW search
+
+    const uint _ivfLists;     // the number of lists of the IVF-PQ index, 0 if no index is built
+    const uint _ivfSubspaces; // the number of product quantization subspaces (bytes per document)
+    const uint _ivfNprobe;    // the default number of lists an IVF-PQ search probes
+
+    const uint _lshTables;   // the number of hash tables of the LSH index, 0 if no index is built
+    const uint _lshBandBits; // the number of signature bits of a band, the key of one table
+    const uint _lshProbes;   // the default number of buckets a LSH search probes per table
 
     bool trace() const { return _trace; }
     bool measure() const { return _measure; }
@@ -70,6 +150,23 @@ struct control_block_t {
     uint tiers() const { return _noTiers; }
     uint dimensions() const { return _noDimensions; }
     uint seed() const { return _seed; }
+    uint threads() const { return _noThreads; }
+    POSTING_CODEC postingCodec() const { return _postingCodec; }
+    const std::string& indexPath() const { return _indexPath; }
+    uint spimiBudget() const { return _spimiBudget; }
+    const std::string& spimiPath() const { return _spimiPath; }
+    bool filterWordEmbeddings() const { return _filterWordEmbeddings; }
+    bool wordEmbeddingsFallback() const { return _wordEmbeddingsFallback; }
+    EMBEDDING_PRECISION embeddingPrecision() const { return _embeddingPrecision; }
+    uint hnswM() const { return _hnswM; }
+    uint hnswEfConstruction() const { return _hnswEfConstruction; }
+    uint hnswEfSearch() const { return _hnswEfSearch; }
+    uint ivfLists() const { return _ivfLists; }
+    uint ivfSubspaces() const { return _ivfSubspaces; }
+    uint ivfNprobe() const { return _ivfNprobe; }
+    uint lshTables() const { return _lshTables; }
+    uint lshBandBits() const { return _lshBandBits; }
+    uint lshProbes() const { return _lshProbes; }
 };
 using CB = control_block_t;
 
@@ -89,7 +186,24 @@ inline std::ostream& operator<<(std::ostream& strm, const CB& cb) {
          << "TopK:                 " << cb.results() << "\n"
          << "Number of Tiers:      " << cb.tiers() << "\n"
          << "Number of Dimensions: " << cb.dimensions() << "\n"
-         << "Seed:                 " << cb.seed() << "\n";
+         << "Seed:                 " << cb.seed() << "\n"
+         << "Number of Threads:    " << cb.threads() << "\n"
+         << "Posting Codec:        " << codecToString(cb.postingCodec()) << "\n"
+         << "Index Path:           " << cb.indexPath() << "\n"
+         << "SPIMI Budget (MB):    " << cb.spimiBudget() << "\n"
+         << "SPIMI Path:           " << cb.spimiPath() << "\n"
+         << "Filter Embeddings:    " << ((cb.filterWordEmbeddings()) ? "True" : "False") << "\n"
+         << "Embeddings Fallback:  " << ((cb.wordEmbeddingsFallback()) ? "True" : "False") << "\n"
+         << "Embedding Precision:  " << precisionToString(cb.embeddingPrecision()) << "\n"
+         << "HNSW M:               " << cb.hnswM() << "\n"
+         << "HNSW efConstruction:  " << cb.hnswEfConstruction() << "\n"
+         << "HNSW efSearch:        " << cb.hnswEfSearch() << "\n"
+         << "IVF Lists:            " << cb.ivfLists() << "\n"
+         << "IVF Subspaces:        " << cb.ivfSubspaces() << "\n"
+         << "IVF nprobe:           " << cb.ivfNprobe() << "\n"
+         << "LSH Tables:           " << cb.lshTables() << "\n"
+         << "LSH Band Bits:        " << cb.lshBandBits() << "\n"
+         << "LSH Probes:           " << cb.lshProbes() << "\n";
     return strm << std::endl;
 }
 
@@ -104,7 +218,14 @@ enum IR_MODE {
     kCLUSTER = 6,
     kCLUSTER_RAND =7,
     kCLUSTER_W2V = 8,
-    kNumberOfModes = 9
+    kVANILLA_TAAT = 9,
+    kVANILLA_WAND = 10,
+    kVANILLA_BMW = 11,
+    kVANILLA_MAXSCORE = 12,
+    kHNSW_W2V = 13,
+    kIVFPQ_W2V = 14,
+    kLSH_RAND = 15,
+    kNumberOfModes = 16
 };
 
 inline std::string modeToString(IR_MODE aMode) {
@@ -129,6 +250,20 @@ inline std::string modeToString(IR_MODE aMode) {
             return "Cluster_RAND"; break;          // not needed but used for convention
         case kCLUSTER_W2V: 
             return "Cluster_W2V"; break;          // not needed but used for convention
+        case kVANILLA_TAAT: 
+            return "VanillaVSM_TAAT"; break;       // not needed but used for convention
+        case kVANILLA_WAND: 
+            return "VanillaVSM_WAND"; break;       // not needed but used for convention
+        case kVANILLA_BMW: 
+            return "VanillaVSM_BMW"; break;       // not needed but used for convention
+        case kVANILLA_MAXSCORE: 
+            return "VanillaVSM_MAXSCORE"; break;       // not needed but used for convention
+        case kHNSW_W2V: 
+            return "HNSW_W2V"; break;       // not needed but used for convention
+        case kIVFPQ_W2V: 
+            return "IVFPQ_W2V"; break;       // not needed but used for convention
+        case kLSH_RAND: 
+            return "LSH_RAND"; break;       // not needed but used for convention
         default:
             return "Mode not supported"; break;
     }
@@ -146,6 +281,13 @@ inline IR_MODE stringToMode(const std::string& aMode)
     else if(aMode == "kCLUSTER"){ return kCLUSTER; } 
     else if(aMode == "kCLUSTER_RAND"){ return kCLUSTER_RAND; } 
     else if(aMode == "kCLUSTER_W2V"){ return kCLUSTER_W2V; } 
+    else if(aMode == "kVANILLA_TAAT"){ return kVANILLA_TAAT; } 
+    else if(aMode == "kVANILLA_WAND"){ return kVANILLA_WAND; } 
+    else if(aMode == "kVANILLA_BMW"){ return kVANILLA_BMW; } 
+    else if(aMode == "kVANILLA_MAXSCORE"){ return kVANILLA_MAXSCORE; } 
+    else if(aMode == "kHNSW_W2V"){ return kHNSW_W2V; } 
+    else if(aMode == "kIVFPQ_W2V"){ return kIVFPQ_W2V; } 
+    else if(aMode == "kLSH_RAND"){ return kLSH_RAND; } 
     else{ return kNoMode; }
 }
 
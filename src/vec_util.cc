@@ -43,9 +43,37 @@ namespace Util {
     }
 
     float_vt combineVectors(const float_vt& a, const float_vt& b) {
-        float_vt result(a.size() + b.size());
+        float_vt result;
+        result.reserve(a.size() + b.size());
         result.insert( result.end(), a.begin(), a.end() );
         result.insert( result.end(), b.begin(), b.end() );
         return result;
     }
+
+    sparse_vt combineVectors(const sparse_vt& a, const float_vt& b, const size_t offset) {
+        sparse_vt result;
+        result.reserve(a.size() + b.size());
+        result.insert(result.end(), a.begin(), a.end());
+        for (size_t i = 0; i < b.size(); ++i) {
+            result.emplace_back(static_cast<term_id_t>(offset + i), b[i]);
+        }
+        return result;
+    }
+
+    double scalar_product(const sparse_vt& a, const sparse_vt& b) {
+        double dot = 0;
+        auto ia = a.begin();
+        auto ib = b.begin();
+        while (ia != a.end() && ib != b.end()) {
+            if (ia->first == ib->first) {
+                dot += (ia->second * ib->second);
+                ++ia;
+                ++ib;
+            } else if (ia->first < ib->first) {
+                ++ia;
+            } else
+                ++ib;
+        }
+        return dot;
+    }
 }
@@ -81,6 +81,16 @@ namespace Util {
      */
     float_vt combineVectors(const float_vt& a, const float_vt& b);
 
+    /**
+     * @brief Appends the dense vector b to the sparse vector a, the entries of b get the ids offset, offset + 1, ..
+     *
+     * @param a first (sparse) vector
+     * @param b second (dense) vector
+     * @param offset the dimension of a, i.e. the id of the first entry of b
+     * @return sparse_vt copy of the result
+     */
+    sparse_vt combineVectors(const sparse_vt& a, const float_vt& b, const size_t offset);
+
     /**
      * @brief Calculates the dot product of two vectors
      *
@@ -98,6 +108,30 @@ namespace Util {
         return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
     }
 
+    /**
+     * @brief Calculates the dot product of two sparse vectors by merging their sorted ids
+     *
+     * @param a first sparse vector
+     * @param b second sparse vector
+     * @return the scalar product
+     */
+    double scalar_product(const sparse_vt& a, const sparse_vt& b);
+
+    /**
+     * @brief Calculates the dot product of a sparse and a dense vector
+     *
+     * @param a the sparse vector
+     * @param b the dense vector, has to cover all ids of a
+     * @return the scalar product
+     */
+    inline double scalar_product(const sparse_vt& a, const float_vt& b) {
+        double dot = 0;
+        for (const auto& [id, weight] : a) {
+            dot += weight * b[id];
+        }
+        return dot;
+    }
+
     /**
      * @brief the random projection hash function, returning whether the scalar product
      *        between origVec and randVec is >= 0 (this will result in a 1 in the random projection vector)
@@ -112,4 +146,18 @@ namespace Util {
         double dot = scalar_product(origVec, randVec);
         return dot >= 0;
     }
+
+    /**
+     * @brief the random projection hash function for sparse vectors, @see randomProjectionHash
+     * 
+     * @param origVec the original (sparse) vector
+     * @param randVec the random projection vector
+     * @return whether the dot product is >= 0
+     */
+    inline bool randomProjectionHash(const sparse_vt& origVec, const float_vt& randVec) {
+        if (!origVec.empty() && origVec.back().first >= randVec.size()) throw VectorException(__FILE__, __LINE__, __PRETTY_FUNCTION__, "Vectors are not the same size");
+
+        double dot = scalar_product(origVec, randVec);
+        return dot >= 0;
+    }
 }
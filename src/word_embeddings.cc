@@ -5,7 +5,7 @@
  *
  */
 WordEmbeddings::WordEmbeddings() :
-    _cb(nullptr), _modelFile(), _wordEmbeddings(new str_float_vt_mt) // relative path from /path/to/repo/vector-space-retrieval
+    _cb(nullptr), _modelFile(), _store(), _dimensions(0), _filtered(false), _termVectors(), _hasTermVector()
 {}
 
 void WordEmbeddings::init(const control_block_t& aControlBlock) {
@@ -18,27 +18,89 @@ void WordEmbeddings::init(const control_block_t& aControlBlock) {
 }
 
 void WordEmbeddings::read(const std::string& aFile) {
-    std::ifstream file(aFile);
-    std::string line;
-    while (std::getline(file, line)) {
-        string_vt parts;
-        float_vt embedding;
-        Util::splitStringBoost(line, ' ', parts);
-        std::string word = parts[0];
-        for (size_t j = 1; j < parts.size(); ++j) {
-            embedding.push_back(stof(parts[j]));
+    if (!fs::exists(aFile)) { // like an empty model, no word has a vector
+        TRACE("WordEmbeddings: There is no model at '" + aFile + "'");
+        return;
+    }
+    if (EmbeddingStore::isStore(aFile)) {
+        _store.open(aFile);
+        _dimensions = _store.dimensions();
+        return;
+    }
+    const std::string lStoreFile = aFile + ".bin";
+    if (!fs::exists(lStoreFile) || fs::last_write_time(lStoreFile) < fs::last_write_time(aFile) || !EmbeddingStore::isStore(lStoreFile)) {
+        TRACE("WordEmbeddings: Converting the text model '" + aFile + "' into the binary store '" + lStoreFile + "'");
+        try {
+            EmbeddingStore::convert(aFile, lStoreFile, _cb->threads());
+        } catch (const FileException& e) { // e.g. a read-only directory, the store is only kept for this process
+            const std::string lTmpStoreFile = (fs::temp_directory_path() / (fs::path(aFile).filename().string() + "." + std::to_string(::getpid()) + ".bin")).string();
+            TRACE("WordEmbeddings: " + std::string(e.what()) + " Converting the text model into '" + lTmpStoreFile + "' instead");
+            EmbeddingStore::convert(aFile, lTmpStoreFile, _cb->threads());
+            _store.open(lTmpStoreFile);
+            fs::remove(lTmpStoreFile); // the mapping stays valid
+            _dimensions = _store.dimensions();
+            return;
+        }
+    }
+    _store.open(lStoreFile);
+    _dimensions = _store.dimensions();
+}
+
+void WordEmbeddings::filter(const TermDictionary& aDict) {
+    const size_t lNoWords = _store.size();
+    std::vector<std::pair<term_id_t, term_id_t>> lWordTerms(lNoWords); // (termID of the word, termID of its stem)
+    Util::parallelFor(lNoWords, _cb->threads(), [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const std::string lWord(_store.getWord(i));
+            lWordTerms[i] = std::make_pair(aDict.getID(lWord), aDict.getID(Util::stemPorter(lWord)));
+        }
+    });
+    constexpr uint32_t kNoRank = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> lBestRank(aDict.size(), kNoRank);
+    sizet_vt lBestWord(aDict.size());
+    for (size_t i = 0; i < lNoWords; ++i) {
+        for (const term_id_t termID : {lWordTerms[i].first, lWordTerms[i].second}) {
+            if (termID != TermDictionary::kNoTerm && _store.getRank(i) < lBestRank[termID]) {
+                lBestRank[termID] = _store.getRank(i);
+                lBestWord[termID] = i;
+            }
+        }
+    }
+    _termVectors.reset(_cb->embeddingPrecision(), _dimensions);
+    _hasTermVector.assign(aDict.size(), false);
+    size_t lNoKept = 0;
+    for (term_id_t termID = 0; termID < aDict.size(); ++termID) {
+        if (lBestRank[termID] != kNoRank) {
+            _termVectors.set(termID, _store.getVector(lBestWord[termID]));
+            _hasTermVector[termID] = true;
+            ++lNoKept;
         }
-        this->insert(std::make_pair(word, embedding));
     }
+    _filtered = true;
+    if (!_cb->wordEmbeddingsFallback()) {
+        _store.close();
+    }
+    TRACE("WordEmbeddings: Kept the vectors of " + std::to_string(lNoKept) + " of " + std::to_string(aDict.size()) + " terms out of " + std::to_string(lNoWords) + " words (" + std::to_string(_termVectors.memoryBytes()) + " bytes)");
 }
 
-bool WordEmbeddings::insert(const word_embedding_map_elem_t& aElement) { return (*_wordEmbeddings).insert(aElement).second; }
+bool WordEmbeddings::addTo(const std::string& word, float* out) const {
+    if (_filtered) {
+        const term_id_t lTermID = TermDictionary::getInstance().getID(word);
+        if (lTermID < _hasTermVector.size()) {
+            if (!_hasTermVector[lTermID]) { return false; }
+            _termVectors.addTo(lTermID, out);
+            return true;
+        }
+    }
+    const float* lVector = _store.find(word); // empty if it was unmapped by filter
+    if (!lVector) { return false; }
+    std::transform(out, out + _dimensions, lVector, out, std::plus<float>());
+    return true;
+}
 
-float_vt& WordEmbeddings::getWordEmbeddings(const std::string& word) {
-    if ((*_wordEmbeddings).find(word) != (*_wordEmbeddings).end())
-        return (*_wordEmbeddings).at(word);
-    else
-    {
+void WordEmbeddings::getWordEmbeddings(const std::string& word, float_vt& out) const {
+    out.assign(_dimensions, 0);
+    if (!this->addTo(word, out.data())) {
         const std::string lErrMsg = std::string("The term '") + word + std::string("' does not appear in the word embeddings collection");
         //TRACE(lErrMsg);
         throw InvalidArgumentException(FLF, lErrMsg);
@@ -47,12 +109,16 @@ float_vt& WordEmbeddings::getWordEmbeddings(const std::string& word) {
 
 void WordEmbeddings::calcWordEmbeddingsVector(const string_vt& doc_content, float_vt& out) {
     int count = 0;
-    for (auto& word : doc_content) {
-        try {
-            float_vt& wordEmbeddings = WordEmbeddings::getInstance().getWordEmbeddings(word);
-            std::transform(out.begin(), out.end(), wordEmbeddings.begin(), out.begin(), std::plus<float>());
-            count++;
-        } catch (InvalidArgumentException e) {} //*std::cout << e.what() << std::endl; }
+    if (out.size() < _dimensions) { // only for a model with more dimensions than the documents
+        float_vt lSum(_dimensions, 0);
+        for (auto& word : doc_content) {
+            count += this->addTo(word, lSum.data()) ? 1 : 0;
+        }
+        std::transform(out.begin(), out.end(), lSum.begin(), out.begin(), std::plus<float>());
+    } else {
+        for (auto& word : doc_content) {
+            count += this->addTo(word, out.data()) ? 1 : 0; // words without a vector are skipped
+        }
     }
 
     if (count == 0){
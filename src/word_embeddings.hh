@@ -11,21 +11,21 @@
 #pragma once
 
 #include "types.hh"
+#include "embedding_store.hh"
 #include "exception.hh"
+#include "quantized_vectors.hh"
+#include "ir_util.hh"
+#include "term_dictionary.hh"
+#include "thread_util.hh"
 #include "trace.hh"
 #include "string_util.hh"
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
-#include <memory>
-#include <map>
-
-using str_float_vt_mt = std::map<std::string, float_vt>;
-using word_embedding_map_elem_t = std::pair<std::string, float_vt>;
 
 class WordEmbeddings {
   private:
@@ -38,41 +38,50 @@ class WordEmbeddings {
 
   private:
     /**
-     * @brief Read an word embedding model file
+     * @brief Read an word embedding model file. A text model is converted once into a binary store next to it
+     *        (aFile + ".bin", rebuilt when the text model is newer), the store is then memory-mapped. If the store
+     *        can not be written there, the text model is converted into an unlinked store in the temporary directory
      *
-     * @param aFile the model file to read
+     * @param aFile the model file to read, a text model or a binary store
      */
     void read(const std::string& aFile);
 
+  public:
     /**
-     * @brief Insert element into manager (by std::pair element)
+     * @brief Get the word embeddings store
      *
-     * @param aElement element to be inserted
-     * @return true if insertion was successful
-     * @return false if insertion failed
+     * @return const EmbeddingStore&
      */
-    bool insert(const word_embedding_map_elem_t& aElement);
+    inline const EmbeddingStore& getStore() const { return _store; };
 
-  public:
     /**
-     * @brief Get the word embeddings map
-     *
-     * @return str_float_vt_mt&
+     * @brief Get the number of word embeddings
+     * @return
      */
-    inline str_float_vt_mt& getWordEmbeddingsMap() { return *_wordEmbeddings; };
+    inline size_t getNoWordEmbeddings() const { return _store.size(); };
 
     /**
-     * @brief Get the number of word embeddings
+     * @brief Get the number of components of every word embedding vector
      * @return
      */
-    inline size_t getNoWordEmbeddings() { return (*_wordEmbeddings).size(); };
+    inline size_t getDimensions() const { return _dimensions; };
 
     /**
      * @Get the word embedding vector of one word
      * @param word
-     * @return
+     * @param out the getDimensions() components of the vector, dequantized if the term table is quantized
+     */
+    void getWordEmbeddings(const std::string& word, float_vt& out) const;
+
+    /**
+     * @brief Keep only the vectors of the terms in aDict in a table indexed by termID, and unmap the store unless it
+     *        is kept as the fallback for other (query) terms. A term gets the vector of its most frequent surface
+     *        form, i.e. of the lowest ranked word which is the term itself or whose stem is the term. The table is
+     *        stored in the embedding precision of the control block
+     *
+     * @param aDict the term dictionary of the collection
      */
-    float_vt& getWordEmbeddings(const std::string& word);
+    void filter(const TermDictionary& aDict);
 
     /**
      * @brief Calculates the wordEmbeddings vector by getting all word2vecs for all words in the doc and averaging them
@@ -98,9 +107,24 @@ class WordEmbeddings {
      */
     void init(const control_block_t& aControlBlock);
 
+  private:
+    /**
+     * @brief Add the vector of a word to out, from the term table if the embeddings are filtered
+     *
+     * @param word the word
+     * @param out the getDimensions() components to add to
+     * @return true if the word has a vector, false otherwise
+     */
+    bool addTo(const std::string& word, float* out) const;
+
   private:
     const control_block_t* _cb;
 
     std::string _modelFile;
-    std::shared_ptr<str_float_vt_mt> _wordEmbeddings;
+    EmbeddingStore _store;
+    size_t _dimensions;
+
+    bool _filtered;
+    QuantizedVectors _termVectors;    // one row per termID, @see filter
+    std::vector<bool> _hasTermVector; // whether the term with the id has a vector
 };
@@ -0,0 +1,114 @@
+/**
+ *	@file 	simd_benchmark.cpp
+ *	@brief  Microbenchmark of the dense vector kernels of simd_util for every instruction set the CPU supports. The
+ *          vectors have the 300 dimensions of the word embeddings, the speedup is relative to the scalar kernels. The
+ *          Hamming scan runs over packed signatures of the default 1000 random projection dimensions in shuffled
+ *          docID order and is compared to one boost::dynamic_bitset XOR per candidate
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#include "measure.hh"
+#include "packed_signatures.hh"
+#include "simd_util.hh"
+
+#include <algorithm>
+#include <boost/dynamic_bitset.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr size_t kDimensions = 300;
+    constexpr size_t kNoVectors = 4096;  // 4.9 MB, a scan over the collection does not stay in the L1 cache either
+    constexpr size_t kRepetitions = 200;
+    constexpr size_t kSignatureBits = 1000;
+
+    volatile double gSink; // keeps the compiler from dropping the kernel calls
+
+    /**
+     * @brief Run aKernel against all vectors kRepetitions times
+     *
+     * @return double the nanoseconds per call
+     */
+    template <typename F>
+    double nanosecondsPerCall(F aKernel) {
+        Measure lMeasure;
+        double lSum = 0;
+        lMeasure.start();
+        for (size_t r = 0; r < kRepetitions; ++r) {
+            for (size_t v = 0; v < kNoVectors; ++v) {
+                lSum += aKernel(v);
+            }
+        }
+        lMeasure.stop();
+        gSink = lSum;
+        return lMeasure.mTotalTime() * 1e9 / (kRepetitions * kNoVectors);
+    }
+} // namespace
+
+int main() {
+    std::mt19937 lRng(42);
+    std::normal_distribution<float> lNormal(0, 1);
+    std::vector<float> lQuery(kDimensions), lVectors(kNoVectors * kDimensions);
+    for (float& x : lQuery) { x = lNormal(lRng); }
+    for (float& x : lVectors) { x = lNormal(lRng); }
+
+    std::cout << "Dispatched instruction set: " << Util::isaToString(Util::simdIsa()) << "\n\n";
+    std::cout << std::left << std::setw(10) << "ISA" << std::right << std::setw(14) << "kernel" << std::setw(12) << "ns/call" << std::setw(10) << "speedup" << "\n";
+    double lScalar[4] = {0, 0, 0, 0};
+    for (int isa = Util::kSCALAR; isa < Util::kNumberOfISAs; ++isa) {
+        if (!Util::simdSupported(static_cast<Util::SIMD_ISA>(isa))) { continue; }
+        const Util::SimdKernels& k = Util::simdKernels(static_cast<Util::SIMD_ISA>(isa));
+        const float* q = lQuery.data();
+        const auto vec = [&lVectors](size_t v) { return &lVectors[v * kDimensions]; };
+        const double lTimes[4] = {
+            nanosecondsPerCall([&](size_t v) { return k.dot(q, vec(v), kDimensions); }),
+            nanosecondsPerCall([&](size_t v) { return k.squaredNorm(vec(v), kDimensions); }),
+            nanosecondsPerCall([&](size_t v) { return k.squaredL2(q, vec(v), kDimensions); }),
+            nanosecondsPerCall([&](size_t v) {
+                double d, na, nb;
+                k.dotAndSquaredNorms(q, vec(v), kDimensions, d, na, nb);
+                return d + na + nb;
+            })};
+        const char* lNames[4] = {"dot", "squaredNorm", "squaredL2", "cosine"};
+        for (size_t i = 0; i < 4; ++i) {
+            if (isa == Util::kSCALAR) { lScalar[i] = lTimes[i]; }
+            std::cout << std::left << std::setw(10) << Util::isaToString(static_cast<Util::SIMD_ISA>(isa)) << std::right << std::setw(14) << lNames[i]
+                      << std::setw(12) << std::fixed << std::setprecision(1) << lTimes[i] << std::setw(9) << std::setprecision(2) << lScalar[i] / lTimes[i] << "x\n";
+        }
+    }
+
+    std::bernoulli_distribution lCoin(0.5);
+    std::vector<boost::dynamic_bitset<>> lSignatures(kNoVectors, boost::dynamic_bitset<>(kSignatureBits));
+    PackedSignatures lTable;
+    lTable.reset(kSignatureBits);
+    for (size_t v = 0; v < kNoVectors; ++v) {
+        for (size_t b = 0; b < kSignatureBits; ++b) { lSignatures[v][b] = lCoin(lRng); }
+        lTable.set(v, lSignatures[v]);
+    }
+    sizet_vt lIds(kNoVectors);
+    for (size_t v = 0; v < kNoVectors; ++v) { lIds[v] = v; }
+    std::shuffle(lIds.begin(), lIds.end(), lRng);
+    std::vector<uint64_t> lPackedQuery(lTable.words());
+    lTable.pack(lSignatures[0], lPackedQuery.data());
+    std::vector<uint32_t> lDistances(kNoVectors);
+
+    std::cout << "\n" << std::left << std::setw(10) << "ISA" << std::right << std::setw(14) << "kernel" << std::setw(12) << "ns/row" << std::setw(10) << "speedup" << "\n";
+    const double lBitset = nanosecondsPerCall([&](size_t v) { return static_cast<double>((lSignatures[0] ^ lSignatures[lIds[v]]).count()); });
+    std::cout << std::left << std::setw(10) << "bitset" << std::right << std::setw(14) << "hamming" << std::setw(12) << std::fixed << std::setprecision(1) << lBitset << std::setw(9)
+              << std::setprecision(2) << 1.0 << "x\n";
+    for (int isa = Util::kSCALAR; isa < Util::kNumberOfISAs; ++isa) {
+        if (!Util::simdSupported(static_cast<Util::SIMD_ISA>(isa))) { continue; }
+        const Util::SimdKernels& k = Util::simdKernels(static_cast<Util::SIMD_ISA>(isa));
+        const double lTime = nanosecondsPerCall([&](size_t v) { // one scan over all rows per repetition
+            if (v != 0) { return 0.0; }
+            k.hammingDistances(lPackedQuery.data(), lTable.row(0), lTable.row(1) - lTable.row(0), lTable.words(), lIds.data(), lIds.size(), lDistances.data());
+            return static_cast<double>(lDistances.back());
+        });
+        std::cout << std::left << std::setw(10) << Util::isaToString(static_cast<Util::SIMD_ISA>(isa)) << std::right << std::setw(14) << "hamming" << std::setw(12) << std::fixed
+                  << std::setprecision(1) << lTime << std::setw(9) << std::setprecision(2) << lBitset / lTime << "x\n";
+    }
+    return 0;
+}
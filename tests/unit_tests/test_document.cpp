@@ -1,6 +1,7 @@
 #include "document.hh"
 #include "document_manager.hh"
 #include "index_manager.hh"
+#include "term_dictionary.hh"
 #include "types.hh"
 #include "string_util.hh"
 #include "ir_util.hh"
@@ -58,3 +59,14 @@ TEST_F(DocumentTest, Idf_Equals_Test) {
     EXPECT_EQ(idf_today, 0);
     EXPECT_EQ(idf_food, Util::calcIdf(docMap->size(), 2));
 }
+
+TEST_F(DocumentTest, Term_ID_Equals_Test) {
+
+    const TermDictionary& dict = TermDictionary::getInstance();
+    const term_id_t id_lemon = dict.getID("lemon");
+    EXPECT_NE(id_lemon, TermDictionary::kNoTerm);
+    EXPECT_EQ(dict.getTerm(id_lemon), "lemon");
+    EXPECT_EQ(dict.getID("notinthecollection"), TermDictionary::kNoTerm);
+    EXPECT_EQ(docMan->getDocument(2).getTf(id_lemon), docMan->getDocument(2).getTf("lemon"));
+    EXPECT_EQ(indexManager->getIdf(id_lemon), indexManager->getIdf("lemon"));
+}
@@ -0,0 +1,103 @@
+#include "test_index_util.hh"
+
+namespace {
+
+    TestUtil::IndexOptions hnswOptions(const std::string& aIndexPath = "") {
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("hnsw.docs", TestUtil::generateCollection(400, 17));
+        lOptions._wordEmbeddingsPath = TestUtil::writeFile("hnsw.glove", TestUtil::generateWordEmbeddings(TestUtil::vocabulary(), 19));
+        lOptions._indexPath = aIndexPath;
+        lOptions._hnswM = 8;
+        return lOptions;
+    }
+
+} // namespace
+
+TEST(HnswIndex, Recall_Against_Exact_Scan_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(hnswOptions());
+        double lRecall = 0;
+        const string_vt lQueries = TestUtil::generateQueries(50, 23);
+        for (std::string lQuery : lQueries) {
+            const pair_sizet_float_vt lFound = QueryExecutionEngine::getInstance().search(lQuery, 10, kHNSW_W2V);
+            EXPECT_EQ(10u, lFound.size()) << lQuery;
+            lRecall += TestUtil::recallAtK(TestUtil::queryWordEmbeddings(lQuery), lFound, 10);
+        }
+        EXPECT_GE(lRecall / lQueries.size(), 0.95);
+    });
+}
+
+TEST(HnswIndex, Save_Load_Round_Trip_Test) {
+
+    const std::string lIndexPath = TestUtil::tempPath("hnsw.index");
+    const std::string lRankingsPath = TestUtil::tempPath("hnsw.rankings");
+    const string_vt lQueries = TestUtil::generateQueries(30, 29);
+
+    EXPECT_IN_FRESH_PROCESS({ // builds and writes the graph
+        TestUtil::initIndex(hnswOptions(lIndexPath));
+        TestUtil::writeLines(lRankingsPath, TestUtil::rankingLines(lQueries, 10, kHNSW_W2V));
+    });
+    ASSERT_TRUE(TestUtil::fs::exists(lIndexPath + ".hnsw"));
+    const auto lWritten = TestUtil::fs::last_write_time(lIndexPath + ".hnsw");
+
+    EXPECT_IN_FRESH_PROCESS({ // loads the graph
+        TestUtil::initIndex(hnswOptions(lIndexPath));
+        EXPECT_TRUE(lWritten == TestUtil::fs::last_write_time(lIndexPath + ".hnsw")); // it was not rebuilt
+        EXPECT_EQ(TestUtil::readLines(lRankingsPath), TestUtil::rankingLines(lQueries, 10, kHNSW_W2V));
+    });
+}
+
+TEST(HnswIndex, Added_And_Deleted_Documents_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(hnswOptions());
+        IndexManager& lIndexManager = IndexManager::getInstance();
+
+        lIndexManager.addDocument("N-0", { "owl", "yak", "owl", "mink" });
+        const string_vt lAdded = TestUtil::searchIDs("owl yak owl mink", 3, kHNSW_W2V);
+        EXPECT_NE(lAdded.end(), std::find(lAdded.begin(), lAdded.end(), "N-0")); // the same vector as the query
+
+        for (std::string lQuery : TestUtil::generateQueries(20, 31)) {
+            const string_vt lBefore = TestUtil::searchIDs(lQuery, 5, kHNSW_W2V);
+            ASSERT_FALSE(lBefore.empty()) << lQuery;
+            if (lIndexManager.isDeleted(DocumentManager::getInstance().getDocument(lBefore[0]).getID())) { continue; }
+            lIndexManager.deleteDocument(lBefore[0]);
+            const string_vt lAfter = TestUtil::searchIDs(lQuery, 5, kHNSW_W2V);
+            EXPECT_EQ(lAfter.end(), std::find(lAfter.begin(), lAfter.end(), lBefore[0])) << lQuery;
+            EXPECT_EQ(5u, lAfter.size()) << lQuery; // the graph still routes through the deleted node
+        }
+    });
+}
+
+TEST(HnswIndex, Top_Zero_Returns_The_Candidate_List_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(hnswOptions());
+        for (std::string lQuery : TestUtil::generateQueries(10, 37)) {
+            const pair_sizet_float_vt lFound = QueryExecutionEngine::getInstance().search(lQuery, 0, kHNSW_W2V, 20);
+            EXPECT_EQ(20u, lFound.size()) << lQuery;
+            EXPECT_TRUE(std::is_sorted(lFound.begin(), lFound.end(), [](const auto& a, const auto& b) { return a.second > b.second; })) << lQuery;
+        }
+    });
+}
+
+TEST(HnswIndex, Deleted_Neighbours_Keep_Top_K_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(hnswOptions());
+        IndexManager& lIndexManager = IndexManager::getInstance();
+
+        for (std::string lQuery : TestUtil::generateQueries(5, 41)) {
+            for (const std::string& lDocID : TestUtil::searchIDs(lQuery, 30, kHNSW_W2V, 30)) { // more than the candidate list below
+                if (!lIndexManager.isDeleted(DocumentManager::getInstance().getDocument(lDocID).getID())) { lIndexManager.deleteDocument(lDocID); }
+            }
+            const pair_sizet_float_vt lFound = QueryExecutionEngine::getInstance().search(lQuery, 10, kHNSW_W2V, 10);
+            EXPECT_EQ(10u, lFound.size()) << lQuery;
+            for (const auto& [id, score] : lFound) {
+                EXPECT_FALSE(lIndexManager.isDeleted(id)) << lQuery;
+            }
+            EXPECT_GE(TestUtil::recallAtK(TestUtil::queryWordEmbeddings(lQuery), lFound, 10), 0.8) << lQuery;
+        }
+    });
+}
@@ -0,0 +1,133 @@
+#include "test_index_util.hh"
+
+namespace {
+
+    TestUtil::IndexOptions snapshotOptions(const std::string& aIndexPath, const std::string& aCollection = "snapshot.docs", const std::string& aModel = "snapshot.glove") {
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::tempPath(aCollection);
+        lOptions._wordEmbeddingsPath = TestUtil::tempPath(aModel);
+        lOptions._indexPath = aIndexPath;
+        lOptions._hnswM = 8;
+        lOptions._ivfLists = 8;
+        lOptions._lshTables = 8;
+        return lOptions;
+    }
+
+    /**
+     * @brief The options of a build with aThreads threads which only writes the snapshot of the exact indices
+     */
+    TestUtil::IndexOptions buildOptions(const std::string& aIndexPath, const uint aThreads) {
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::tempPath("parallel.docs");
+        lOptions._wordEmbeddingsPath = TestUtil::tempPath("snapshot.glove");
+        lOptions._indexPath = aIndexPath;
+        lOptions._threads = aThreads;
+        return lOptions;
+    }
+
+    std::string readBytes(const std::string& aPath) {
+        std::ifstream lIn(aPath, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(lIn)), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * @brief The rankings of every search mode, one line per query and mode
+     */
+    string_vt allRankings(const string_vt& aQueries) {
+        string_vt lLines;
+        for (int m = kVANILLA; m < kNumberOfModes; ++m) {
+            const IR_MODE lMode = static_cast<IR_MODE>(m);
+            for (const std::string& lLine : TestUtil::rankingLines(aQueries, 10, lMode)) {
+                lLines.push_back(modeToString(lMode) + " " + lLine);
+            }
+        }
+        return lLines;
+    }
+
+} // namespace
+
+TEST(IndexSnapshot, Save_Load_Round_Trip_Test) {
+
+    TestUtil::writeFile("snapshot.docs", TestUtil::generateCollection(300, 47));
+    TestUtil::writeFile("snapshot.glove", TestUtil::generateWordEmbeddings(TestUtil::vocabulary(), 53));
+    const std::string lIndexPath = TestUtil::tempPath("round_trip.index");
+    const std::string lRankingsPath = TestUtil::tempPath("round_trip.rankings");
+    const string_vt lQueries = TestUtil::generateQueries(40, 59);
+
+    EXPECT_IN_FRESH_PROCESS({ // builds and writes the snapshot
+        TestUtil::initIndex(snapshotOptions(lIndexPath));
+        TestUtil::writeLines(lRankingsPath, allRankings(lQueries));
+    });
+    ASSERT_TRUE(TestUtil::fs::exists(lIndexPath));
+    const auto lWritten = TestUtil::fs::last_write_time(lIndexPath);
+
+    EXPECT_IN_FRESH_PROCESS({ // loads the snapshot
+        TestUtil::initIndex(snapshotOptions(lIndexPath));
+        EXPECT_TRUE(lWritten == TestUtil::fs::last_write_time(lIndexPath)); // it was not rebuilt
+        EXPECT_EQ(300u, DocumentManager::getInstance().getDocumentMap().size());
+        EXPECT_EQ(TestUtil::readLines(lRankingsPath), allRankings(lQueries));
+    });
+}
+
+TEST(IndexSnapshot, Edited_Collection_Is_Rebuilt_Test) {
+
+    const std::string lIndexPath = TestUtil::tempPath("edited_collection.index");
+    TestUtil::writeFile("snapshot.glove", TestUtil::generateWordEmbeddings(TestUtil::vocabulary(), 53));
+
+    TestUtil::writeFile("edited.docs", TestUtil::generateCollection(300, 47));
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(snapshotOptions(lIndexPath, "edited.docs"));
+    });
+    const auto lWritten = TestUtil::fs::last_write_time(lIndexPath);
+
+    TestUtil::writeFile("edited.docs", TestUtil::generateCollection(300, 47) + "X-0~quokka quokka\n"); // at the same path
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(snapshotOptions(lIndexPath, "edited.docs"));
+        EXPECT_FALSE(lWritten == TestUtil::fs::last_write_time(lIndexPath));
+        EXPECT_EQ(301u, DocumentManager::getInstance().getDocumentMap().size());
+        EXPECT_EQ("X-0", TestUtil::searchIDs("quokka", 1, kVANILLA_TAAT).at(0));
+    });
+}
+
+TEST(IndexSnapshot, Edited_Model_Is_Rebuilt_Test) {
+
+    const std::string lIndexPath = TestUtil::tempPath("edited_model.index");
+    TestUtil::writeFile("snapshot.docs", TestUtil::generateCollection(300, 47));
+
+    TestUtil::writeFile("edited.glove", TestUtil::generateWordEmbeddings(TestUtil::vocabulary(), 53));
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(snapshotOptions(lIndexPath, "snapshot.docs", "edited.glove"));
+    });
+    const auto lWritten = TestUtil::fs::last_write_time(lIndexPath);
+
+    TestUtil::writeFile("edited.glove", TestUtil::generateWordEmbeddings(TestUtil::vocabulary(), 61)); // at the same path
+    const string_vt lQueries = TestUtil::generateQueries(20, 67);
+    const std::string lRankingsPath = TestUtil::tempPath("edited_model.rankings");
+    EXPECT_IN_FRESH_PROCESS({ // the rankings of the new model without a snapshot
+        TestUtil::initIndex(snapshotOptions("", "snapshot.docs", "edited.glove"));
+        TestUtil::writeLines(lRankingsPath, TestUtil::rankingLines(lQueries, 10, kVANILLA_W2V));
+    });
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(snapshotOptions(lIndexPath, "snapshot.docs", "edited.glove"));
+        EXPECT_FALSE(lWritten == TestUtil::fs::last_write_time(lIndexPath));
+        EXPECT_EQ(TestUtil::readLines(lRankingsPath), TestUtil::rankingLines(lQueries, 10, kVANILLA_W2V));
+    });
+}
+
+TEST(IndexSnapshot, Parallel_Build_Equals_Serial_Build_Test) {
+
+    TestUtil::writeFile("parallel.docs", TestUtil::generateCollection(1000, 71));
+    TestUtil::writeFile("snapshot.glove", TestUtil::generateWordEmbeddings(TestUtil::vocabulary(), 53));
+    const std::string lSerialPath = TestUtil::tempPath("serial.index");
+    const std::string lParallelPath = TestUtil::tempPath("parallel.index");
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(buildOptions(lSerialPath, 1));
+    });
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(buildOptions(lParallelPath, 8));
+    });
+    const std::string lSerial = readBytes(lSerialPath);
+    ASSERT_FALSE(lSerial.empty());
+    EXPECT_TRUE(lSerial == readBytes(lParallelPath)); // the postings, tiers, document vectors and clusters
+}
@@ -0,0 +1,330 @@
+/**
+ *	@file 	test_index_util.hh
+ *	@brief  Helpers for the tests which build a whole index. The managers and indices are singletons which are
+ *          initialized once per process, so every such test runs its body in a fresh process of the test binary
+ *          (@see EXPECT_IN_FRESH_PROCESS) on a collection generated into a temporary directory
+ *	@bugs 	Currently no bugs known
+ *
+ *	@section DESCRIPTION docto_
+ */
+#pragma once
+
+#include "document_manager.hh"
+#include "index_manager.hh"
+#include "query_execution_engine.hh"
+#include "query_manager.hh"
+#include "similarity_util.hh"
+#include "trace.hh"
+#include "types.hh"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <experimental/filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <ostream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace TestUtil {
+
+    /**
+     * @brief Accept any output of a child process. The death tests must not match a regular expression on it, the
+     *        boost include directory shadows the <regex.h> which gtest was built with
+     */
+    class AnyOutput : public ::testing::MatcherInterface<const std::string&> {
+      public:
+        bool MatchAndExplain(const std::string&, ::testing::MatchResultListener*) const override { return true; }
+        void DescribeTo(std::ostream* aOut) const override { *aOut << "is any output"; }
+    };
+
+    /**
+     * @brief Run the statements of a fresh process and exit it. The failures of its expectations are printed, since
+     *        gtest only reports the exit code
+     *
+     * @param aStatements the statements
+     */
+    template <typename Statements>
+    [[noreturn]] inline void runAndExit(Statements&& aStatements) {
+        aStatements();
+        const ::testing::TestResult& lResult = *::testing::UnitTest::GetInstance()->current_test_info()->result();
+        for (int i = 0; i < lResult.total_part_count(); ++i) {
+            const ::testing::TestPartResult& lPart = lResult.GetTestPartResult(i);
+            if (lPart.failed()) {
+                std::cerr << lPart.file_name() << ":" << lPart.line_number() << ": " << lPart.summary() << std::endl;
+            }
+        }
+        std::exit(lResult.Failed() ? 1 : 0);
+    }
+
+} // namespace TestUtil
+
+/**
+ * @brief Run the statements in a fresh process of the test binary, the test fails if one of their expectations fails.
+ *        Variadic, so the commas of the statements do not split them
+ */
+#define EXPECT_IN_FRESH_PROCESS(...)                                                                                   \
+    do {                                                                                                               \
+        GTEST_FLAG_SET(death_test_style, "threadsafe"); /* re-executes the binary instead of forking the state */     \
+        EXPECT_EXIT(TestUtil::runAndExit([&]() { __VA_ARGS__; }), ::testing::ExitedWithCode(0),                         \
+                    ::testing::MakeMatcher(new TestUtil::AnyOutput()));                                                \
+    } while (0)
+
+namespace TestUtil {
+
+    namespace fs = std::experimental::filesystem;
+
+    /**
+     * @brief Words which the Porter stemmer leaves as they are, so a query finds them after its preprocessing
+     */
+    inline const string_vt& vocabulary() {
+        static const string_vt lWords = { "cat",  "dog",  "bird", "fish", "lion", "zebra", "tiger", "wolf",
+                                          "bear", "duck", "frog", "crab", "mink", "lamb",  "owl",   "yak" };
+        return lWords;
+    }
+
+    /**
+     * @brief Get the path of a file in the temporary directory of the test binary. The fresh processes inherit the
+     *        directory of their parent through the environment, so they can pass files to each other
+     *
+     * @param aName the file name
+     * @return std::string the path
+     */
+    inline std::string tempPath(const std::string& aName) {
+        static const fs::path lDir = [] {
+            const char* lInherited = std::getenv("EVSR_TEST_DIR");
+            const fs::path lPath = lInherited ? fs::path(lInherited) : fs::temp_directory_path() / ("evsr_test_" + std::to_string(::getpid()));
+            fs::create_directories(lPath);
+            ::setenv("EVSR_TEST_DIR", lPath.c_str(), 0);
+            return lPath;
+        }();
+        return (lDir / aName).string();
+    }
+
+    /**
+     * @brief Write aContent to a file in the temporary directory. A file which already has the content is not
+     *        written again, so its modification time stays the one the snapshots of the previous processes saw
+     *
+     * @return std::string the path of the file
+     */
+    inline std::string writeFile(const std::string& aName, const std::string& aContent) {
+        const std::string lPath = tempPath(aName);
+        std::ifstream lIn(lPath, std::ios::binary);
+        const std::string lOld((std::istreambuf_iterator<char>(lIn)), std::istreambuf_iterator<char>());
+        if (!lIn.is_open() || lOld != aContent) {
+            std::ofstream(lPath) << aContent;
+        }
+        return lPath;
+    }
+
+    /**
+     * @brief Generate a collection of aNoDocs documents 'D-<i>' over the vocabulary. The words are drawn with
+     *        skewed frequencies and the documents have different lengths, so the norms of the documents differ
+     *
+     * @return std::string the lines of the collection file
+     */
+    inline std::string generateCollection(const size_t aNoDocs, const unsigned aSeed) {
+        std::mt19937 lRng(aSeed);
+        std::geometric_distribution<size_t> lWord(0.2);
+        std::uniform_int_distribution<size_t> lLength(2, 30);
+        std::string lLines;
+        for (size_t d = 0; d < aNoDocs; ++d) {
+            lLines += "D-" + std::to_string(d) + "~";
+            const size_t lNoWords = lLength(lRng);
+            for (size_t w = 0; w < lNoWords; ++w) {
+                lLines += ((w == 0) ? "" : " ") + vocabulary()[(lWord(lRng) + d) % vocabulary().size()];
+            }
+            lLines += "\n";
+        }
+        return lLines;
+    }
+
+    /**
+     * @brief Generate a word embeddings model in the GloVe text format, every word of aWords gets a random vector of
+     *        the 300 dimensions
+     *
+     * @return std::string the lines of the model file
+     */
+    inline std::string generateWordEmbeddings(const string_vt& aWords, const unsigned aSeed) {
+        std::mt19937 lRng(aSeed);
+        std::normal_distribution<float> lNormal(0, 1);
+        std::string lLines;
+        for (const std::string& lWord : aWords) {
+            lLines += lWord;
+            for (size_t i = 0; i < IndexManager::kWordEmbeddingsDimensions; ++i) {
+                lLines += " " + std::to_string(lNormal(lRng));
+            }
+            lLines += "\n";
+        }
+        return lLines;
+    }
+
+    /**
+     * @brief The parameters of a test index, the approximate indices are not built by default
+     */
+    struct IndexOptions {
+        std::string _collectionPath;
+        std::string _wordEmbeddingsPath = "";
+        std::string _indexPath = "";
+        uint _dimensions = 64;
+        uint _threads = 2;
+        POSTING_CODEC _postingCodec = kUNCOMPRESSED;
+        bool _filterWordEmbeddings = false;
+        bool _wordEmbeddingsFallback = false;
+        uint _hnswM = 0;
+        uint _hnswEfConstruction = 100;
+        uint _hnswEfSearch = 64;
+        uint _ivfLists = 0;
+        uint _ivfSubspaces = 30;
+        uint _ivfNprobe = 8;
+        uint _lshTables = 0;
+        uint _lshBandBits = 8;
+        uint _lshProbes = 1;
+    };
+
+    /**
+     * @brief Initialize the managers and the query execution engine like the server mode, once per process
+     *
+     * @param aOptions the parameters
+     * @return const CB& the control block, it lives until the process ends
+     */
+    inline const CB& initIndex(const IndexOptions& aOptions) {
+        const CB* lCB = new control_block_t{ false, false, true, aOptions._collectionPath, "", "", "", aOptions._wordEmbeddingsPath, "", "",
+                                             10, 2, aOptions._dimensions, 1, aOptions._threads, aOptions._postingCodec, aOptions._indexPath, 0, "",
+                                             aOptions._filterWordEmbeddings, aOptions._wordEmbeddingsFallback, kFP32,
+                                             aOptions._hnswM, aOptions._hnswEfConstruction, aOptions._hnswEfSearch,
+                                             aOptions._ivfLists, aOptions._ivfSubspaces, aOptions._ivfNprobe,
+                                             aOptions._lshTables, aOptions._lshBandBits, aOptions._lshProbes };
+        Trace::getInstance().init(*lCB);
+        DocumentManager::getInstance().init(*lCB);
+        IndexManager::getInstance().init(*lCB, DocumentManager::getInstance().getDocumentMap());
+        QueryExecutionEngine::getInstance().init(*lCB);
+        return *lCB;
+    }
+
+    /**
+     * @brief Search and map the results to the ids of the documents
+     *
+     * @return std::vector<std::pair<std::string, float>> the (document id, score) pairs in the order of the ranking
+     */
+    inline std::vector<std::pair<std::string, float>> search(std::string aQuery, const size_t aTopK, const IR_MODE aMode, const size_t aSearchWidth = 0) {
+        std::vector<std::pair<std::string, float>> lResults;
+        for (const auto& [id, score] : QueryExecutionEngine::getInstance().search(aQuery, aTopK, aMode, aSearchWidth)) {
+            lResults.emplace_back(DocumentManager::getInstance().getDocument(id).getDocID(), score);
+        }
+        return lResults;
+    }
+
+    /**
+     * @brief Search and map the results to the ids of the documents
+     *
+     * @return string_vt the document ids in the order of the ranking
+     */
+    inline string_vt searchIDs(const std::string& aQuery, const size_t aTopK, const IR_MODE aMode, const size_t aSearchWidth = 0) {
+        string_vt lIDs;
+        for (const auto& [docID, score] : search(aQuery, aTopK, aMode, aSearchWidth)) {
+            lIDs.push_back(docID);
+        }
+        return lIDs;
+    }
+
+    /**
+     * @brief Get the rankings of a search mode as lines of text, one per query, to compare them across processes
+     *
+     * @return string_vt the lines '<query>: <document id>=<score> ...'
+     */
+    inline string_vt rankingLines(const string_vt& aQueries, const size_t aTopK, const IR_MODE aMode) {
+        string_vt lLines;
+        for (const std::string& lQuery : aQueries) {
+            std::string lLine = lQuery + ":";
+            for (const auto& [docID, score] : search(lQuery, aTopK, aMode)) {
+                lLine += " " + docID + "=" + std::to_string(score);
+            }
+            lLines.push_back(lLine);
+        }
+        return lLines;
+    }
+
+    /**
+     * @brief Write lines to a file, e.g. the rankings of a fresh process
+     */
+    inline void writeLines(const std::string& aPath, const string_vt& aLines) {
+        std::ofstream lOut(aPath);
+        for (const std::string& lLine : aLines) {
+            lOut << lLine << "\n";
+        }
+    }
+
+    /**
+     * @brief Read the lines of a file
+     */
+    inline string_vt readLines(const std::string& aPath) {
+        string_vt lLines;
+        std::ifstream lIn(aPath);
+        for (std::string lLine; std::getline(lIn, lLine);) {
+            lLines.push_back(lLine);
+        }
+        return lLines;
+    }
+
+    /**
+     * @brief Get the word embeddings vector of a query, like the one a search builds
+     */
+    inline float_vt queryWordEmbeddings(std::string aQuery) {
+        return QueryManager::getInstance().createQueryDoc(aQuery, "query-0", true).getWordEmbeddingsVector();
+    }
+
+    /**
+     * @brief Get the recall of approximate nearest neighbours of a query against an exact scan of the word embeddings
+     *        vectors of the live documents. A found document is a hit if it is as similar as the k-th document of
+     *        the scan, so the order of documents with equal vectors does not matter
+     *
+     * @param aQuery the word embeddings vector of the query
+     * @param aFound the (docID, similarity) pairs of the approximate search
+     * @param aTopK the k
+     * @return double the fraction of the k documents of the scan which were found
+     */
+    inline double recallAtK(const float_vt& aQuery, const pair_sizet_float_vt& aFound, const size_t aTopK) {
+        std::vector<float> lExact;
+        for (const auto& [id, doc] : DocumentManager::getInstance().getDocumentMap()) {
+            if (!IndexManager::getInstance().isDeleted(id)) { lExact.push_back(Util::calcCosSim(aQuery, doc.getWordEmbeddingsVector())); }
+        }
+        const size_t lK = std::min(aTopK, lExact.size());
+        if (lK == 0) { return 1; }
+        std::nth_element(lExact.begin(), lExact.begin() + (lK - 1), lExact.end(), std::greater<float>());
+        const float lThreshold = lExact[lK - 1] - 1e-5f;
+        size_t lHits = 0;
+        for (size_t i = 0; i < std::min(lK, aFound.size()); ++i) {
+            const Document& lDoc = DocumentManager::getInstance().getDocument(aFound[i].first);
+            lHits += (Util::calcCosSim(aQuery, lDoc.getWordEmbeddingsVector()) >= lThreshold) ? 1 : 0;
+        }
+        return static_cast<double>(lHits) / lK;
+    }
+
+    /**
+     * @brief Queries of one to three words of the vocabulary
+     *
+     * @return string_vt aNoQueries queries
+     */
+    inline string_vt generateQueries(const size_t aNoQueries, const unsigned aSeed) {
+        std::mt19937 lRng(aSeed);
+        std::uniform_int_distribution<size_t> lWord(0, vocabulary().size() - 1), lLength(1, 3);
+        string_vt lQueries;
+        for (size_t q = 0; q < aNoQueries; ++q) {
+            std::string lQuery = vocabulary()[lWord(lRng)];
+            for (size_t w = lLength(lRng); w > 1; --w) {
+                lQuery += " " + vocabulary()[lWord(lRng)];
+            }
+            lQueries.push_back(lQuery);
+        }
+        return lQueries;
+    }
+
+} // namespace TestUtil
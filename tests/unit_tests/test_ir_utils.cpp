@@ -1,6 +1,12 @@
 #include "ir_util.hh"
+#include "posting_list.hh"
+#include "posting_cursor.hh"
+#include "spimi_indexer.hh"
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <fstream>
+
 TEST(IR, OrPostingLists_Equals_Test) {
 
     const sizet_vt& vec_a = {1, 2, 4};
@@ -10,4 +16,122 @@ TEST(IR, OrPostingLists_Equals_Test) {
     sizet_vt out;
     Util::orPostingLists(vecs, out);
     EXPECT_EQ(result, out);
-}
\ No newline at end of file
+}
+
+TEST(IR, OrPostingLists_Streamed_Equals_Test) {
+
+    const sizet_vt vec_a = {1, 2, 4};
+    const sizet_vt vec_b = {4, 5};
+    const sizet_vt vec_c = {};
+    const sizet_vt vec_d = {0, 2, 9};
+    std::vector<const sizet_vt*> lists = {&vec_a, &vec_b, &vec_c, &vec_d};
+    const sizet_vt& result = {0, 1, 2, 4, 5, 9};
+    sizet_vt out;
+    Util::orPostingLists(lists, out);
+    EXPECT_EQ(result, out);
+}
+
+TEST(IR, Compressed_PostingList_Equals_Test) {
+
+    sizet_vt ids;
+    float_vt tfs;
+    for (size_t i = 0; i < 300; ++i) {
+        ids.push_back(i * i + 3);
+        tfs.push_back(0.5f);
+    }
+    for (const POSTING_CODEC codec : {kVARBYTE, kBITPACK}) {
+        PostingList pl(1.0f, ids, tfs);
+        pl.compress(codec);
+        sizet_vt buffer;
+        EXPECT_EQ(3, pl.getNoBlocks());
+        EXPECT_EQ(ids.size(), pl.size());
+        EXPECT_EQ(ids, pl.getIDs(buffer));
+        EXPECT_NEAR(0.5f, pl.getTf(ids[200]), 0.01f);
+        pl.compress(kUNCOMPRESSED);
+        EXPECT_EQ(ids, pl.getIDs());
+    }
+}
+TEST(IR, BitUnpack_Every_Width_Equals_Test) {
+
+    for (uint8_t width = 0; width <= 32; ++width) {
+        for (const size_t n : {Util::kBlockSize, size_t(77)}) {
+            uint32_vt values;
+            for (size_t i = 0; i < n; ++i) {
+                values.push_back(static_cast<uint32_t>((i * 2654435761ull) & ((width == 32) ? 0xFFFFFFFFull : ((1ull << width) - 1))));
+            }
+            byte_vt packed;
+            Util::bitPack(values.data(), n, width, packed);
+            packed.resize(packed.size() + Util::kBitPackPadding, 0);
+            uint32_vt out(n);
+            Util::bitUnpack(packed.data(), n, width, out.data());
+            EXPECT_EQ(values, out) << "width " << int(width) << " size " << n;
+        }
+    }
+}
+TEST(IR, PostingCursor_NextGEQ_Equals_Test) {
+
+    sizet_vt ids;
+    float_vt tfs;
+    for (size_t i = 0; i < 300; ++i) {
+        ids.push_back(3 * i);
+        tfs.push_back(1.0f);
+    }
+    for (const POSTING_CODEC codec : {kUNCOMPRESSED, kBITPACK}) {
+        PostingList pl(1.0f, ids, tfs);
+        pl.compress(codec);
+        PostingCursor cursor(pl);
+        EXPECT_EQ(0, cursor.doc());
+        cursor.next();
+        EXPECT_EQ(3, cursor.doc());
+        EXPECT_EQ(1, cursor.findBlock(700));
+        cursor.nextGEQ(700);
+        EXPECT_EQ(702, cursor.doc());
+        EXPECT_EQ(1, cursor.block());
+        cursor.nextGEQ(898);
+        EXPECT_EQ(PostingCursor::kEnd, cursor.doc());
+    }
+}
+TEST(IR, PostingList_Snapshot_Equals_Test) {
+
+    sizet_vt ids;
+    float_vt tfs;
+    for (size_t i = 0; i < 200; ++i) {
+        ids.push_back(5 * i + 1);
+        tfs.push_back(0.25f);
+    }
+    PostingList pl(2.0f, ids, tfs);
+    pl.compress(kBITPACK);
+    const std::string path = "/tmp/evsr_posting_list_snapshot.bin";
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        pl.save(out);
+    }
+    for (const bool mmap : {false, true}) {
+        Util::BinaryReader reader(path, mmap);
+        PostingList loaded;
+        loaded.load(reader);
+        sizet_vt buffer;
+        EXPECT_TRUE(reader.atEnd());
+        EXPECT_EQ(kBITPACK, loaded.getCodec());
+        EXPECT_EQ(ids, loaded.getIDs(buffer));
+        EXPECT_EQ(pl.getTf(ids[150]), loaded.getTf(ids[150]));
+    }
+    std::remove(path.c_str());
+}
+TEST(IR, Spimi_Merge_Equals_Test) {
+
+    SpimiIndexer indexer("/tmp", 1); // every document is flushed to its own run
+    indexer.add(0, {{0, 1.0f}, {2, 0.5f}});
+    indexer.add(1, {{2, 0.25f}});
+    indexer.add(4, {{0, 0.75f}});
+    EXPECT_EQ(3, indexer.getNoRuns());
+    std::vector<sizet_vt> ids;
+    std::vector<float_vt> tfs;
+    indexer.merge(4, [&](term_id_t, sizet_vt& termIDs, float_vt& termTfs) {
+        ids.push_back(termIDs);
+        tfs.push_back(termTfs);
+    });
+    EXPECT_EQ(std::vector<sizet_vt>({{0, 4}, {}, {0, 1}, {}}), ids);
+    EXPECT_EQ(std::vector<float_vt>({{1.0f, 0.75f}, {}, {0.5f, 0.25f}, {}}), tfs);
+    EXPECT_EQ(0, indexer.getNoRuns());
+}
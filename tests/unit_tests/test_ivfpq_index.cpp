@@ -0,0 +1,92 @@
+#include "test_index_util.hh"
+
+#include <map>
+
+namespace {
+
+    constexpr uint kNoLists = 16;
+
+    TestUtil::IndexOptions ivfPqOptions(const std::string& aIndexPath = "") {
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("ivfpq.docs", TestUtil::generateCollection(400, 37));
+        lOptions._wordEmbeddingsPath = TestUtil::writeFile("ivfpq.glove", TestUtil::generateWordEmbeddings(TestUtil::vocabulary(), 41));
+        lOptions._indexPath = aIndexPath;
+        lOptions._ivfLists = kNoLists;
+        return lOptions;
+    }
+
+    /**
+     * @brief The mean recall at 10 of the index with aNoProbes lists against an exact scan
+     */
+    double meanRecall(const string_vt& aQueries, const size_t aNoProbes) {
+        double lRecall = 0;
+        for (const std::string& lQuery : aQueries) {
+            const float_vt lVector = TestUtil::queryWordEmbeddings(lQuery);
+            lRecall += TestUtil::recallAtK(lVector, IndexManager::getInstance().getIvfPqIndex().search(lVector, 10, aNoProbes), 10);
+        }
+        return lRecall / aQueries.size();
+    }
+
+} // namespace
+
+TEST(IvfPqIndex, Recall_Against_Exact_Scan_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(ivfPqOptions());
+        EXPECT_EQ(DocumentManager::getInstance().getDocumentMap().size(), IndexManager::getInstance().getIvfPqIndex().size());
+        const string_vt lQueries = TestUtil::generateQueries(50, 43);
+        const double lAllLists = meanRecall(lQueries, kNoLists);
+        EXPECT_GE(lAllLists, 0.9); // only the codes approximate the vectors
+        for (const size_t lNoProbes : { 1, 2, 4, 8 }) { // probing all lists gives the best recall
+            EXPECT_LE(meanRecall(lQueries, lNoProbes), lAllLists) << lNoProbes << " probes";
+        }
+        EXPECT_LT(meanRecall(lQueries, 1), lAllLists);
+    });
+}
+
+TEST(IvfPqIndex, Remove_Keeps_The_Codes_Of_The_Others_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(ivfPqOptions());
+        IndexManager& lIndexManager = IndexManager::getInstance();
+        const size_t lNoDocs = DocumentManager::getInstance().getDocumentMap().size();
+        const float_vt lQuery = TestUtil::queryWordEmbeddings("zebra lion");
+
+        std::map<size_t, float> lBefore; // every document scored with its code
+        for (const auto& [id, score] : lIndexManager.getIvfPqIndex().search(lQuery, lNoDocs, kNoLists)) {
+            lBefore[id] = score;
+        }
+        ASSERT_EQ(lNoDocs, lBefore.size());
+
+        for (size_t d = 0; d < lNoDocs; d += 7) { // from the front, the middle and the end of the lists
+            lIndexManager.deleteDocument("D-" + std::to_string(d));
+        }
+        const pair_sizet_float_vt lAfter = lIndexManager.getIvfPqIndex().search(lQuery, lNoDocs, kNoLists);
+        EXPECT_EQ(lNoDocs - (lNoDocs + 6) / 7, lAfter.size());
+        EXPECT_EQ(lAfter.size(), lIndexManager.getIvfPqIndex().size());
+        for (const auto& [id, score] : lAfter) { // the moved last entries kept their codes
+            EXPECT_FALSE(lIndexManager.isDeleted(id)) << id;
+            EXPECT_FLOAT_EQ(lBefore[id], score) << id;
+        }
+    });
+}
+
+TEST(IvfPqIndex, Save_Load_Round_Trip_Test) {
+
+    const std::string lIndexPath = TestUtil::tempPath("ivfpq.index");
+    const std::string lRankingsPath = TestUtil::tempPath("ivfpq.rankings");
+    const string_vt lQueries = TestUtil::generateQueries(30, 47);
+
+    EXPECT_IN_FRESH_PROCESS({ // trains and writes the index
+        TestUtil::initIndex(ivfPqOptions(lIndexPath));
+        TestUtil::writeLines(lRankingsPath, TestUtil::rankingLines(lQueries, 10, kIVFPQ_W2V));
+    });
+    ASSERT_TRUE(TestUtil::fs::exists(lIndexPath + ".ivfpq"));
+    const auto lWritten = TestUtil::fs::last_write_time(lIndexPath + ".ivfpq");
+
+    EXPECT_IN_FRESH_PROCESS({ // loads the index
+        TestUtil::initIndex(ivfPqOptions(lIndexPath));
+        EXPECT_TRUE(lWritten == TestUtil::fs::last_write_time(lIndexPath + ".ivfpq")); // it was not trained again
+        EXPECT_EQ(TestUtil::readLines(lRankingsPath), TestUtil::rankingLines(lQueries, 10, kIVFPQ_W2V));
+    });
+}
@@ -0,0 +1,137 @@
+#include "test_index_util.hh"
+
+namespace {
+
+    TestUtil::IndexOptions lshOptions(const uint aTables, const uint aBandBits, const uint aDimensions) {
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("lsh.docs", TestUtil::generateCollection(400, 31));
+        lOptions._dimensions = aDimensions;
+        lOptions._lshTables = aTables;
+        lOptions._lshBandBits = aBandBits;
+        return lOptions;
+    }
+
+    bool bit(const std::vector<uint64_t>& aSignature, const size_t aBit) { return (aSignature[aBit / 64] >> (aBit % 64)) & 1; }
+
+    void flip(std::vector<uint64_t>& aSignature, const size_t aBit) { aSignature[aBit / 64] ^= uint64_t(1) << (aBit % 64); }
+
+    std::vector<uint64_t> signature(const size_t aDocID) {
+        const PackedSignatures& lSignatures = IndexManager::getInstance().getSignatures();
+        return std::vector<uint64_t>(lSignatures.row(aDocID), lSignatures.row(aDocID) + lSignatures.words());
+    }
+
+    bool contains(const sizet_vt& aIDs, const size_t aDocID) { return std::binary_search(aIDs.begin(), aIDs.end(), aDocID); }
+
+    /**
+     * @brief The documents whose signature equals the query bit by bit in at least one band, i.e. the result of a
+     *        search which only probes the bucket of the query
+     */
+    sizet_vt sameBand(const std::vector<uint64_t>& aQuery) {
+        const LshIndex& lLsh = IndexManager::getInstance().getLshIndex();
+        sizet_vt lIDs;
+        for (const auto& [id, doc] : DocumentManager::getInstance().getDocumentMap()) {
+            const std::vector<uint64_t> lSignature = signature(id);
+            for (size_t t = 0; t < lLsh.tables(); ++t) {
+                bool lEqual = true;
+                for (size_t b = t * lLsh.bandBits(); lEqual && b < (t + 1) * lLsh.bandBits(); ++b) {
+                    lEqual = (bit(aQuery, b) == bit(lSignature, b));
+                }
+                if (lEqual) {
+                    lIDs.push_back(id);
+                    break;
+                }
+            }
+        }
+        std::sort(lIDs.begin(), lIDs.end());
+        return lIDs;
+    }
+
+    /**
+     * @brief Expect that probing the bucket of a query finds the documents which share a band with it, for the
+     *        signatures of the documents and for copies of them with a few random bits flipped
+     */
+    void expectBandsMatchBits() {
+        const LshIndex& lLsh = IndexManager::getInstance().getLshIndex();
+        const size_t lBits = lLsh.tables() * lLsh.bandBits();
+        std::mt19937 lRng(37);
+        std::uniform_int_distribution<size_t> lBit(0, lBits - 1);
+        size_t lCollisions = 0;
+        for (const auto& [id, doc] : DocumentManager::getInstance().getDocumentMap()) {
+            std::vector<uint64_t> lQuery = signature(id);
+            const sizet_vt lOwn = lLsh.search(lQuery.data(), 1);
+            EXPECT_TRUE(contains(lOwn, id)) << doc.getDocID();
+            EXPECT_EQ(sameBand(lQuery), lOwn) << doc.getDocID();
+            lCollisions += lOwn.size() - 1;
+            flip(lQuery, lBit(lRng));
+            flip(lQuery, lBit(lRng));
+            EXPECT_EQ(sameBand(lQuery), lLsh.search(lQuery.data(), 1)) << doc.getDocID() << " with flipped bits";
+        }
+        EXPECT_GT(lCollisions, 0u); // the buckets are not all singletons
+    }
+
+} // namespace
+
+TEST(LshIndex, Bands_Crossing_A_Word_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(lshOptions(2, 48, 128)); // the second band holds the bits 48 .. 95 of two words
+        EXPECT_EQ(2u, IndexManager::getInstance().getLshIndex().tables());
+        expectBandsMatchBits();
+    });
+}
+
+TEST(LshIndex, Full_Word_Bands_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(lshOptions(2, 64, 128));
+        EXPECT_EQ(64u, IndexManager::getInstance().getLshIndex().bandBits());
+        expectBandsMatchBits();
+    });
+}
+
+/**
+ * With one table of 8 bit keys, a query which differs from a document in bit i of its key reaches the bucket of the
+ * document with the probe 2 + i. The query which differs in the bits 0 and 1 needs all 8 one bit probes before
+ */
+TEST(LshIndex, Multi_Probe_Order_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(lshOptions(1, 8, 64));
+        const LshIndex& lLsh = IndexManager::getInstance().getLshIndex();
+        const size_t lID = DocumentManager::getInstance().getDocument("D-0").getID();
+
+        for (size_t i = 0; i < 8; ++i) {
+            std::vector<uint64_t> lQuery = signature(lID);
+            flip(lQuery, i);
+            EXPECT_FALSE(contains(lLsh.search(lQuery.data(), 1 + i), lID)) << "bit " << i;
+            EXPECT_TRUE(contains(lLsh.search(lQuery.data(), 2 + i), lID)) << "bit " << i;
+        }
+        std::vector<uint64_t> lQuery = signature(lID);
+        flip(lQuery, 0);
+        flip(lQuery, 1);
+        EXPECT_FALSE(contains(lLsh.search(lQuery.data(), 1 + 8), lID));
+        EXPECT_TRUE(contains(lLsh.search(lQuery.data(), 1 + 8 + 1), lID));
+        flip(lQuery, 1);
+        flip(lQuery, 2); // the bits 0 and 2, the second pair
+        EXPECT_FALSE(contains(lLsh.search(lQuery.data(), 1 + 8 + 1), lID));
+        EXPECT_TRUE(contains(lLsh.search(lQuery.data(), 1 + 8 + 2), lID));
+    });
+}
+
+TEST(LshIndex, Remove_Clears_The_Buckets_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(lshOptions(4, 8, 64));
+        IndexManager& lIndexManager = IndexManager::getInstance();
+        const LshIndex& lLsh = lIndexManager.getLshIndex();
+        EXPECT_GT(lLsh.memoryBytes(), 0u);
+
+        for (const auto& [id, doc] : DocumentManager::getInstance().getDocumentMap()) {
+            const std::vector<uint64_t> lQuery = signature(id);
+            EXPECT_TRUE(contains(lLsh.search(lQuery.data(), 1), id)) << doc.getDocID();
+            lIndexManager.deleteDocument(doc.getDocID());
+            EXPECT_FALSE(contains(lLsh.search(lQuery.data(), 1 + 8), id)) << doc.getDocID();
+        }
+        EXPECT_EQ(0u, lLsh.memoryBytes()); // no empty bucket is left
+    });
+}
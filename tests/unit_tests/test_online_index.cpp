@@ -0,0 +1,240 @@
+#include "exception.hh"
+#include "query_manager.hh"
+#include "similarity_util.hh"
+#include "test_index_util.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+    /**
+     * @brief The options of an index with all approximate indices, so a test covers every search mode
+     */
+    TestUtil::IndexOptions allIndicesOptions(const std::string& aCollection) {
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("online.docs", aCollection);
+        lOptions._wordEmbeddingsPath = TestUtil::writeFile("online.glove", TestUtil::generateWordEmbeddings(TestUtil::vocabulary(), 5));
+        lOptions._hnswM = 8;
+        lOptions._ivfLists = 8;
+        lOptions._ivfNprobe = 8;
+        lOptions._lshTables = 8;
+        return lOptions;
+    }
+
+    string_vt split(const std::string& aContent) {
+        std::istringstream lStream(aContent);
+        string_vt lTerms;
+        for (std::string lTerm; lStream >> lTerm;) {
+            lTerms.push_back(lTerm);
+        }
+        return lTerms;
+    }
+
+    std::string join(const string_vt& aTerms) {
+        std::string lContent;
+        for (const std::string& lTerm : aTerms) {
+            lContent += (lContent.empty() ? "" : " ") + lTerm;
+        }
+        return lContent;
+    }
+
+    bool contains(const string_vt& aIDs, const std::string& aDocID) { return std::find(aIDs.begin(), aIDs.end(), aDocID) != aIDs.end(); }
+
+    /**
+     * @brief The top-k which makes a search mode consider every document. The cluster modes only search the clusters
+     *        of the best leaders until they hold top-k documents, the other modes are asked for the top 10
+     */
+    size_t allDocsTopK(const IR_MODE aMode) {
+        const bool lCluster = (aMode == kCLUSTER || aMode == kCLUSTER_RAND || aMode == kCLUSTER_W2V);
+        return lCluster ? DocumentManager::getInstance().getDocumentMap().size() : 10;
+    }
+
+    /**
+     * @brief Expect that a query for the content of a document finds it in every search mode
+     */
+    void expectFoundEverywhere(const std::string& aDocID, const std::string& aContent) {
+        for (int m = kVANILLA; m < kNumberOfModes; ++m) {
+            const IR_MODE lMode = static_cast<IR_MODE>(m);
+            EXPECT_TRUE(contains(TestUtil::searchIDs(aContent, allDocsTopK(lMode), lMode), aDocID)) << modeToString(lMode) << " '" << aContent << "'";
+        }
+    }
+
+    /**
+     * @brief Expect that no search mode returns a document, even for a query with its content
+     */
+    void expectGoneEverywhere(const std::string& aDocID, const std::string& aContent) {
+        const size_t lNoDocs = DocumentManager::getInstance().getDocumentMap().size();
+        for (int m = kVANILLA; m < kNumberOfModes; ++m) {
+            const IR_MODE lMode = static_cast<IR_MODE>(m);
+            EXPECT_FALSE(contains(TestUtil::searchIDs(aContent, lNoDocs, lMode), aDocID)) << modeToString(lMode) << " '" << aContent << "'";
+        }
+    }
+
+    /**
+     * @brief The rankings of the exact modes, one line per query and mode
+     */
+    string_vt exactRankings(const string_vt& aQueries) {
+        string_vt lLines;
+        for (const IR_MODE lMode : { kVANILLA, kVANILLA_TAAT, kVANILLA_WAND, kVANILLA_BMW, kVANILLA_MAXSCORE }) {
+            for (const std::string& lQuery : aQueries) {
+                std::ostringstream lLine;
+                lLine << modeToString(lMode) << " '" << lQuery << "':";
+                for (const auto& [docID, score] : TestUtil::search(lQuery, 10, lMode)) {
+                    lLine << " " << docID << "=" << std::round(score * 1e5);
+                }
+                lLines.push_back(lLine.str());
+            }
+        }
+        return lLines;
+    }
+
+} // namespace
+
+TEST(OnlineIndex, Added_Document_Is_Found_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(allIndicesOptions(TestUtil::generateCollection(200, 3)));
+        IndexManager& lIndexManager = IndexManager::getInstance();
+
+        const std::string lContent = "owl yak owl yak lamb mink crab";
+        lIndexManager.addDocument("N-0", split(lContent));
+        expectFoundEverywhere("N-0", lContent);
+        lIndexManager.mergeSegment();
+        expectFoundEverywhere("N-0", lContent);
+    });
+}
+
+TEST(OnlineIndex, Added_Document_Norm_Matches_Postings_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("online.docs", TestUtil::generateCollection(200, 3));
+        TestUtil::initIndex(lOptions);
+        IndexManager& lIndexManager = IndexManager::getInstance();
+
+        lIndexManager.addDocument("N-1", { "zebra", "zebra", "lion" }); // the live idfs move away from the frozen ones
+        lIndexManager.addDocument("N-2", { "zebra", "bird" });
+        for (std::string lQuery : { "zebra", "zebra lion", "bird zebra cat" }) {
+            const Document lQueryDoc = QueryManager::getInstance().createQueryDoc(lQuery, "query-0", true);
+            for (const IR_MODE lMode : { kVANILLA_TAAT, kVANILLA_WAND, kVANILLA_BMW, kVANILLA_MAXSCORE }) {
+                for (const auto& [id, score] : QueryExecutionEngine::getInstance().search(lQuery, 10, lMode)) { // the cosine of the stored vectors
+                    const Document& lDoc = DocumentManager::getInstance().getDocument(id);
+                    EXPECT_NEAR(Util::calcCosSim(lQueryDoc.getTfIdfVector(), lDoc.getTfIdfVector()), score, 1e-5) << modeToString(lMode) << " '" << lQuery << "' " << lDoc.getDocID();
+                }
+            }
+        }
+    });
+}
+
+TEST(OnlineIndex, Deleted_Document_Is_Gone_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::initIndex(allIndicesOptions(TestUtil::generateCollection(200, 3)));
+        IndexManager& lIndexManager = IndexManager::getInstance();
+
+        const std::string lIndexed = join(DocumentManager::getInstance().getDocument("D-17").getContent());
+        const std::string lAdded = "owl yak owl yak lamb mink crab";
+        lIndexManager.addDocument("N-0", split(lAdded));
+        expectFoundEverywhere("D-17", lIndexed);
+        expectFoundEverywhere("N-0", lAdded);
+
+        lIndexManager.deleteDocument("D-17"); // in the main lists
+        lIndexManager.deleteDocument("N-0"); // in the segment
+        expectGoneEverywhere("D-17", lIndexed);
+        expectGoneEverywhere("N-0", lAdded);
+        lIndexManager.mergeSegment();
+        expectGoneEverywhere("D-17", lIndexed);
+        expectGoneEverywhere("N-0", lAdded);
+    });
+}
+
+TEST(OnlineIndex, Duplicate_Add_And_Delete_Throw_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("online.docs", TestUtil::generateCollection(50, 3));
+        TestUtil::initIndex(lOptions);
+        IndexManager& lIndexManager = IndexManager::getInstance();
+
+        EXPECT_THROW(lIndexManager.addDocument("D-3", { "cat" }), InvalidArgumentException);
+        lIndexManager.addDocument("N-0", { "cat" });
+        EXPECT_THROW(lIndexManager.addDocument("N-0", { "dog" }), InvalidArgumentException);
+
+        lIndexManager.deleteDocument("D-3");
+        EXPECT_THROW(lIndexManager.deleteDocument("D-3"), InvalidArgumentException);
+        lIndexManager.deleteDocument("N-0");
+        EXPECT_THROW(lIndexManager.deleteDocument("N-0"), InvalidArgumentException);
+        lIndexManager.mergeSegment();
+        EXPECT_THROW(lIndexManager.deleteDocument("N-0"), InvalidArgumentException);
+    });
+}
+
+/**
+ * The first D-0 .. D-49 are deleted and added again as N-0 .. N-49 while merges run. This keeps the number of documents
+ * and every document frequency, so the idfs which were frozen at the build are the ones of a fresh build
+ */
+TEST(OnlineIndex, Racing_Merge_Equals_Fresh_Build_Test) {
+
+    constexpr size_t kNoDocs = 200;
+    constexpr size_t kNoReplaced = 50;
+    const std::string lCollection = TestUtil::generateCollection(kNoDocs, 3);
+    string_vt lLines;
+    std::istringstream lStream(lCollection);
+    for (std::string lLine; std::getline(lStream, lLine);) {
+        lLines.push_back(lLine);
+    }
+    std::string lFinalCollection;
+    for (size_t d = kNoReplaced; d < kNoDocs; ++d) {
+        lFinalCollection += lLines[d] + "\n";
+    }
+    for (size_t d = 0; d < kNoReplaced; ++d) {
+        lFinalCollection += "N-" + lLines[d].substr(2) + "\n";
+    }
+    const string_vt lQueries = TestUtil::generateQueries(60, 13);
+    const std::string lFreshPath = TestUtil::tempPath("fresh.rankings");
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("fresh.docs", lFinalCollection);
+        TestUtil::initIndex(lOptions);
+        std::ofstream lOut(lFreshPath);
+        for (const std::string& lLine : exactRankings(lQueries)) {
+            lOut << lLine << "\n";
+        }
+    });
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("online.docs", lCollection);
+        TestUtil::initIndex(lOptions);
+        IndexManager& lIndexManager = IndexManager::getInstance();
+
+        std::atomic<bool> lDone(false);
+        std::thread lUpdates([&]() {
+            for (size_t d = 0; d < kNoReplaced; ++d) {
+                const std::string lDocID = "D-" + std::to_string(d);
+                const string_vt lContent = DocumentManager::getInstance().getDocument(lDocID).getContent();
+                lIndexManager.deleteDocument(lDocID);
+                lIndexManager.addDocument("N-" + std::to_string(d), lContent);
+                std::this_thread::yield();
+            }
+            lDone = true;
+        });
+        while (!lDone) {
+            lIndexManager.mergeSegment();
+        }
+        lUpdates.join();
+        lIndexManager.mergeSegment();
+
+        string_vt lFresh;
+        std::ifstream lIn(lFreshPath);
+        for (std::string lLine; std::getline(lIn, lLine);) {
+            lFresh.push_back(lLine);
+        }
+        EXPECT_EQ(lFresh, exactRankings(lQueries));
+    });
+}
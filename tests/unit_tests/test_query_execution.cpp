@@ -0,0 +1,39 @@
+#include "test_index_util.hh"
+
+namespace {
+
+    /**
+     * @brief Expect the same ranking and the same scores from a dynamic pruning search as from the exhaustive TAAT search
+     */
+    void expectEqualToTaat(const IR_MODE aMode, const string_vt& aQueries, const size_t aTopK) {
+        for (const std::string& lQuery : aQueries) {
+            const auto lExpected = TestUtil::search(lQuery, aTopK, kVANILLA_TAAT);
+            const auto lActual = TestUtil::search(lQuery, aTopK, aMode);
+            ASSERT_EQ(lExpected.size(), lActual.size()) << modeToString(aMode) << " '" << lQuery << "'";
+            for (size_t i = 0; i < lExpected.size(); ++i) {
+                EXPECT_EQ(lExpected[i].first, lActual[i].first) << modeToString(aMode) << " '" << lQuery << "' rank " << i;
+                EXPECT_FLOAT_EQ(lExpected[i].second, lActual[i].second) << modeToString(aMode) << " '" << lQuery << "' rank " << i;
+            }
+        }
+    }
+
+} // namespace
+
+TEST(QueryExecution, Dynamic_Pruning_Equals_Taat_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("pruning.docs", TestUtil::generateCollection(200, 7));
+        TestUtil::initIndex(lOptions);
+
+        const float_vt& lNorms = IndexManager::getInstance().getNormLengthVector();
+        EXPECT_TRUE(std::any_of(lNorms.begin(), lNorms.end(), [](float aNorm) { return std::abs(aNorm - 1) > 0.1; })); // the bounds are norm divided
+
+        const string_vt lQueries = TestUtil::generateQueries(150, 11);
+        for (const size_t lTopK : { size_t(1), size_t(3), size_t(10) }) {
+            expectEqualToTaat(kVANILLA_WAND, lQueries, lTopK);
+            expectEqualToTaat(kVANILLA_BMW, lQueries, lTopK);
+            expectEqualToTaat(kVANILLA_MAXSCORE, lQueries, lTopK);
+        }
+    });
+}
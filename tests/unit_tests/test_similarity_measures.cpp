@@ -1,4 +1,5 @@
 #include "similarity_util.hh"
+#include "packed_signatures.hh"
 #include "gtest/gtest.h"
 
 TEST(SimilarityMeasures, Euclidean_Distance_Equals_Test) {
@@ -26,4 +27,94 @@ TEST(SimilarityMeasures, Vector_Length_Test) {
 
     std::vector<float> doc = { 1, 3, 5, 8, 0, 4 };
     EXPECT_FLOAT_EQ(10.7238052948, Util::vectorLength(doc));
-}
\ No newline at end of file
+}
+
+TEST(SimilarityMeasures, Sparse_Cosine_Similarity_Equals_Test) {
+
+    std::vector<float> doc_a = { 1, 0, 5, 0, 100, 100 };
+    std::vector<float> doc_b = { 2, 4, 0, 1, 2, 0 };
+    sparse_vt sparse_a = { { 0, 1 }, { 2, 5 }, { 4, 100 }, { 5, 100 } };
+    sparse_vt sparse_b = { { 0, 2 }, { 1, 4 }, { 3, 1 }, { 4, 2 } };
+    EXPECT_FLOAT_EQ(Util::calcCosSim(doc_a, doc_b), Util::calcCosSim(sparse_a, sparse_b));
+    EXPECT_FLOAT_EQ(Util::vectorLength(doc_a), Util::vectorLength(sparse_a));
+}
+
+TEST(SimilarityMeasures, Combined_Cosine_Similarity_Equals_Test) {
+
+    sparse_vt sparse_a = { { 0, 1 }, { 2, 5 }, { 4, 100 } };
+    sparse_vt sparse_b = { { 0, 2 }, { 1, 4 }, { 4, 2 } };
+    std::vector<float> embeddings_a = { 0.5f, -1.25f, 3 };
+    std::vector<float> embeddings_b = { 2, 0.75f, -0.5f };
+    const double length_a = Util::combinedVectorLength(sparse_a, embeddings_a);
+    EXPECT_EQ(Util::vectorLength(Util::combineVectors(sparse_a, embeddings_a, 6)), length_a);
+    EXPECT_EQ(Util::calcCosSim(Util::combineVectors(sparse_a, embeddings_a, 6), Util::combineVectors(sparse_b, embeddings_b, 6)),
+              Util::calcCombinedCosSim(sparse_a, embeddings_a, length_a, sparse_b, embeddings_b));
+}
+
+TEST(SimilarityMeasures, Simd_Kernels_Equal_Scalar_Test) {
+
+    std::vector<float> a(301), b(301); // not a multiple of any vector width
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = std::sin(static_cast<float>(i));
+        b[i] = std::cos(static_cast<float>(3 * i)) * 2;
+    }
+    const Util::SimdKernels& scalar = Util::simdKernels(Util::kSCALAR);
+    for (int isa = Util::kSCALAR; isa < Util::kNumberOfISAs; ++isa) {
+        if (!Util::simdSupported(static_cast<Util::SIMD_ISA>(isa))) { continue; }
+        const Util::SimdKernels& kernels = Util::simdKernels(static_cast<Util::SIMD_ISA>(isa));
+        for (size_t size : { size_t(0), size_t(3), size_t(17), a.size() }) {
+            EXPECT_NEAR(scalar.dot(a.data(), b.data(), size), kernels.dot(a.data(), b.data(), size), 1e-9);
+            EXPECT_NEAR(scalar.squaredNorm(a.data(), size), kernels.squaredNorm(a.data(), size), 1e-9);
+            EXPECT_NEAR(scalar.squaredL2(a.data(), b.data(), size), kernels.squaredL2(a.data(), b.data(), size), 1e-9);
+            double dot, squaredNorm_a, squaredNorm_b;
+            kernels.dotAndSquaredNorms(a.data(), b.data(), size, dot, squaredNorm_a, squaredNorm_b);
+            EXPECT_NEAR(scalar.dot(a.data(), b.data(), size), dot, 1e-9);
+            EXPECT_NEAR(scalar.squaredNorm(a.data(), size), squaredNorm_a, 1e-9);
+            EXPECT_NEAR(scalar.squaredNorm(b.data(), size), squaredNorm_b, 1e-9);
+        }
+    }
+}
+
+TEST(SimilarityMeasures, Packed_Hamming_Distance_Equals_Test) {
+
+    for (size_t bits : { size_t(5), size_t(64), size_t(1000) }) { // a word, a full word and a masked tail
+        std::vector<boost::dynamic_bitset<>> signatures(7, boost::dynamic_bitset<>(bits));
+        for (size_t row = 0; row < signatures.size(); ++row) {
+            for (size_t bit = 0; bit < bits; ++bit) {
+                signatures[row][bit] = ((bit * 7 + row * 13) % 5) < 2;
+            }
+        }
+        PackedSignatures table;
+        table.reset(bits);
+        for (size_t row = 1; row < signatures.size(); ++row) {
+            table.set(row, signatures[row]);
+        }
+        std::vector<uint64_t> query(table.words());
+        table.pack(signatures[0], query.data());
+        const sizet_vt ids = { 6, 1, 3, 3, 5 };
+        for (int isa = Util::kSCALAR; isa < Util::kNumberOfISAs; ++isa) {
+            if (!Util::simdSupported(static_cast<Util::SIMD_ISA>(isa))) { continue; }
+            std::vector<uint32_t> distances(ids.size());
+            Util::simdKernels(static_cast<Util::SIMD_ISA>(isa)).hammingDistances(query.data(), table.row(0), table.row(1) - table.row(0), table.words(), ids.data(), ids.size(), distances.data());
+            for (size_t i = 0; i < ids.size(); ++i) {
+                EXPECT_EQ(Util::calcHammingDist(signatures[0], signatures[ids[i]]), distances[i]);
+            }
+        }
+    }
+    PackedSignatures table;
+    table.reset(8);
+    EXPECT_THROW(table.set(0, boost::dynamic_bitset<>(9)), InvalidArgumentException);
+}
+
+TEST(SimilarityMeasures, Cosine_Similarity_Known_Lengths_Equals_Test) {
+
+    sparse_vt sparse_a = { { 0, 1 }, { 2, 5 }, { 4, 100 }, { 5, 100 } };
+    sparse_vt sparse_b = { { 0, 2 }, { 1, 4 }, { 3, 1 }, { 4, 2 } };
+    std::vector<float> embeddings_a = { 0.5f, -1.25f, 3 };
+    std::vector<float> embeddings_b = { 2, 0.75f, -0.5f };
+    EXPECT_FLOAT_EQ(Util::calcCosSim(sparse_a, sparse_b), Util::calcCosSim(sparse_a, Util::vectorLength(sparse_a), sparse_b, Util::vectorLength(sparse_b)));
+    EXPECT_FLOAT_EQ(Util::calcCombinedCosSim(sparse_a, embeddings_a, Util::combinedVectorLength(sparse_a, embeddings_a), sparse_b, embeddings_b),
+                    Util::calcCombinedCosSim(sparse_a, embeddings_a, Util::combinedVectorLength(sparse_a, embeddings_a), sparse_b, embeddings_b,
+                                             Util::combinedVectorLength(sparse_b, embeddings_b)));
+    EXPECT_EQ(0, Util::calcCosSim(sparse_a, 0, sparse_b, Util::vectorLength(sparse_b)));
+}
@@ -75,4 +75,17 @@ TEST(StringOp, Max_Word_String_Equals_Test_VT) {
 
     sentence = {""};
     EXPECT_EQ(0, Util::getMaxWordFrequency(sentence));
-}
\ No newline at end of file
+}
+
+TEST(StringOp, Split_String_View_Equals_Test) {
+
+    for (const std::string line : {"MED-1~studi run fish", "a  b ", "", "~~x"}) {
+        for (const char delimiter : {'~', ' '}) {
+            string_vt expected;
+            Util::splitStringBoost(line, delimiter, expected);
+            strview_vt views;
+            Util::splitStringView(line, delimiter, views);
+            EXPECT_EQ(expected, string_vt(views.begin(), views.end()));
+        }
+    }
+}
@@ -1,5 +1,11 @@
 #include "ir_util.hh"
 #include "vec_util.hh"
+#include "top_k_collector.hh"
+#include "score_accumulator.hh"
+#include "thread_util.hh"
+#include "file_util.hh"
+#include "embedding_store.hh"
+#include "quantized_vectors.hh"
 #include "gtest/gtest.h"
 
 TEST(Utils, Random_Vector_Size_Equals_Test) {
@@ -29,4 +35,107 @@ TEST(Utils, Pop_Front_Equals_Test) {
     const std::string& str_elem = Util::pop_front(vec_b);
     EXPECT_EQ(vec_b_first_popped, vec_b);
     EXPECT_EQ(str_elem, "Hi");
-}
\ No newline at end of file
+}
+
+TEST(Utils, TopK_Collector_Equals_Test) {
+
+    TopKCollector topKCollector(3);
+    const std::vector<std::pair<size_t, float>> scores = { {7, 0.2f}, {3, 0.9f}, {5, 0.5f}, {1, 0.5f}, {9, 0.1f}, {4, 0.5f} };
+    for (const auto& [id, score] : scores) {
+        topKCollector.push(id, score);
+    }
+    const std::vector<std::pair<size_t, float>> expected = { {3, 0.9f}, {1, 0.5f}, {4, 0.5f} };
+    EXPECT_EQ(expected, topKCollector.finish());
+}
+
+TEST(Utils, Score_Accumulator_Reset_Equals_Test) {
+
+    ScoreAccumulator& accumulator = ScoreAccumulator::getInstance();
+    accumulator.reset(10);
+    accumulator.add(4, 1.0f);
+    accumulator.add(2, 0.5f);
+    accumulator.add(4, 0.25f);
+    EXPECT_EQ(1.25f, accumulator.get(4));
+    EXPECT_EQ(sizet_vt({4, 2}), accumulator.getTouched());
+    accumulator.reset(10); // a new query does not see the old scores
+    EXPECT_EQ(0.0f, accumulator.get(4));
+    EXPECT_TRUE(accumulator.getTouched().empty());
+}
+TEST(Utils, Parallel_For_Covers_Range_Equals_Test) {
+
+    std::vector<int> visits(1000, 0);
+    Util::parallelFor(visits.size(), 4, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            ++visits[i];
+        }
+    }, 7);
+    EXPECT_EQ(std::vector<int>(1000, 1), visits);
+    EXPECT_EQ(sizet_vt({0, 3, 6, 10}), Util::shardBoundaries(10, 3));
+    EXPECT_THROW(Util::parallelFor(100, 4, [](size_t first, size_t) { if (first >= 50) throw std::runtime_error("fail"); }, 10), std::runtime_error);
+}
+
+TEST(Utils, Read_In_Parallel_Equals_Test) {
+
+    const std::string path = "/tmp/evsr_read_in_parallel.docs";
+    std::ofstream out(path);
+    string_vvt expected;
+    for (size_t i = 0; i < 1000; ++i) {
+        expected.push_back({"MED-" + std::to_string(i), std::string(i % 17, 'a') + " b"});
+        out << expected.back()[0] << "~" << expected.back()[1] << ((i < 999) ? "\n" : ""); // no newline at the end
+    }
+    out.close();
+    for (const size_t noThreads : {1, 3, 8}) {
+        string_vvt lines;
+        Util::readInParallel<string_vvt>(path, '~', noThreads, [](const strview_vt& fields, string_vvt& chunk) {
+            chunk.emplace_back(fields.begin(), fields.end());
+        }, [&lines](string_vvt& chunk) { lines.insert(lines.end(), chunk.begin(), chunk.end()); });
+        EXPECT_EQ(expected, lines);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(Utils, Embedding_Store_Find_Equals_Test) {
+
+    const std::string textPath = "/tmp/evsr_embedding_store.txt";
+    const std::string storePath = "/tmp/evsr_embedding_store.bin";
+    std::ofstream out(textPath);
+    out << "sun 1 2 3\nlemon 4 5 6\nfood 7 8 9\nsun 0 0 0\n"; // the first vector of a word is kept
+    out.close();
+    EmbeddingStore::convert(textPath, storePath, 2);
+    EXPECT_TRUE(EmbeddingStore::isStore(storePath));
+    EXPECT_FALSE(EmbeddingStore::isStore(textPath));
+    EmbeddingStore store;
+    store.open(storePath);
+    EXPECT_EQ(3u, store.size());
+    EXPECT_EQ(3u, store.dimensions());
+    EXPECT_EQ("food", store.getWord(0));
+    EXPECT_EQ(float_vt({1, 2, 3}), float_vt(store.find("sun"), store.find("sun") + 3));
+    EXPECT_EQ(float_vt({4, 5, 6}), float_vt(store.find("lemon"), store.find("lemon") + 3));
+    EXPECT_EQ(nullptr, store.find("moon"));
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(store.getVector(0)) % EmbeddingStore::kVectorAlignment);
+    std::remove(textPath.c_str());
+    std::remove(storePath.c_str());
+}
+
+TEST(Utils, Quantized_Vectors_Dot_Equals_Test) {
+
+    EXPECT_EQ(1.5f, Util::halfToFloat(Util::floatToHalf(1.5f)));
+    EXPECT_EQ(-0.25f, Util::halfToFloat(Util::floatToHalf(-0.25f)));
+    EXPECT_EQ(65504.0f, Util::halfToFloat(Util::floatToHalf(65504.0f))); // the largest half
+    const float_vt row = {0.5f, -1.27f, 0.1f, 2.54f};
+    const float_vt query = {1.0f, 2.0f, -3.0f, 0.5f};
+    const float exact = 0.5f - 2.54f - 0.3f + 1.27f;
+    QuantizedVectors vectors;
+    for (const EMBEDDING_PRECISION precision : {kFP32, kFP16, kINT8}) {
+        vectors.reset(precision, row.size());
+        vectors.set(2, row.data());
+        EXPECT_EQ(3u, vectors.size());
+        EXPECT_EQ(0.0f, vectors.dot(0, query.data())); // a row which was never set
+        EXPECT_NEAR(exact, vectors.dot(2, query.data()), 0.05f);
+        float_vt dequantized(row.size(), 0);
+        vectors.addTo(2, dequantized.data());
+        EXPECT_NEAR(2.54f, dequantized[3], 0.01f);
+        EXPECT_NEAR(Util::scalar_product(dequantized, dequantized), vectors.squaredLength(2), 1e-4);
+    }
+    EXPECT_LT(vectors.memoryBytes(), 3 * row.size() * sizeof(float));
+}
@@ -0,0 +1,89 @@
+#include "exception.hh"
+#include "query_manager.hh"
+#include "test_index_util.hh"
+
+namespace {
+
+    /**
+     * @brief A model in the GloVe text format whose i-th word has the constant vector i + 1, ordered by frequency
+     */
+    std::string constantWordEmbeddings(const string_vt& aWords) {
+        std::string lLines;
+        for (size_t i = 0; i < aWords.size(); ++i) {
+            lLines += aWords[i];
+            for (size_t j = 0; j < IndexManager::kWordEmbeddingsDimensions; ++j) {
+                lLines += " " + std::to_string(i + 1);
+            }
+            lLines += "\n";
+        }
+        return lLines;
+    }
+
+    /**
+     * @brief Index a collection with the terms cat, run and zzz and a filtered model, in which the more frequent
+     *        surface forms cats and runs rank before cat and run, and zzz has no vector
+     */
+    void initFilteredIndex(const bool aFallback) {
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("filter.docs", "D-0~run zzz cat\nD-1~cat run\n");
+        lOptions._wordEmbeddingsPath = TestUtil::writeFile("filter.glove", constantWordEmbeddings({ "cats", "runs", "cat", "run", "owl" }));
+        lOptions._filterWordEmbeddings = true;
+        lOptions._wordEmbeddingsFallback = aFallback;
+        TestUtil::initIndex(lOptions);
+    }
+
+    float firstComponent(const std::string& aWord) {
+        float_vt lVector;
+        IndexManager::getInstance().getWordEmbeddingsIndex().getWordEmbeddings(aWord, lVector);
+        return lVector[0];
+    }
+
+} // namespace
+
+TEST(WordEmbeddings, Unwritable_Store_Falls_Back_To_Temp_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        TestUtil::IndexOptions lOptions;
+        lOptions._collectionPath = TestUtil::writeFile("unwritable.docs", TestUtil::generateCollection(20, 3));
+        lOptions._wordEmbeddingsPath = TestUtil::writeFile("unwritable.glove", TestUtil::generateWordEmbeddings(TestUtil::vocabulary(), 5));
+        TestUtil::fs::create_directories(lOptions._wordEmbeddingsPath + ".bin"); // the store can not replace it
+        TestUtil::initIndex(lOptions);
+
+        WordEmbeddings& lEmbeddings = IndexManager::getInstance().getWordEmbeddingsIndex();
+        EXPECT_EQ(TestUtil::vocabulary().size(), lEmbeddings.getNoWordEmbeddings());
+        EXPECT_EQ(IndexManager::kWordEmbeddingsDimensions, lEmbeddings.getDimensions());
+        float_vt lVector;
+        lEmbeddings.getWordEmbeddings("zebra", lVector);
+        EXPECT_TRUE(std::any_of(lVector.begin(), lVector.end(), [](float aComponent) { return aComponent != 0; }));
+        for (const auto& lEntry : TestUtil::fs::directory_iterator(TestUtil::fs::path(lOptions._wordEmbeddingsPath).parent_path())) {
+            EXPECT_EQ(std::string::npos, lEntry.path().filename().string().find(".tmp")) << lEntry.path(); // no partial store is left
+        }
+        EXPECT_TRUE(TestUtil::fs::is_directory(lOptions._wordEmbeddingsPath + ".bin"));
+    });
+}
+
+TEST(WordEmbeddings, Filter_Keeps_The_Collection_Terms_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        initFilteredIndex(false);
+        EXPECT_FLOAT_EQ(1, firstComponent("cat")); // the vector of cats
+        EXPECT_FLOAT_EQ(2, firstComponent("run")); // the vector of runs
+        EXPECT_THROW(firstComponent("zzz"), InvalidArgumentException);
+        EXPECT_THROW(firstComponent("owl"), InvalidArgumentException); // the store was unmapped
+        float_vt lVector(IndexManager::kWordEmbeddingsDimensions, 0);
+        IndexManager::getInstance().getWordEmbeddingsIndex().calcWordEmbeddingsVector({ "zzz" }, lVector);
+        EXPECT_TRUE(std::all_of(lVector.begin(), lVector.end(), [](float aComponent) { return aComponent == 0; }));
+    });
+}
+
+TEST(WordEmbeddings, Filter_With_Fallback_Resolves_Query_Words_Test) {
+
+    EXPECT_IN_FRESH_PROCESS({
+        initFilteredIndex(true);
+        EXPECT_FLOAT_EQ(2, firstComponent("run"));
+        EXPECT_FLOAT_EQ(5, firstComponent("owl")); // not in the collection, from the store
+        std::string lQuery = "owl";
+        EXPECT_FLOAT_EQ(5, QueryManager::getInstance().createQueryDoc(lQuery, "query-0", true).getWordEmbeddingsVector()[0]);
+        EXPECT_THROW(firstComponent("zzz"), InvalidArgumentException);
+    });
+}